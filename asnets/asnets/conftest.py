@@ -0,0 +1,23 @@
+"""Fixtures shared by the tests that need MDPSim and SSiPP."""
+
+import os
+
+import pytest
+
+TRIANGLE_TIRE = os.path.join(os.path.dirname(__file__), '..', '..', 'mdpsim',
+                             'examples', 'triangle-tire.pddl')
+
+
+@pytest.fixture(scope='session')
+def planner_exts():
+    """PlannerExtensions for triangle-tire-3 (which has more than 32 atoms, so
+    its packed states take several words). MDPSim and SSiPP can only load the
+    problem once per process, so all tests share this object."""
+    pytest.importorskip('mdpsim')
+    pytest.importorskip('ssipp')
+    from asnets.supervised import PlannerExtensions
+    return PlannerExtensions([TRIANGLE_TIRE],
+                             'triangle-tire-3',
+                             dg_heuristic_name='h-add',
+                             dg_use_lm_cuts=True,
+                             dg_n_threads=2)
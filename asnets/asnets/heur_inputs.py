@@ -47,6 +47,24 @@ class ActionDataGenerator(abc.ABC):
                 is_init_cstate=is_init_cstate)
         return self.get_extra_data_no_memory(cstate)
 
+    def get_extra_data_batch(self, cstates: List[CanonicalState]) \
+            -> np.ndarray:
+        """Generate extra data for many states at once. Only valid for
+        generators that do not require memory. Subclasses that can compute
+        their data more efficiently in bulk (e.g. in SSiPP) override this.
+
+        Args:
+            cstates: states to generate extra data for.
+
+        Returns:
+            np.ndarray: extra data with shape (len(cstates), |A|,
+            `.extra_dim`).
+        """
+        assert not self.requires_memory
+        return np.stack([self.get_extra_data_no_memory(cstate)
+                         for cstate in cstates]) \
+            .reshape((len(cstates), -1, self.extra_dim))
+
     def get_extra_data_no_memory(self, cstate):
         """Get extra data from a state (of type `CanonicalState`). Either this
         or `get_extra_data_with_memory()` must be implemented, depending on
@@ -191,12 +209,38 @@ class LMCutDataGenerator(SSiPPDataGenerator):
     # convention in my SSiPP wrapper, of course.
     IN_LAST_CUT = 2
 
-    def __init__(self, *args):
+    def __init__(self, *args, n_threads: int = 1):
         """Constructs a new LMCutDataGenerator. Will pass all arguments to the
         parent constructor, and also construct an SSiPP cutter for the problem.
+
+        Args:
+            n_threads (int): number of threads used by
+            `.get_extra_data_batch()`.
         """
         super().__init__(*args)
         self.cutter = ssipp_interface.Cutter(self.mod_sandbox)
+        self.n_threads = n_threads
+        # created on first use, since it builds one LM-cut per thread
+        self._batch_extractor = None
+
+    def get_extra_data_batch(self, cstates: List[CanonicalState]) \
+            -> np.ndarray:
+        """Same as `.get_extra_data_no_memory()` for many states at once,
+        computed by SSiPP on `.n_threads` threads.
+
+        Args:
+            cstates (List[CanonicalState]): the states to generate extra data
+            for.
+
+        Returns:
+            np.ndarray: the cut vectors, with shape (len(cstates), |A|, 3).
+        """
+        if self._batch_extractor is None:
+            self._batch_extractor = ssipp_interface.BatchFeatureExtractor(
+                self.mod_sandbox, n_threads=self.n_threads)
+        features, _ = self._batch_extractor.extract(
+            cstate.to_ssipp(self.mod_sandbox) for cstate in cstates)
+        return features
 
     def get_extra_data_no_memory(self, cstate: CanonicalState) -> np.ndarray:
         """Returns a vector describing which actions are in cuts. The vector
@@ -267,18 +311,44 @@ class HeuristicDataGenerator(SSiPPDataGenerator):
     SAME = 3
 
     def __init__(self, mod_sandbox: 'PlannerExtensions',
-                 heuristic_name: str):
+                 heuristic_name: str,
+                 n_threads: int = 1):
         """Create a new HeuristicDataGenerator.
 
         Args:
             mod_sandbox (PlannerExtensions): A proxy to a
             planner extensions object.
             heuristic_name (str): name of the heuristic to use.
+            n_threads (int): number of threads used by
+            `.get_extra_data_batch()`.
         """
         super().__init__(mod_sandbox)
         self.heuristic_name = heuristic_name
         self.evaluator = ssipp_interface.Evaluator(self.mod_sandbox,
                                                    heuristic_name)
+        self.n_threads = n_threads
+        # created on first use, since it builds one heuristic per thread
+        self._batch_extractor = None
+
+    def get_extra_data_batch(self, cstates: List[CanonicalState]) \
+            -> np.ndarray:
+        """Same as `.get_extra_data_no_memory()` for many states at once,
+        computed by SSiPP on `.n_threads` threads. Actions are considered
+        disabled if SSiPP says so (which agrees with `cstate.acts_enabled`).
+
+        Args:
+            cstates (List[CanonicalState]): the states to evaluate.
+
+        Returns:
+            np.ndarray: the heuristic change vectors, with shape
+            (len(cstates), |A|, 4).
+        """
+        if self._batch_extractor is None:
+            self._batch_extractor = ssipp_interface.BatchFeatureExtractor(
+                self.mod_sandbox, self.heuristic_name, self.n_threads)
+        features, _ = self._batch_extractor.extract(
+            cstate.to_ssipp(self.mod_sandbox) for cstate in cstates)
+        return features
 
     def get_extra_data_no_memory(self, cstate: CanonicalState) -> np.ndarray:
         """Returns a vector of how heuristic values change for each action.
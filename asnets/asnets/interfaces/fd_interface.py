@@ -10,8 +10,9 @@ import re
 import shutil
 import subprocess
 import time
-from typing import List, Optional, Tuple
+from typing import Dict, Iterable, List, Optional, Tuple
 import uuid
+from warnings import warn
 
 import numpy as np
 
@@ -24,6 +25,9 @@ THIS_DIR = osp.dirname(osp.abspath(__file__))
 ABOVE_DIR = osp.abspath(osp.join(THIS_DIR, '../../..'))
 FD_DIR = osp.join(ABOVE_DIR, 'downward')
 FD_PATH = osp.join(FD_DIR, 'fast-downward.py')
+# search component of FD (the one fast-downward.py uses by default)
+FD_SEARCH_PATH = osp.join(FD_DIR, 'builds', 'release', 'bin', 'downward')
+SAS_BN = 'output.sas'
 PLAN_BN = 'plan.out'
 STDOUT_BN = 'stdout.txt'
 STDERR_BN = 'stderr.txt'
@@ -123,43 +127,9 @@ def _name_from_txt(pddl_txt: str) -> str:
     return name
 
 
-def run_fd_raw(planner,
-               domain_txt,
-               problem_txt,
-               result_dir,
-               *,
-               timeout_s=None,
-               cost_bound=None,
-               mem_limit_mb=None):
-    """Runs FD in a given directory & then returns path to directory."""
-
-    assert has_fd(), \
-        "Couldn't find Fast Downward. Use try_install_fd() before using this."
-
-    # now setup output dir & write problem text
-    os.makedirs(result_dir, exist_ok=True)
-    domain_bn = 'domain.pddl'
-    problem_bn = 'problem.pddl'
-    domain_path = osp.join(result_dir, domain_bn)
-    problem_path = osp.join(result_dir, problem_bn)
-    with open(domain_path, 'w') as dom_fp, open(problem_path, 'w') as prob_fp:
-        dom_fp.write(domain_txt)
-        prob_fp.write(problem_txt)
-
-    cost_bound_s = 'infinity' if cost_bound is None else str(cost_bound)
-    del cost_bound  # so that I don't accidentally use it
-
-    # figure out where FD is and run it
-    cmdline = ["python3", FD_PATH]
-    if timeout_s is not None:
-        assert timeout_s >= 1, "can't have <1s time limit (got %s)" % timeout_s
-        cmdline.extend(["--overall-time-limit", "%ds" % timeout_s])
-    if mem_limit_mb is not None:
-        assert mem_limit_mb >= 1, "can't have <1MB memory limit (got %s)" \
-            % mem_limit_mb
-        cmdline.extend(["--overall-memory-limit", "%dM" % mem_limit_mb])
-    cmdline.extend(['--plan-file', PLAN_BN])
-
+def _planner_search_args(planner: str, cost_bound_s: str) -> List[str]:
+    """Search arguments of the `downward` binary (evaluator predefinitions and
+    --search) for one of the planner names accepted by run_fd_raw."""
     def make_wlama_args(w):
         # flags for LAMA's WA* thing using a specific W (the last ~3 or so
         # stages of LAMA are like this)
@@ -179,8 +149,8 @@ def run_fd_raw(planner,
         # be sufficient for our benchmark problems though.
         cost_prefs_bound = "[hff,hlm],preferred=[hff,hlm],bound={bound}" \
             .format(bound=cost_bound_s)
-        cmdline.extend([
-            domain_bn, problem_bn, "--evaluator",
+        return [
+            "--evaluator",
             "hlm=lmcount(lm_rhw(reasonable_orders=true),pref={pref})".format(
                 pref=True), "--evaluator", "hff=ff()", "--search",
             ("iterated([lazy_greedy({cost_prefs}),"
@@ -188,39 +158,27 @@ def run_fd_raw(planner,
              "lazy_wastar({cost_prefs},w=2),lazy_wastar({cost_prefs},w=1)],"
              "repeat_last=true,continue_on_fail=true,bound={bound})").format(
                  cost_prefs=cost_prefs_bound, bound=cost_bound_s)
-        ])
+        ]
     elif planner == 'lama-first':
         # LAMA-first:
         # fast-downward.py --alias lama-first ${dom} ${prob}
-        cmdline.extend([
-            domain_bn, problem_bn, "--evaluator",
+        return [
+            "--evaluator",
             ("hlm=landmark_sum(lm_factory=lm_reasonable_orders_hps(lm_rhw()),"
              "transform=adapt_costs(one),pref=false)"), "--evaluator",
             "hff=ff(transform=adapt_costs(one))", "--search",
             ("lazy_greedy([hff,hlm],preferred=[hff,hlm],cost_type=one,"
              "reopen_closed=false,bound={bound})").format(bound=cost_bound_s)
-        ])
+        ]
     elif planner == 'lama-w5':
         # the second (i.e fourth-last) stage of LAMA-2011 (lazy WA* with W=5)
-        cmdline.extend([
-            domain_bn,
-            problem_bn,
-            *make_wlama_args(5),
-        ])
+        return make_wlama_args(5)
     elif planner == 'lama-w3':
         # the third (also third-last) stage of LAMA-2011 (lazy WA* with W=3)
-        cmdline.extend([
-            domain_bn,
-            problem_bn,
-            *make_wlama_args(3),
-        ])
+        return make_wlama_args(3)
     elif planner == 'lama-w2':
         # the second-last stage of LAMA-2011 (lazy WA* with W=2)
-        cmdline.extend([
-            domain_bn,
-            problem_bn,
-            *make_wlama_args(2),
-        ])
+        return make_wlama_args(2)
     elif planner == 'lama-w1':
         # One step of the last stage of LAMA-2011 (lazy A*, so W=1). Note that
         # there is no *real* "last stage" of LAMA, since it keeps applying the
@@ -228,46 +186,83 @@ def run_fd_raw(planner,
         # until it runs out of time or something like that (using iterated
         # search). That means that it ends up with much better solutions than
         # you can get in just one application of the planner!
-        cmdline.extend([
-            domain_bn,
-            problem_bn,
-            *make_wlama_args(1),
-        ])
+        return make_wlama_args(1)
     elif planner == 'astar-lmcut':
         # A* with LM-cut:
         # fast-downward.py ${dom} ${prob} --search "astar(lmcut())"
         # (similar template for astar or gbf with other heuristics)
-        cmdline.extend([
-            domain_bn, problem_bn, "--search",
+        return [
+            "--search",
             "astar(lmcut(),bound={bound})".format(bound=cost_bound_s)
-        ])
+        ]
     elif planner == 'astar-lmcount':
         # inadmissible variant of above
-        cmdline.extend([
-            domain_bn, problem_bn, "--search",
+        return [
+            "--search",
             "astar(lmcount(lm_rhw()),bound={bound})".format(bound=cost_bound_s)
-        ])
+        ]
     elif planner == 'astar-hadd':
-        cmdline.extend([
-            domain_bn, problem_bn, "--search",
+        return [
+            "--search",
             "astar(add(),bound={bound})".format(bound=cost_bound_s)
-        ])
+        ]
     elif planner == 'gbf-lmcut':
         # gbf = greedy best first (if this works well then finding a
         # generalised policy may be trivial for ASNets, using only action
         # landmarks!)
-        cmdline.extend([
-            domain_bn, problem_bn, "--search",
+        return [
+            "--search",
             "eager(single(lmcut()),bound={bound})".format(bound=cost_bound_s)
-        ])
+        ]
     elif planner == 'gbf-hadd':
-        cmdline.extend([
-            domain_bn, problem_bn, "--search",
+        return [
+            "--search",
             "eager(single(add()),bound={bound})".format(bound=cost_bound_s)
-        ])
+        ]
     else:
         raise ValueError("Unknown planner '%s'" % planner)
 
+
+def run_fd_raw(planner,
+               domain_txt,
+               problem_txt,
+               result_dir,
+               *,
+               timeout_s=None,
+               cost_bound=None,
+               mem_limit_mb=None):
+    """Runs FD in a given directory & then returns path to directory."""
+
+    assert has_fd(), \
+        "Couldn't find Fast Downward. Use try_install_fd() before using this."
+
+    # now setup output dir & write problem text
+    os.makedirs(result_dir, exist_ok=True)
+    domain_bn = 'domain.pddl'
+    problem_bn = 'problem.pddl'
+    domain_path = osp.join(result_dir, domain_bn)
+    problem_path = osp.join(result_dir, problem_bn)
+    with open(domain_path, 'w') as dom_fp, open(problem_path, 'w') as prob_fp:
+        dom_fp.write(domain_txt)
+        prob_fp.write(problem_txt)
+
+    cost_bound_s = 'infinity' if cost_bound is None else str(cost_bound)
+    del cost_bound  # so that I don't accidentally use it
+
+    # figure out where FD is and run it
+    cmdline = ["python3", FD_PATH]
+    if timeout_s is not None:
+        assert timeout_s >= 1, "can't have <1s time limit (got %s)" % timeout_s
+        cmdline.extend(["--overall-time-limit", "%ds" % timeout_s])
+    if mem_limit_mb is not None:
+        assert mem_limit_mb >= 1, "can't have <1MB memory limit (got %s)" \
+            % mem_limit_mb
+        cmdline.extend(["--overall-memory-limit", "%dM" % mem_limit_mb])
+    cmdline.extend(['--plan-file', PLAN_BN])
+
+    cmdline.extend([domain_bn, problem_bn,
+                    *_planner_search_args(planner, cost_bound_s)])
+
     # write command line to a text file so we can play back later if this fails
     cmdline_path = osp.join(result_dir, CMDLINE_BN)
     with open(cmdline_path, 'w') as cmdline_fp:
@@ -368,6 +363,229 @@ def run_fd_or_timeout(planner: str,
     return rv
 
 
+class FDServerError(Exception):
+    """Exception class for when the FD server cannot be started or dies."""
+    pass
+
+
+class FDInvalidQuery(Exception):
+    """Exception class for when the FD server rejects the facts of a query."""
+    pass
+
+
+# regex to turn FD fact names like "Atom on(a, b)" into "on a b"
+_FD_ATOM_RE = re.compile(r'^Atom ([^\(]+)\((.*)\)$')
+
+
+def _fd_atom_to_prop(fact_name: str) -> Optional[str]:
+    """Convert an FD fact name to a paren-free proposition name (e.g. "Atom
+    on(a, b)" becomes "on a b"). Returns None for "NegatedAtom ..." and "<none
+    of those>" values."""
+    match = _FD_ATOM_RE.match(fact_name)
+    if match is None:
+        return None
+    pred_name, args = match.groups()
+    return ' '.join([pred_name] + [a for a in args.split(', ') if a])
+
+
+def _init_props(problem_hlist) -> List[str]:
+    """Paren-free names of the propositions in the :init of a problem."""
+    for subsec in problem_hlist:
+        if len(subsec) >= 1 and subsec[0] == ':init':
+            return [
+                ' '.join(atom) for atom in subsec[1:]
+                if all(isinstance(tok, str) for tok in atom)
+                and atom[0] != '='
+            ]
+    return []
+
+
+class FDServer(object):
+    """A `downward --server` process that answers many planning queries for
+    the same problem (see src/search/planner_server.h in FD). The problem is
+    translated and the search component is started once; each query only
+    sends an initial state, so the cost of starting FD and translating is not
+    paid for every state.
+
+    States are sent as SAS+ facts, so only states over the variables of the
+    translated task can be sent: the translator keeps only the facts that are
+    reachable from the initial state of the problem, which includes all the
+    states that the teacher visits when following policies from there."""
+
+    def __init__(self, domain_txt: str, problem_txt: str,
+                 init_props: Iterable[str]):
+        """Translate the problem and start the server.
+
+        Raises:
+            FDServerError: if the problem cannot be translated or the server
+            cannot be started.
+        """
+        assert has_fd(), \
+            "Couldn't find Fast Downward. Use try_install_fd() before using " \
+            "this."
+        if not osp.exists(FD_SEARCH_PATH):
+            raise FDServerError("Couldn't find FD search component at '%s'" %
+                                FD_SEARCH_PATH)
+        self._work_dir = osp.join('/tmp', 'fd-server-%s' % uuid.uuid1().hex)
+        os.makedirs(self._work_dir)
+        with open(osp.join(self._work_dir, 'domain.pddl'), 'w') as dom_fp, \
+                open(osp.join(self._work_dir, 'problem.pddl'), 'w') as prob_fp:
+            dom_fp.write(domain_txt)
+            prob_fp.write(problem_txt)
+        rv = subprocess.run(
+            ["python3", FD_PATH, "--translate", "domain.pddl", "problem.pddl"],
+            cwd=self._work_dir,
+            stdout=subprocess.PIPE,
+            stderr=subprocess.STDOUT,
+            universal_newlines=True,
+            check=False)
+        sas_path = osp.join(self._work_dir, SAS_BN)
+        if rv.returncode != 0 or not osp.exists(sas_path):
+            raise FDServerError("FD translator failed. Output:\n%s" %
+                                rv.stdout)
+        with open(sas_path, 'r') as sas_fp:
+            sas_txt = sas_fp.read()
+        self._parse_variables(sas_txt)
+        self._init_props = frozenset(init_props)
+
+        # the search log goes to a file (stdout only has results)
+        self._err_fp = open(osp.join(self._work_dir, STDERR_BN), 'w')
+        self._proc = subprocess.Popen([FD_SEARCH_PATH, '--server'],
+                                      cwd=self._work_dir,
+                                      stdin=subprocess.PIPE,
+                                      stdout=subprocess.PIPE,
+                                      stderr=self._err_fp,
+                                      universal_newlines=True)
+        try:
+            self._proc.stdin.write(sas_txt)
+            self._proc.stdin.flush()
+        except BrokenPipeError as ex:
+            self.close()
+            raise FDServerError("FD server died while reading the task") \
+                from ex
+
+    def _parse_variables(self, sas_txt: str) -> None:
+        # maps each proposition to its (var, value) fact
+        self._prop_to_fact: Dict[str, Tuple[int, int]] = {}
+        # value of each (non-derived) variable when none of its atoms hold
+        # (None if some atom of the variable always holds)
+        self._var_default_value: Dict[int, Optional[int]] = {}
+        lines = iter(sas_txt.splitlines())
+        var = 0
+        for line in lines:
+            if line != 'begin_variable':
+                continue
+            next(lines)  # name
+            axiom_layer = int(next(lines))
+            domain_size = int(next(lines))
+            fact_names = [next(lines) for _ in range(domain_size)]
+            if axiom_layer == -1:
+                self._var_default_value[var] = None
+                for value, fact_name in enumerate(fact_names):
+                    prop = _fd_atom_to_prop(fact_name)
+                    if prop is None:
+                        self._var_default_value[var] = value
+                    else:
+                        self._prop_to_fact[prop] = (var, value)
+            var += 1
+
+    def state_to_facts(self, true_props: Iterable[str]) \
+            -> Optional[List[Tuple[int, int]]]:
+        """SAS+ facts of the state where exactly the given propositions hold,
+        or None if the state cannot be represented in the translated task."""
+        values: Dict[int, int] = {}
+        for prop in true_props:
+            fact = self._prop_to_fact.get(prop)
+            if fact is None:
+                if prop in self._init_props:
+                    # static or constant, so not in the translated task
+                    continue
+                return None
+            var, value = fact
+            if values.setdefault(var, value) != value:
+                # two atoms of the same (mutex) variable
+                return None
+        facts = []
+        for var, default_value in self._var_default_value.items():
+            if var in values:
+                facts.append((var, values[var]))
+            elif default_value is not None:
+                facts.append((var, default_value))
+            else:
+                return None
+        return facts
+
+    def plan(self, facts: List[Tuple[int, int]], search_args: List[str]) \
+            -> Optional[List[str]]:
+        """Plan from the state given by facts (see state_to_facts).
+
+        Raises:
+            FDTimeout: if the search times out (see the max_time option of FD
+            search engines).
+            FDInvalidQuery: if the server rejected the facts.
+            FDServerError: if the server died.
+
+        Returns:
+            Optional[List[str]]: The plan (paren-free action names), or None
+            if the planner failed to find a plan.
+        """
+        query = ['begin_query', str(len(search_args)), *search_args,
+                 str(len(facts)), *('%d %d' % fact for fact in facts),
+                 'end_query']
+        try:
+            self._proc.stdin.write('\n'.join(query) + '\n')
+            self._proc.stdin.flush()
+            line = self._proc.stdout.readline()
+            while line and line.strip() != 'begin_result':
+                line = self._proc.stdout.readline()
+            if not line:
+                raise FDServerError(
+                    "FD server died (return code %r); see %s" %
+                    (self._proc.poll(), osp.join(self._work_dir, STDERR_BN)))
+            status = self._proc.stdout.readline().strip()
+            self._proc.stdout.readline()  # plan cost
+            plan_len = int(self._proc.stdout.readline())
+            plan = [
+                self._proc.stdout.readline().strip() for _ in range(plan_len)
+            ]
+            assert self._proc.stdout.readline().strip() == 'end_result'
+        except (BrokenPipeError, ValueError) as ex:
+            raise FDServerError("Lost connection to FD server") from ex
+        if status == 'timeout':
+            raise FDTimeout("FD server timed out during search")
+        if status == 'invalid':
+            raise FDInvalidQuery("FD server rejected the facts %r" % (facts, ))
+        if status != 'solved':
+            return None
+        return plan
+
+    def close(self) -> None:
+        """Stop the server and delete its files."""
+        if self._proc.poll() is None:
+            try:
+                self._proc.stdin.write('quit\n')
+                self._proc.stdin.close()
+                self._proc.wait(timeout=5)
+            except (BrokenPipeError, subprocess.TimeoutExpired):
+                self._proc.kill()
+                self._proc.wait()
+        self._err_fp.close()
+        shutil.rmtree(self._work_dir, ignore_errors=True)
+
+
+def _with_max_time(search_args: List[str], max_time_s: Optional[float]) \
+        -> List[str]:
+    """Add a max_time option to the --search argument of FD."""
+    if max_time_s is None:
+        return search_args
+    idx = search_args.index('--search') + 1
+    search = search_args[idx]
+    assert search.endswith(')'), search
+    new_args = list(search_args)
+    new_args[idx] = '%s,max_time=%d)' % (search[:-1], max_time_s)
+    return new_args
+
+
 def _simulate_plan(init_cstate: CanonicalState,
                    plan_strs: List[str],
                    planner_exts: 'PlannerExtensions') \
@@ -411,7 +629,8 @@ class FDQValueCache(object):
                  planner_exts: 'PlannerExtensions',
                  *,
                  planner: str='astar-hadd',
-                 timeout_s: float=3600):
+                 timeout_s: float=3600,
+                 use_server: bool=True):
         """Construct a new FDQValueCache.
 
         Args:
@@ -419,6 +638,10 @@ class FDQValueCache(object):
             planner (str, optional): Planner to use. Defaults to 'astar-hadd'.
             timeout_s (float, optional): Timeout for fast downward. Defaults to
             1800 seconds.
+            use_server (bool, optional): Send the states to a single FD server
+            process (see FDServer) instead of running FD once per state.
+            States that the server cannot handle still use a new FD process.
+            Defaults to True.
         """
         # maps each state to a value computed via FD (states are represented by
         # tuples of true prop names, in no-paren format)
@@ -438,6 +661,70 @@ class FDQValueCache(object):
         self._planner_name = planner
         self._timeout_s = timeout_s
         self._fd_blacklist = set()
+        self._use_server = use_server
+        self._server = None
+
+    def __del__(self):
+        self.close()
+
+    def close(self):
+        """Stop the FD server (if any)."""
+        if getattr(self, '_server', None) is not None:
+            self._server.close()
+            self._server = None
+
+    def _get_server(self) -> Optional[FDServer]:
+        """Return the FD server, starting it if necessary. Returns None if
+        the server is disabled or cannot be started."""
+        if self._use_server and self._server is None:
+            try:
+                self._server = FDServer(
+                    self._domain_source,
+                    hlist_to_sexprs(self._problem_hlist),
+                    _init_props(self._problem_hlist))
+            except FDServerError as ex:
+                warn("Could not start FD server, running FD once per state "
+                     "instead: %s" % ex)
+                self._use_server = False
+        return self._server
+
+    def _run_fd_server_with_blacklist(self, tup_state) \
+            -> Tuple[bool, Optional[List[str]]]:
+        """Plan for a state using the FD server (if possible), blacklisting
+        states that time out.
+
+        Raises:
+            FDTimeout: If the state is blacklisted or if fast downward times
+            out.
+
+        Returns:
+            Tuple[bool, Optional[List[str]]]: Whether the server handled the
+            state, and the plan (see run_fd_or_timeout).
+        """
+        server = self._get_server()
+        facts = None if server is None else server.state_to_facts(tup_state)
+        if facts is None:
+            return False, None
+        ident_tup = ('server', self._planner_name, tup_state)
+        if ident_tup in self._fd_blacklist:
+            raise FDTimeout("this state previously caused planner timeout")
+        search_args = _with_max_time(
+            _planner_search_args(self._planner_name, 'infinity'),
+            self._timeout_s)
+        try:
+            return True, server.plan(facts, search_args)
+        except FDTimeout:
+            self._fd_blacklist.add(ident_tup)
+            raise
+        except FDInvalidQuery as ex:
+            warn("%s; running FD for this state instead" % ex)
+            return False, None
+        except FDServerError as ex:
+            warn("FD server failed, running FD once per state instead: %s" %
+                 ex)
+            self.close()
+            self._use_server = False
+            return False, None
 
     def _run_fd_with_blacklist(self, *args, **kwargs):
         """Run fast downard with interface, blacklist states if they timeout.
@@ -461,6 +748,9 @@ class FDQValueCache(object):
         except FDTimeout:
             self._fd_blacklist.add(ident_tup)
             raise
+        except FDInvalidQuery as ex:
+            warn("%s; running FD for this state instead" % ex)
+            return False, None
 
     def compute_state_value_action(self, cstate: CanonicalState) \
         -> Tuple[Optional[float], Optional[str]]:
@@ -498,13 +788,16 @@ class FDQValueCache(object):
             self.best_action_cache[tup_state] = None
             return cost, None
 
-        # *_source is a string containing PDDL, *_hlist is the AST for the PDDL
-        problem_hlist = replace_init_state(self._problem_hlist, tup_state)
-        problem_source = hlist_to_sexprs(problem_hlist)
-        plan = self._run_fd_with_blacklist(self._planner_name,
-                                           self._domain_source,
-                                           problem_source,
-                                           timeout_s=self._timeout_s)
+        handled, plan = self._run_fd_server_with_blacklist(tup_state)
+        if not handled:
+            # *_source is a string containing PDDL, *_hlist is the AST for the
+            # PDDL
+            problem_hlist = replace_init_state(self._problem_hlist, tup_state)
+            problem_source = hlist_to_sexprs(problem_hlist)
+            plan = self._run_fd_with_blacklist(self._planner_name,
+                                               self._domain_source,
+                                               problem_source,
+                                               timeout_s=self._timeout_s)
 
         if plan is None:
             # couldn't find a plan
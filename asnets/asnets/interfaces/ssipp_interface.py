@@ -172,6 +172,34 @@ class Cutter:
         return self.cut_cache[ssipp_state]
 
 
+class BatchFeatureExtractor:
+    """Computes the per-action features of LMCutDataGenerator (if
+    heuristic_name is None) or HeuristicDataGenerator for many states at once.
+    The work is done by SSiPP's ActionFeatureExtractor on n_threads threads,
+    with the GIL released."""
+
+    def __init__(self, planner_exts, heuristic_name=None, n_threads=1):
+        ssipp = planner_exts.ssipp
+        self.act_names = [
+            ba.unique_ident
+            for ba in planner_exts.problem_meta.bound_acts_ordered
+        ]
+        if heuristic_name is None:
+            feature_type = ssipp.ActionFeatureExtractor.CUT_FEATURES
+            heuristic_name = ""
+        else:
+            feature_type = ssipp.ActionFeatureExtractor.HEURISTIC_FEATURES
+        self.extractor = ssipp.ActionFeatureExtractor(
+            planner_exts.ssipp_problem, self.act_names, feature_type,
+            heuristic_name, n_threads)
+
+    def extract(self, ssipp_states):
+        """Returns a (len(ssipp_states), |A|, extra_dim) float32 array of
+        features (actions in ProblemMeta.bound_acts_ordered order) and an
+        array with the heuristic value of each state."""
+        return self.extractor.extract(list(ssipp_states))
+
+
 def format_state_for_ssipp(all_props):
     """Converts true prop list to string format that SSiPP can read.
     all_props can be obtained from an MDPSimObservation instance's props_true
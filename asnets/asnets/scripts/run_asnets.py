@@ -357,6 +357,13 @@ parser.add_argument(
     default=False,
     action='store_true',
     help='add features for past execution count of each action')
+parser.add_argument(
+    '--dg-threads',
+    dest='dg_n_threads',
+    type=int,
+    default=1,
+    help='number of threads used to compute the heuristic and lm-cut '
+    'features of the outcomes of an action')
 parser.add_argument(
     '--save-training-set',
     default=None,
@@ -601,6 +608,7 @@ def make_services(args):
             teacher_timeout_s=args.teacher_timeout_s,
             only_one_good_action=only_one_good_action,
             use_act_history=args.use_act_history,
+            dg_n_threads=args.dg_n_threads,
             use_teacher_envelope=args.use_teacher_envelope)
         problem_server = ProblemServer(service_config)
         servers.append(problem_server)
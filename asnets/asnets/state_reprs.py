@@ -194,15 +194,67 @@ class CanonicalState(object):
         Returns:
             None: None.
         """
-        extra_data = []
+        data_gens = list(data_gens)
+        extra_data = [
+            dg.get_extra_data(self,
+                              prev_cstate=prev_cstate,
+                              prev_act=prev_act,
+                              is_init_cstate=is_init_cstate)
+            for dg in data_gens
+        ]
+        self._set_aux_data(data_gens, extra_data)
+
+    @classmethod
+    def populate_aux_data_batch(cls,
+                                cstates: List[Self],
+                                data_gens: Iterable['ActionDataGenerator'],
+                                *,
+                                prev_cstate: Optional[Self] = None,
+                                prev_act: Optional[BoundAction] = None,
+                                is_init_cstate: Optional[bool] = None) \
+            -> None:
+        """Same as calling `.populate_aux_data()` on each of the given
+        states, which share the same previous state and action (e.g., the
+        outcomes of an action). Data generators that do not require memory
+        compute the data of all states with one call to
+        `ActionDataGenerator.get_extra_data_batch()`.
+
+        Args:
+            cstates (List[CanonicalState]): states to populate.
+            data_gens (Iterable[ActionDataGenerator]): data generators to use.
+            prev_cstate (Optional[CanonicalState], optional): previous state.
+            prev_act (Optional[BoundAction], optional): previous action.
+            is_init_cstate (Optional[bool], optional): whether these are
+            initial states.
+
+        Returns:
+            None: None.
+        """
+        if not cstates:
+            return
+        data_gens = list(data_gens)
+        # dg_data[i][j] is the data of data_gens[i] for cstates[j]
+        dg_data = []
+        for dg in data_gens:
+            if dg.requires_memory:
+                dg_data.append([
+                    dg.get_extra_data(cstate,
+                                      prev_cstate=prev_cstate,
+                                      prev_act=prev_act,
+                                      is_init_cstate=is_init_cstate)
+                    for cstate in cstates
+                ])
+            else:
+                dg_data.append(dg.get_extra_data_batch(cstates))
+        for j, cstate in enumerate(cstates):
+            cstate._set_aux_data(data_gens, [data[j] for data in dg_data])
+
+    def _set_aux_data(self, data_gens: Iterable['ActionDataGenerator'],
+                      extra_data: List[np.ndarray]) -> None:
+        """Store the data computed by each of the data generators."""
         interp = []
         requires_memory = False
         for dg in data_gens:
-            dg_data = dg.get_extra_data(self,
-                                        prev_cstate=prev_cstate,
-                                        prev_act=prev_act,
-                                        is_init_cstate=is_init_cstate)
-            extra_data.append(dg_data)
             interp.extend(dg.dim_names)
             requires_memory |= dg.requires_memory
         if len(extra_data) == 0:
@@ -295,10 +347,11 @@ class CanonicalState(object):
                    *,
                    prev_cstate=None,
                    prev_act=None,
-                   is_init_cstate=None):
+                   is_init_cstate=None,
+                   populate_aux_data=True):
         problem = planner_exts.ssipp_problem
         problem_meta = planner_exts.problem_meta
-        data_gens = planner_exts.data_gens
+        data_gens = planner_exts.data_gens if populate_aux_data else None
         ssipp_string = problem.string_repr(ssipp_state)
 
         # I made the (poor) decision of having string_repr return a string of
@@ -442,13 +495,19 @@ def successors(cstate: CanonicalState, action_id: int,
     # gives us a list of (probability, ssipp successor state) tuples
     ssipp_successors = planner_exts.ssipp.successors(
         planner_exts.ssipp_ssp_iface, ssipp_state, ssipp_action)
+    # the aux data of all outcomes is computed at once, so that the data
+    # generators can use the batched (multi-threaded) feature extraction
     canon_successors = [(p,
                          CanonicalState.from_ssipp(s,
                                                    planner_exts,
-                                                   prev_cstate=cstate,
-                                                   prev_act=bound_act,
-                                                   is_init_cstate=False))
+                                                   populate_aux_data=False))
                         for p, s in ssipp_successors]
+    CanonicalState.populate_aux_data_batch(
+        [succ for _, succ in canon_successors],
+        planner_exts.data_gens,
+        prev_cstate=cstate,
+        prev_act=bound_act,
+        is_init_cstate=False)
     return canon_successors
 
 
@@ -101,6 +101,7 @@ class ProblemServiceConfig(object):
             heuristic_name: str = None,
             use_lm_cuts: bool = False,
             use_act_history: bool = False,
+            dg_n_threads: int = 1,
             # ??? what does this do?
             # Oh, it controls the maximum length of training trajectories! That
             # explains why I'm not able to solve some certain big training
@@ -135,6 +136,9 @@ class ProblemServiceConfig(object):
             Defaults to False.
             use_act_history (bool, optional): Whether to use action history
             as input to the heuristic. Defaults to False.
+            dg_n_threads (int, optional): Number of threads used by the
+            heuristic and lm-cut data generators to compute the features of
+            a batch of states. Defaults to 1.
             max_len (int, optional): Maximum length of training trajectories.
             Defaults to 50.
             teacher_heur (str, optional): Name of the heuristic to use for
@@ -155,6 +159,7 @@ class ProblemServiceConfig(object):
         self.heuristic_name = heuristic_name
         self.use_lm_cuts = use_lm_cuts
         self.use_act_history = use_act_history
+        self.dg_n_threads = dg_n_threads
         self.fd_heuristic_name = fd_heuristic_name
         self.max_len = max_len
         self.random_seed = random_seed
@@ -177,7 +182,8 @@ class PlannerExtensions(object):
                  *,
                  dg_heuristic_name: str = None,
                  dg_use_lm_cuts: bool = False,
-                 dg_use_act_history: bool = False):
+                 dg_use_act_history: bool = False,
+                 dg_n_threads: int = 1):
         """Initialise a PlannerExtensions object.
 
         Args:
@@ -189,6 +195,9 @@ class PlannerExtensions(object):
             feature generator. Defaults to False.
             dg_use_act_history (bool, optional): Whether to use the action count
             data generator. Defaults to False.
+            dg_n_threads (int, optional): Number of threads used by the
+            heuristic and lm-cut feature generators to compute the features
+            of a batch of states. Defaults to 1.
         """
         self.pddl_files = pddl_files
         print('Parsing %d PDDL files' % len(self.pddl_files))
@@ -236,11 +245,12 @@ class PlannerExtensions(object):
             # print('Creating heuristic feature generator (h=%s)' %
             #       heuristic_name)
             heur_gen = HeuristicDataGenerator(
-                weak_ref_to(self), dg_heuristic_name)
+                weak_ref_to(self), dg_heuristic_name, n_threads=dg_n_threads)
             data_gens.append(heur_gen)
         if dg_use_lm_cuts:
             # print('Creating lm-cut heuristic feature generator')
-            lm_cut_gen = LMCutDataGenerator(weak_ref_to(self))
+            lm_cut_gen = LMCutDataGenerator(weak_ref_to(self),
+                                            n_threads=dg_n_threads)
             data_gens.append(lm_cut_gen)
         if dg_use_act_history:
             ad_data_gen = ActionCountDataGenerator(self.problem_meta)
@@ -366,7 +376,8 @@ def make_problem_service(config, set_proc_title=False):
                 config.init_problem_name,
                 dg_heuristic_name=config.heuristic_name,
                 dg_use_lm_cuts=config.use_lm_cuts,
-                dg_use_act_history=config.use_act_history)
+                dg_use_act_history=config.use_act_history,
+                dg_n_threads=config.dg_n_threads)
             self.domain_meta = self.p.domain_meta
             self.problem_meta = self.p.problem_meta
             self.only_one_good_action = config.only_one_good_action
@@ -0,0 +1,68 @@
+"""Tests that the batched feature extraction of the SSiPP data generators
+(which runs in SSiPP on several threads) agrees with the per-state Python
+path."""
+
+import numpy as np
+import pytest
+
+pytest.importorskip('mdpsim')
+pytest.importorskip('ssipp')
+
+from asnets.heur_inputs import HeuristicDataGenerator, \
+    LMCutDataGenerator  # noqa: E402
+from asnets.state_reprs import CanonicalState, get_init_cstate, \
+    successors  # noqa: E402
+from asnets.utils.py_utils import weak_ref_to  # noqa: E402
+
+
+@pytest.fixture(scope='module')
+def cstates(planner_exts):
+    """States reachable in at most three steps from the initial state."""
+    layer = [get_init_cstate(planner_exts)]
+    seen = {layer[0].to_fd_proplist(): layer[0]}
+    for _ in range(3):
+        next_layer = []
+        for cstate in layer:
+            for action_id, (_, enabled) in enumerate(cstate.acts_enabled):
+                if not enabled:
+                    continue
+                for _, succ in successors(cstate, action_id, planner_exts):
+                    key = succ.to_fd_proplist()
+                    if key not in seen:
+                        seen[key] = succ
+                        next_layer.append(succ)
+        layer = next_layer
+    return list(seen.values())
+
+
+@pytest.mark.parametrize('n_threads', [1, 3])
+@pytest.mark.parametrize('use_lm_cuts', [True, False])
+def test_batch_matches_per_state(planner_exts, cstates, n_threads,
+                                 use_lm_cuts):
+    if use_lm_cuts:
+        dg = LMCutDataGenerator(weak_ref_to(planner_exts), n_threads=n_threads)
+    else:
+        dg = HeuristicDataGenerator(weak_ref_to(planner_exts),
+                                    'h-add',
+                                    n_threads=n_threads)
+    per_state = np.stack(
+        [dg.get_extra_data_no_memory(cstate) for cstate in cstates])
+    batch = dg.get_extra_data_batch(cstates)
+    assert batch.shape == per_state.shape
+    assert np.array_equal(batch, per_state)
+
+
+def test_successors_aux_data(planner_exts, cstates):
+    # successors() populates the aux data of all outcomes in one batch
+    for cstate in cstates:
+        for action_id, (bound_act, enabled) in enumerate(cstate.acts_enabled):
+            if not enabled:
+                continue
+            for _, succ in successors(cstate, action_id, planner_exts):
+                expected = CanonicalState.from_ssipp(
+                    succ.to_ssipp(planner_exts),
+                    planner_exts,
+                    prev_cstate=cstate,
+                    prev_act=bound_act,
+                    is_init_cstate=False)
+                assert np.array_equal(succ.aux_data, expected.aux_data)
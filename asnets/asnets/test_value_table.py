@@ -0,0 +1,50 @@
+"""Round-trip tests for SSiPP's binary value tables (save_value_table,
+load_value_table and MappedValueTable)."""
+
+import struct
+
+import pytest
+
+pytest.importorskip('mdpsim')
+pytest.importorskip('ssipp')
+
+# offset of ValueTableHeader::state_words (after magic and version)
+STATE_WORDS_OFFSET = 12
+
+
+@pytest.fixture(scope='module')
+def solved_planner(planner_exts):
+    ssipp = planner_exts.ssipp
+    ssp = planner_exts.ssipp_ssp_iface
+    heuristic = ssipp.createHeuristic(ssp, 'h-add')
+    planner = ssipp.createPlanner(ssp, 'lrtdp', heuristic)
+    planner.decideAction(ssp.s0())
+    return planner
+
+
+def test_round_trip(planner_exts, solved_planner, tmp_path):
+    ssipp = planner_exts.ssipp
+    ssp = planner_exts.ssipp_ssp_iface
+    problem = planner_exts.ssipp_problem
+    path = str(tmp_path / 'values.bin')
+
+    n_states = ssipp.save_value_table(solved_planner, ssp, problem, path)
+    assert n_states > 0
+    with open(path, 'rb') as fp:
+        fp.seek(STATE_WORDS_OFFSET)
+        state_words, = struct.unpack('=I', fp.read(4))
+    # the states section is then not necessarily aligned to a whole state
+    assert state_words >= 2
+
+    table = ssipp.MappedValueTable(path, problem)
+    assert len(table) == n_states
+    s0 = ssp.s0()
+    value, action = table.lookup(s0)
+    assert value == solved_planner.value(s0)
+    assert action is not None
+    assert action.name() == solved_planner.decideAction(s0).name()
+
+    heuristic = ssipp.createHeuristic(ssp, 'h-add')
+    warm_planner = ssipp.createPlanner(ssp, 'lrtdp', heuristic)
+    assert ssipp.load_value_table(warm_planner, problem, path) == n_states
+    assert warm_planner.value(s0) == value
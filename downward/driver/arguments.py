@@ -189,9 +189,12 @@ def _check_mutex_args(parser, args, required=False):
 
 
 def _looks_like_search_input(filename):
-    with open(filename) as input_file:
-        first_line = next(input_file, "").rstrip()
-    return first_line == "begin_version"
+    # Translator output starts with "begin_version" in the text format
+    # and with the magic word "FDSASBIN" in the binary format.
+    with open(filename, "rb") as input_file:
+        first_line = next(input_file, b"").rstrip()
+    return (first_line == b"begin_version" or
+            first_line.startswith(b"FDSASBIN"))
 
 
 def _set_components_automatically(parser, args):
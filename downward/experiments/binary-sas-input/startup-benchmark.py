@@ -0,0 +1,97 @@
+#! /usr/bin/env python3
+
+"""Compare how long the search component needs to read the translator
+output in the text format and in the binary format (--binary-sas).
+
+Each task is translated once in each format. Then the search component is
+started repeatedly on both files with a search that stops immediately, and
+the script reports the median time between the "reading input..." and
+"done reading input!" log lines together with the median wall-clock time
+of the whole run.
+
+Usage: ./startup-benchmark.py [--build release] [--runs 10] DOMAIN PROBLEM...
+"""
+
+import argparse
+import os
+import re
+import statistics
+import subprocess
+import sys
+import tempfile
+import time
+
+DIR = os.path.dirname(os.path.abspath(__file__))
+REPO = os.path.dirname(os.path.dirname(DIR))
+SEARCH_CONFIG = "astar(blind(), bound=0)"
+LOG_TIME_REGEX = re.compile(r"^\[t=([0-9.e+-]+)s, .*\] (.*)$")
+
+
+def parse_args():
+    parser = argparse.ArgumentParser(description=__doc__.split("\n\n")[0])
+    parser.add_argument("--build", default="release",
+                        help="build directory in builds/ (default: %(default)s)")
+    parser.add_argument("--runs", type=int, default=10,
+                        help="runs per task and format (default: %(default)d)")
+    parser.add_argument("domain", help="PDDL domain file")
+    parser.add_argument("problems", nargs="+", help="PDDL problem files")
+    return parser.parse_args()
+
+
+def translate(bin_dir, domain, problem, sas_file, binary):
+    cmd = [sys.executable, os.path.join(bin_dir, "translate", "translate.py"),
+           domain, problem, "--sas-file", sas_file]
+    if binary:
+        cmd.append("--binary-sas")
+    subprocess.run(cmd, check=True, stdout=subprocess.DEVNULL)
+
+
+def time_search_startup(bin_dir, sas_file):
+    """Return the time for reading the input and the total wall-clock
+    time of one run of the search component."""
+    start = time.perf_counter()
+    with open(sas_file) as input_file:
+        output = subprocess.run(
+            [os.path.join(bin_dir, "downward"), "--search", SEARCH_CONFIG],
+            stdin=input_file, stdout=subprocess.PIPE, check=False,
+            universal_newlines=True).stdout
+    wall_time = time.perf_counter() - start
+    log_times = {}
+    for line in output.splitlines():
+        match = LOG_TIME_REGEX.match(line)
+        if match:
+            log_times.setdefault(match.group(2), float(match.group(1)))
+    read_time = (log_times["done reading input!"] -
+                 log_times["reading input..."])
+    return read_time, wall_time
+
+
+def main():
+    args = parse_args()
+    bin_dir = os.path.join(REPO, "builds", args.build, "bin")
+    print("{:30} {:>10} {:>12} {:>12} {:>12}".format(
+        "task", "format", "size (KB)", "read (ms)", "total (ms)"))
+    with tempfile.TemporaryDirectory() as tmp_dir:
+        for problem in args.problems:
+            name = os.path.basename(problem)
+            read_times = {}
+            for binary in [False, True]:
+                fmt = "binary" if binary else "text"
+                sas_file = os.path.join(tmp_dir, "output." + fmt)
+                translate(bin_dir, args.domain, problem, sas_file, binary)
+                runs = [time_search_startup(bin_dir, sas_file)
+                        for _ in range(args.runs)]
+                read_time = statistics.median(run[0] for run in runs)
+                wall_time = statistics.median(run[1] for run in runs)
+                read_times[fmt] = read_time
+                print("{:30} {:>10} {:>12.1f} {:>12.2f} {:>12.2f}".format(
+                    name, fmt, os.path.getsize(sas_file) / 1024,
+                    1000 * read_time, 1000 * wall_time))
+            if read_times["binary"] > 0:
+                print("{:30} {:>10} {:>12} {:>12.2f}x".format(
+                    name, "speedup", "",
+                    read_times["text"] / read_times["binary"]))
+
+
+if __name__ == "__main__":
+    main()
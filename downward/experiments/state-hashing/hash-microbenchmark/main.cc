@@ -0,0 +1,154 @@
+#include <algorithm>
+#include <cstdint>
+#include <ctime>
+#include <functional>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "utils/hash.h"
+
+using namespace std;
+
+/*
+  Compare hashing packed states by feeding their words to utils::HashState
+  (as the state registry did before) with the chunked word array hash, both
+  computed from scratch and updated incrementally after changing one word
+  (as the state registry does for the successors of a state).
+*/
+
+static void benchmark(const string &desc, int num_calls,
+                      const function<void()> &func) {
+    cout << "Running " << desc << " " << num_calls << " times:" << flush;
+
+    clock_t start = clock();
+    for (int j = 0; j < num_calls; ++j)
+        func();
+    clock_t end = clock();
+    double duration = static_cast<double>(end - start) / CLOCKS_PER_SEC;
+    cout << " " << duration << "s" << endl;
+}
+
+
+static uint32_t scramble(uint32_t i) {
+    return (0xdeadbeef * i) ^ 0xfeedcafe;
+}
+
+
+static uint32_t hash_with_hash_state(const uint32_t *words, int num_words) {
+    utils::HashState hash_state;
+    for (int i = 0; i < num_words; ++i) {
+        hash_state.feed(words[i]);
+    }
+    return hash_state.get_hash32();
+}
+
+
+static uint32_t hash_with_word_chunks(const uint32_t *words, int num_words) {
+    return utils::finalize_word_array_hash(
+        utils::get_word_array_hash_sum(words, num_words));
+}
+
+
+int main(int, char **) {
+    const int REPETITIONS = 2;
+    const int NUM_CALLS = 1;
+    const int NUM_STATES = 10000;
+    const int NUM_PASSES = 200;
+    const int NUM_SUCCESSORS = 10;
+    const vector<int> STATE_SIZES = {1, 2, 5, 10, 20, 50};
+
+    for (int i = 0; i < REPETITIONS; ++i) {
+        for (int num_words : STATE_SIZES) {
+            vector<uint32_t> states(NUM_STATES * num_words);
+            for (size_t j = 0; j < states.size(); ++j) {
+                states[j] = scramble(j);
+            }
+            uint32_t result = 0;
+            cout << "State size: " << num_words << " words" << endl;
+
+            benchmark("hash states with HashState", NUM_CALLS,
+                      [&]() {
+                          for (int pass = 0; pass < NUM_PASSES; ++pass) {
+                              for (int j = 0; j < NUM_STATES; ++j) {
+                                  result += hash_with_hash_state(
+                                      &states[j * num_words], num_words);
+                              }
+                          }
+                      });
+            benchmark("hash states with word chunks", NUM_CALLS,
+                      [&]() {
+                          for (int pass = 0; pass < NUM_PASSES; ++pass) {
+                              for (int j = 0; j < NUM_STATES; ++j) {
+                                  result += hash_with_word_chunks(
+                                      &states[j * num_words], num_words);
+                              }
+                          }
+                      });
+            benchmark("hash successors with HashState", NUM_CALLS,
+                      [&]() {
+                          vector<uint32_t> successor(num_words);
+                          for (int pass = 0; pass < NUM_PASSES; ++pass) {
+                              for (int j = 0; j < NUM_STATES; ++j) {
+                                  const uint32_t *state = &states[j * num_words];
+                                  for (int k = 0; k < NUM_SUCCESSORS; ++k) {
+                                      copy(state, state + num_words,
+                                           successor.begin());
+                                      int word = k % num_words;
+                                      successor[word] = scramble(k);
+                                      result += hash_with_hash_state(
+                                          successor.data(), num_words);
+                                  }
+                              }
+                          }
+                      });
+            benchmark("hash successors with word chunks", NUM_CALLS,
+                      [&]() {
+                          vector<uint32_t> successor(num_words);
+                          for (int pass = 0; pass < NUM_PASSES; ++pass) {
+                              for (int j = 0; j < NUM_STATES; ++j) {
+                                  const uint32_t *state = &states[j * num_words];
+                                  for (int k = 0; k < NUM_SUCCESSORS; ++k) {
+                                      copy(state, state + num_words,
+                                           successor.begin());
+                                      int word = k % num_words;
+                                      successor[word] = scramble(k);
+                                      result += hash_with_word_chunks(
+                                          successor.data(), num_words);
+                                  }
+                              }
+                          }
+                      });
+            benchmark("hash successors incrementally", NUM_CALLS,
+                      [&]() {
+                          vector<uint32_t> successor(num_words);
+                          for (int pass = 0; pass < NUM_PASSES; ++pass) {
+                              for (int j = 0; j < NUM_STATES; ++j) {
+                                  const uint32_t *state = &states[j * num_words];
+                                  uint64_t state_sum =
+                                      utils::get_word_array_hash_sum(
+                                          state, num_words);
+                                  for (int k = 0; k < NUM_SUCCESSORS; ++k) {
+                                      copy(state, state + num_words,
+                                           successor.begin());
+                                      int word = k % num_words;
+                                      successor[word] = scramble(k);
+                                      int chunk = word / 2;
+                                      uint64_t sum = state_sum;
+                                      sum -= utils::get_word_chunk_hash(
+                                          state, num_words, chunk);
+                                      sum += utils::get_word_chunk_hash(
+                                          successor.data(), num_words, chunk);
+                                      result +=
+                                          utils::finalize_word_array_hash(sum);
+                                  }
+                              }
+                          }
+                      });
+            // Print the result to keep the compiler from optimizing it away.
+            cout << "Combined hash: " << result << endl << endl;
+        }
+    }
+
+    return 0;
+}
@@ -0,0 +1,106 @@
+import os
+import re
+import subprocess
+import sys
+
+import pytest
+
+DIR = os.path.dirname(os.path.abspath(__file__))
+REPO_BASE = os.path.dirname(os.path.dirname(DIR))
+
+BENCHMARKS_DIR = os.path.join(REPO_BASE, "misc", "tests", "benchmarks")
+DRIVER = os.path.join(REPO_BASE, "fast-downward.py")
+SEARCH = os.path.join(REPO_BASE, "builds", "release", "bin", "downward")
+SAS_FILE = os.path.join(REPO_BASE, "test-planner-server.sas")
+
+# Initial state of gripper/prob01 where the robot is in room b and only ball1
+# is still in room a. The optimal plan has cost 4.
+# Variables: 0 = at-robby, 3-6 = at(ball1-4, rooma/roomb).
+MOSTLY_SOLVED_FACTS = [(0, 1), (4, 1), (5, 1), (6, 1)]
+
+ADMISSIBLE_LANDMARK_ARGS = [
+    "--evaluator", "h=landmark_cost_partitioning(lm_exhaust())",
+    "--search", "astar(h)"]
+
+# One predefinition that depends on the initial state and one that does not.
+MIXED_PREDEFINITION_ARGS = [
+    "--evaluator", "lmc=landmark_cost_partitioning(lm_exhaust())",
+    "--evaluator", "pdb=pdb(greedy())",
+    "--search", "astar(max([lmc, pdb]))"]
+
+INITIAL_H_RE = re.compile(r"Initial heuristic value for .*: (\d+)$", re.M)
+PATTERN_GENERATION_RE = re.compile(r"Generating pattern using: ")
+LANDMARK_GENERATION_RE = re.compile(r"Landmarks generation time: ")
+
+
+def setup_module(_module):
+    subprocess.check_call(
+        [sys.executable, DRIVER, "--sas-file", SAS_FILE, "--translate",
+         os.path.join(BENCHMARKS_DIR, "gripper", "prob01.pddl")])
+
+
+def teardown_module(_module):
+    os.remove(SAS_FILE)
+
+
+def make_query(args, facts):
+    lines = ["begin_query", str(len(args))] + args + [str(len(facts))]
+    lines += ["{} {}".format(var, value) for var, value in facts]
+    lines.append("end_query")
+    return "\n".join(lines) + "\n"
+
+
+def run_server_process(queries):
+    with open(SAS_FILE) as sas_file:
+        task = sas_file.read()
+    return subprocess.run(
+        [SEARCH, "--server"], input=task + "".join(queries),
+        stdout=subprocess.PIPE, stderr=subprocess.PIPE,
+        universal_newlines=True, check=True)
+
+
+def run_server(queries):
+    """Return the results and the initial heuristic values of the queries."""
+    process = run_server_process(queries)
+    results = []
+    lines = process.stdout.splitlines()
+    for index, line in enumerate(lines):
+        if line == "begin_result":
+            status, cost = lines[index + 1], int(lines[index + 2])
+            results.append((status, cost))
+    initial_h_values = [int(h) for h in INITIAL_H_RE.findall(process.stderr)]
+    return results, initial_h_values
+
+
+def test_predefinitions_depend_on_initial_state():
+    # The landmark graph of the first query must not be reused for the
+    # second query, whose initial state is different.
+    results, initial_h_values = run_server([
+        make_query(ADMISSIBLE_LANDMARK_ARGS, []),
+        make_query(ADMISSIBLE_LANDMARK_ARGS, MOSTLY_SOLVED_FACTS)])
+    fresh_results, fresh_initial_h_values = run_server([
+        make_query(ADMISSIBLE_LANDMARK_ARGS, MOSTLY_SOLVED_FACTS)])
+    assert results[1] == fresh_results[0] == ("solved", 4)
+    assert initial_h_values[1] == fresh_initial_h_values[0]
+    assert initial_h_values[1] <= 4
+
+
+def test_independent_predefinitions_survive_state_change():
+    # The PDB is constructed once for all three queries, the landmark graph
+    # again for each new initial state.
+    process = run_server_process([
+        make_query(MIXED_PREDEFINITION_ARGS, []),
+        make_query(MIXED_PREDEFINITION_ARGS, MOSTLY_SOLVED_FACTS),
+        make_query(MIXED_PREDEFINITION_ARGS, MOSTLY_SOLVED_FACTS)])
+    assert process.stdout.count("begin_result") == 3
+    assert len(PATTERN_GENERATION_RE.findall(process.stderr)) == 1
+    assert len(LANDMARK_GENERATION_RE.findall(process.stderr)) == 2
+
+
+@pytest.mark.parametrize("facts", [[(0, 2)], [(0, -1)], [(7, 0)]])
+def test_invalid_facts(facts):
+    # Invalid facts are reported for their query only.
+    args = ["--search", "astar(blind())"]
+    results, _ = run_server([
+        make_query(args, facts), make_query(args, MOSTLY_SOLVED_FACTS)])
+    assert results == [("invalid", -1), ("solved", 4)]
@@ -50,7 +50,9 @@ fast_downward_plugin(
 
         abstract_task
         axioms
+        batch_evaluator
         command_line
+        delta_state_pool
         evaluation_context
         evaluation_result
         evaluator
@@ -65,6 +67,7 @@ fast_downward_plugin(
         per_state_information
         per_task_information
         plan_manager
+        planner_server
         pruning_method
         search_engine
         search_node_info
@@ -128,6 +131,7 @@ fast_downward_plugin(
         utils/system
         utils/system_unix
         utils/system_windows
+        utils/thread_pool
         utils/timer
     CORE_PLUGIN
 )
@@ -206,6 +210,14 @@ fast_downward_plugin(
     DEPENDENCY_ONLY
 )
 
+fast_downward_plugin(
+    NAME CONCURRENT_INT_HASH_SET
+    HELP "Hash set storing non-negative integers that supports concurrent insertions"
+    SOURCES
+        algorithms/concurrent_int_hash_set
+    DEPENDENCY_ONLY
+)
+
 fast_downward_plugin(
     NAME INT_PACKER
     HELP "Greedy bin packing algorithm to pack integer variables with small domains tightly into memory"
@@ -456,6 +468,30 @@ fast_downward_plugin(
     DEPENDS G_EVALUATOR ORDERED_SET PREF_EVALUATOR SEARCH_COMMON SUCCESSOR_GENERATOR
 )
 
+fast_downward_plugin(
+    NAME HDA_ASTAR_SEARCH
+    HELP "Hash distributed A* search"
+    SOURCES
+        search_engines/hda_astar_search
+    DEPENDS SEARCH_COMMON SUCCESSOR_GENERATOR TASK_PROPERTIES
+)
+
+fast_downward_plugin(
+    NAME LAZY_PARALLEL_SEARCH
+    HELP "Parallel lazy greedy search with a shared closed list"
+    SOURCES
+        search_engines/lazy_parallel_search
+    DEPENDS CONCURRENT_INT_HASH_SET ORDERED_SET SEARCH_COMMON SUCCESSOR_GENERATOR TASK_PROPERTIES
+)
+
+fast_downward_plugin(
+    NAME EXTERNAL_BFS_SEARCH
+    HELP "Breadth-first search in external memory"
+    SOURCES
+        search_engines/external_bfs_search
+    DEPENDS SUCCESSOR_GENERATOR
+)
+
 fast_downward_plugin(
     NAME ITERATED_SEARCH
     HELP "Iterated search algorithm"
@@ -463,6 +499,13 @@ fast_downward_plugin(
         search_engines/iterated_search
 )
 
+fast_downward_plugin(
+    NAME PARALLEL_PORTFOLIO_SEARCH
+    HELP "Parallel portfolio of search algorithms"
+    SOURCES
+        search_engines/parallel_portfolio_search
+)
+
 fast_downward_plugin(
     NAME LAZY_SEARCH
     HELP "Lazy search algorithm"
@@ -615,9 +658,10 @@ fast_downward_plugin(
     HELP "Successor generator"
     SOURCES
         task_utils/successor_generator
+        task_utils/successor_generator_bitmask
         task_utils/successor_generator_factory
         task_utils/successor_generator_internals
-    DEPENDS TASK_PROPERTIES
+    DEPENDS INT_PACKER TASK_PROPERTIES
     DEPENDENCY_ONLY
 )
 
@@ -0,0 +1,200 @@
+#ifndef ALGORITHMS_CONCURRENT_INT_HASH_SET_H
+#define ALGORITHMS_CONCURRENT_INT_HASH_SET_H
+
+#include "../utils/logging.h"
+#include "../utils/system.h"
+
+#include <atomic>
+#include <cassert>
+#include <cstdint>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <utility>
+
+namespace concurrent_int_hash_set {
+/*
+  Hash set for storing non-negative integer keys that several threads can
+  insert into concurrently.
+
+  Like IntHashSet, the set only stores keys and their hash values. The
+  semantics of the keys (e.g., the states they refer to) are defined by the
+  given hasher and equality tester, which must be callable from all threads.
+  Keys must be published before they are inserted: when a thread finds the
+  key of another thread in the set, all writes of the other thread before
+  the insertion are visible to it.
+
+  Usage:
+
+  ConcurrentIntHashSet<MyHasher, MyEqualityTester> s(hasher, equal);
+  pair<KeyType, bool> result = s.insert(key, hasher(key));
+
+  Implementation:
+
+  All keys are stored in a single array of 64-bit buckets, using open
+  addressing with linear probing. Each bucket holds the key and the upper
+  bits of its hash value, so that most comparisons of different keys do not
+  need to call the equality tester. A thread inserts a key by claiming an
+  empty bucket with a compare-and-swap operation. The hopscotch moves of
+  IntHashSet cannot be done atomically, so we keep the load factor below
+  MAX_LOAD_FACTOR instead to bound the probing distance.
+
+  Inserting threads share a read lock on the bucket array, and a thread
+  that needs to enlarge the array takes the write lock. Since the array
+  doubles in size, this happens rarely.
+
+  Limitations:
+
+  Keys must be smaller than 2^40 - 1 because the bucket stores key + 1 in
+  its lower 40 bits (0 marks empty buckets) and 24 bits of the hash value in
+  its upper 24 bits.
+*/
+
+using KeyType = std::uint64_t;
+using HashType = std::uint32_t;
+
+template<typename Hasher, typename Equal>
+class ConcurrentIntHashSet {
+    using Bucket = std::uint64_t;
+
+    static const int KEY_BITS = 40;
+    static const Bucket EMPTY_BUCKET = 0;
+    static const std::size_t INITIAL_CAPACITY = 1 << 16;
+    static constexpr double MAX_LOAD_FACTOR = 0.5;
+
+    Hasher hasher;
+    Equal equal;
+    std::unique_ptr<std::atomic<Bucket>[]> buckets;
+    std::size_t num_buckets;
+    std::atomic<std::size_t> num_entries;
+    std::shared_mutex buckets_mutex;
+    int num_resizes;
+
+    static Bucket get_tag(HashType hash) {
+        return static_cast<Bucket>(hash >> (32 - (64 - KEY_BITS))) << KEY_BITS;
+    }
+
+    static Bucket make_bucket(KeyType key, HashType hash) {
+        return get_tag(hash) | (key + 1);
+    }
+
+    static KeyType get_key(Bucket bucket) {
+        assert(bucket != EMPTY_BUCKET);
+        return (bucket & ((Bucket(1) << KEY_BITS) - 1)) - 1;
+    }
+
+    std::size_t get_max_entries() const {
+        return static_cast<std::size_t>(num_buckets * MAX_LOAD_FACTOR);
+    }
+
+    /*
+      Insert the key without checking the load factor. The caller must hold
+      the lock on the bucket array.
+    */
+    std::pair<KeyType, bool> insert_into_buckets(KeyType key, HashType hash) {
+        Bucket new_bucket = make_bucket(key, hash);
+        Bucket tag = get_tag(hash);
+        std::size_t mask = num_buckets - 1;
+        for (std::size_t index = hash & mask;; index = (index + 1) & mask) {
+            Bucket bucket = buckets[index].load(std::memory_order_acquire);
+            while (bucket == EMPTY_BUCKET) {
+                if (buckets[index].compare_exchange_weak(
+                        bucket, new_bucket,
+                        std::memory_order_acq_rel, std::memory_order_acquire)) {
+                    return std::make_pair(key, true);
+                }
+            }
+            // The bucket is full, either before or after the failed CAS.
+            if ((bucket & ~((Bucket(1) << KEY_BITS) - 1)) == tag &&
+                equal(get_key(bucket), key)) {
+                return std::make_pair(get_key(bucket), false);
+            }
+        }
+    }
+
+    void enlarge(std::size_t old_num_buckets) {
+        std::unique_lock<std::shared_mutex> lock(buckets_mutex);
+        // Another thread may have enlarged the array in the meantime.
+        if (num_buckets != old_num_buckets)
+            return;
+        if (num_buckets > (std::size_t(1) << 40)) {
+            std::cerr << "ConcurrentIntHashSet surpassed maximum capacity."
+                      << std::endl;
+            utils::exit_with(utils::ExitCode::SEARCH_CRITICAL_ERROR);
+        }
+        std::unique_ptr<std::atomic<Bucket>[]> old_buckets = std::move(buckets);
+        num_buckets *= 2;
+        buckets.reset(new std::atomic<Bucket>[num_buckets]());
+        std::size_t mask = num_buckets - 1;
+        for (std::size_t i = 0; i < old_num_buckets; ++i) {
+            Bucket bucket = old_buckets[i].load(std::memory_order_relaxed);
+            if (bucket == EMPTY_BUCKET)
+                continue;
+            std::size_t index = hasher(get_key(bucket)) & mask;
+            while (buckets[index].load(std::memory_order_relaxed) != EMPTY_BUCKET) {
+                index = (index + 1) & mask;
+            }
+            buckets[index].store(bucket, std::memory_order_relaxed);
+        }
+        ++num_resizes;
+    }
+
+public:
+    ConcurrentIntHashSet(const Hasher &hasher, const Equal &equal)
+        : hasher(hasher),
+          equal(equal),
+          buckets(new std::atomic<Bucket>[INITIAL_CAPACITY]()),
+          num_buckets(INITIAL_CAPACITY),
+          num_entries(0),
+          num_resizes(0) {
+    }
+
+    std::size_t size() const {
+        return num_entries.load(std::memory_order_relaxed);
+    }
+
+    /*
+      Insert a key with the given hash value, which must be equal to the
+      value that the hasher computes for the key.
+
+      Return a pair whose first item is the given key, or an equivalent key
+      already contained in the hash set. The second item in the pair is a
+      bool indicating whether a new key was inserted into the hash set.
+      If several threads concurrently insert equivalent keys, exactly one of
+      them succeeds.
+    */
+    std::pair<KeyType, bool> insert(KeyType key, HashType hash) {
+        assert(key < (KeyType(1) << KEY_BITS) - 1);
+        assert(hasher(key) == hash);
+        while (true) {
+            std::size_t old_num_buckets;
+            {
+                std::shared_lock<std::shared_mutex> lock(buckets_mutex);
+                /*
+                  Concurrent insertions can exceed the maximum load factor
+                  by the number of threads, which is harmless because the
+                  initial capacity is large.
+                */
+                if (num_entries.load(std::memory_order_relaxed) < get_max_entries()) {
+                    std::pair<KeyType, bool> result = insert_into_buckets(key, hash);
+                    if (result.second)
+                        num_entries.fetch_add(1, std::memory_order_relaxed);
+                    return result;
+                }
+                old_num_buckets = num_buckets;
+            }
+            enlarge(old_num_buckets);
+        }
+    }
+
+    void print_statistics(utils::LogProxy &log) const {
+        log << "Concurrent int hash set load factor: " << size() << "/"
+            << num_buckets << " = "
+            << static_cast<double>(size()) / num_buckets << std::endl;
+        log << "Concurrent int hash set resizes: " << num_resizes << std::endl;
+    }
+};
+}
+
+#endif
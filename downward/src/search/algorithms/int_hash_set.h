@@ -292,6 +292,18 @@ public:
         return insert(key, hasher(key));
     }
 
+    /*
+      Like insert(key), but use the given hash value, which must be equal to
+      the value the hasher computes for the key. This allows callers to
+      compute the hash value more cheaply than the hasher, e.g.,
+      incrementally.
+    */
+    std::pair<KeyType, bool> insert_with_hash(KeyType key, HashType hash) {
+        assert(key >= 0);
+        assert(hash == hasher(key));
+        return insert(key, hash);
+    }
+
     void dump(utils::LogProxy &log) const {
         int num_buckets = capacity();
         log << "[";
@@ -53,6 +53,10 @@ public:
     ~VariableInfo() {
     }
 
+    int get_bin_index() const {
+        return bin_index;
+    }
+
     int get(const Bin *buffer) const {
         return (buffer[bin_index] & read_mask) >> shift;
     }
@@ -77,6 +81,10 @@ int IntPacker::get(const Bin *buffer, int var) const {
     return var_infos[var].get(buffer);
 }
 
+int IntPacker::get_bin_index(int var) const {
+    return var_infos[var].get_bin_index();
+}
+
 void IntPacker::set(Bin *buffer, int var, int value) const {
     var_infos[var].set(buffer, value);
 }
@@ -41,6 +41,8 @@ public:
 
     int get(const Bin *buffer, int var) const;
     void set(Bin *buffer, int var, int value) const;
+    // Return the index of the bin that holds the value of var.
+    int get_bin_index(int var) const;
 
     int get_num_bins() const {return num_bins;}
 };
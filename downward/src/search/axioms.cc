@@ -89,6 +89,7 @@ void AxiomEvaluator::evaluate(vector<int> &state) {
     if (!task_has_axioms)
         return;
 
+    lock_guard<mutex> lock(evaluation_mutex);
     assert(queue.empty());
     for (size_t var_id = 0; var_id < default_values.size(); ++var_id) {
         int default_value = default_values[var_id];
@@ -5,6 +5,7 @@
 #include "task_proxy.h"
 
 #include <memory>
+#include <mutex>
 #include <vector>
 
 class AxiomEvaluator {
@@ -54,6 +55,13 @@ class AxiomEvaluator {
     */
     std::vector<const AxiomLiteral *> queue;
 
+    /*
+      The rules and the queue are modified during evaluation, and searches
+      that run concurrently on several threads (see parallel_portfolio)
+      share the evaluator of the task.
+    */
+    std::mutex evaluation_mutex;
+
     template<typename Values, typename Accessor>
     void evaluate_aux(Values &values, const Accessor &accessor);
 public:
@@ -0,0 +1,160 @@
+#include "batch_evaluator.h"
+
+#include "evaluator.h"
+#include "heuristic.h"
+#include "search_statistics.h"
+
+#include "parser/abstract_syntax_tree.h"
+#include "parser/decorated_abstract_syntax_tree.h"
+#include "parser/lexical_analyzer.h"
+#include "parser/syntax_analyzer.h"
+#include "plugins/plugin.h"
+#include "utils/memory.h"
+
+#include <cassert>
+#include <set>
+
+using namespace std;
+
+shared_ptr<Evaluator> copy_evaluator(const Evaluator &evaluator) {
+    parser::TokenStream tokens = parser::split_tokens(
+        evaluator.get_description());
+    parser::ASTNodePtr parsed = parser::parse(tokens);
+    parser::DecoratedASTNodePtr decorated = parsed->decorate();
+    parser::ConstructContext context;
+    plugins::Any constructed = decorated->construct(context);
+    return plugins::any_cast<shared_ptr<Evaluator>>(constructed);
+}
+
+BatchEvaluator::BatchEvaluator(int num_threads, const utils::LogProxy &log)
+    : log(log),
+      thread_pool(num_threads),
+      initialized(false),
+      copies(num_threads - 1) {
+}
+
+void BatchEvaluator::initialize(EvaluationContext &eval_context) {
+    assert(!initialized);
+    initialized = true;
+    set<Evaluator *> candidates;
+    eval_context.get_cache().for_each_evaluator_result(
+        [&](const Evaluator *eval, const EvaluationResult &) {
+            candidates.insert(const_cast<Evaluator *>(eval));
+        });
+
+    for (Evaluator *evaluator : candidates) {
+        // Only heuristics are worth the overhead of copying.
+        Heuristic *heuristic = dynamic_cast<Heuristic *>(evaluator);
+        if (!heuristic)
+            continue;
+        set<Evaluator *> path_dependent_evaluators;
+        heuristic->get_path_dependent_evaluators(path_dependent_evaluators);
+        if (!path_dependent_evaluators.empty())
+            continue;
+
+        vector<shared_ptr<Evaluator>> heuristic_copies;
+        try {
+            for (size_t i = 0; i < copies.size(); ++i) {
+                heuristic_copies.push_back(copy_evaluator(*heuristic));
+            }
+        } catch (const utils::ContextError &) {
+            log << "Cannot copy " << heuristic->get_description()
+                << ", evaluating it on one thread." << endl;
+            continue;
+        } catch (const plugins::BadAnyCast &) {
+            continue;
+        }
+
+        /*
+          Evaluate the copies once on this thread, so that everything they
+          set up lazily (e.g., per-state information attached to the state
+          registry) exists before they are used concurrently.
+        */
+        for (const shared_ptr<Evaluator> &copy : heuristic_copies) {
+            EvaluationContext copy_context(
+                eval_context.get_state(), nullptr,
+                eval_context.get_calculate_preferred());
+            copy_context.get_result(copy.get());
+        }
+
+        heuristics.push_back(heuristic);
+        for (size_t i = 0; i < copies.size(); ++i) {
+            copies[i].push_back(heuristic_copies[i]);
+        }
+    }
+
+    log << "Evaluating " << heuristics.size() << " heuristic(s) on "
+        << get_num_threads() << " threads:";
+    for (Heuristic *heuristic : heuristics) {
+        log << " " << heuristic->get_description();
+    }
+    log << endl;
+}
+
+vector<EvaluationContext> BatchEvaluator::evaluate(
+    const vector<State> &states, SearchStatistics &statistics) {
+    assert(initialized);
+    vector<EvaluationContext> contexts;
+    contexts.reserve(states.size());
+    for (const State &state : states) {
+        contexts.emplace_back(state);
+    }
+    if (heuristics.empty())
+        return contexts;
+
+    thread_pool.run(
+        states.size(),
+        [&](int i, int thread_id) {
+            EvaluationContext &eval_context = contexts[i];
+            if (thread_id == 0) {
+                for (Heuristic *heuristic : heuristics) {
+                    eval_context.get_result(heuristic);
+                }
+            } else {
+                const vector<shared_ptr<Evaluator>> &thread_copies =
+                    copies[thread_id - 1];
+                EvaluationContext copy_context(eval_context.get_state());
+                for (size_t j = 0; j < heuristics.size(); ++j) {
+                    eval_context.set_result(
+                        heuristics[j],
+                        copy_context.get_result(thread_copies[j].get()));
+                }
+            }
+        });
+
+    for (EvaluationContext &eval_context : contexts) {
+        for (Heuristic *heuristic : heuristics) {
+            const EvaluationResult &result = eval_context.get_result(heuristic);
+            if (!result.get_count_evaluation())
+                continue;
+            /*
+              Results with counted evaluations have been computed rather
+              than looked up, so the heuristic has not cached them if they
+              come from a copy. Caching them twice does no harm.
+            */
+            heuristic->set_cached_estimate(
+                eval_context.get_state(), result.get_evaluator_value());
+            if (heuristic->is_used_for_counting_evaluations())
+                statistics.inc_evaluations();
+        }
+    }
+    return contexts;
+}
+
+unique_ptr<BatchEvaluator> create_batch_evaluator(
+    const plugins::Options &opts, const utils::LogProxy &log) {
+    int num_threads = opts.get<int>("evaluation_threads", 1);
+    if (num_threads <= 1)
+        return nullptr;
+    return utils::make_unique_ptr<BatchEvaluator>(num_threads, log);
+}
+
+void add_batch_evaluation_option_to_feature(plugins::Feature &feature) {
+    feature.add_option<int>(
+        "evaluation_threads",
+        "number of threads for computing the heuristic values of the "
+        "successor states. With more than one thread, each thread uses its "
+        "own copy of the heuristics.",
+        "1",
+        plugins::Bounds("1", "infinity"));
+}
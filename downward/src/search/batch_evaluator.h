@@ -0,0 +1,80 @@
+#ifndef BATCH_EVALUATOR_H
+#define BATCH_EVALUATOR_H
+
+#include "evaluation_context.h"
+
+#include "utils/logging.h"
+#include "utils/thread_pool.h"
+
+#include <memory>
+#include <vector>
+
+class Heuristic;
+class SearchStatistics;
+
+namespace plugins {
+class Feature;
+class Options;
+}
+
+/*
+  Computes the heuristic values of a batch of states on several threads.
+
+  Evaluators are not thread-safe, so every thread except the calling one
+  uses its own copies of the heuristics. The copies are constructed from the
+  descriptions of the heuristics (i.e., their configuration strings).
+  Heuristics that cannot be copied this way (e.g., because their
+  configuration refers to a predefined evaluator) and path-dependent
+  heuristics are evaluated later, by the search, on the calling thread.
+
+  Search engines call initialize() with the evaluation context of the initial
+  state: the heuristics that were evaluated in it are the ones computed in
+  parallel afterwards. evaluate() returns one evaluation context per state
+  whose cache holds the results of these heuristics. The search then creates
+  its own contexts from them, so the values are not computed again and the
+  order of insertions into the open list does not depend on the threads.
+  Values computed by copies are also stored in the estimate cache of the
+  original heuristic.
+*/
+class BatchEvaluator {
+    utils::LogProxy log;
+    utils::ThreadPool thread_pool;
+    bool initialized;
+    std::vector<Heuristic *> heuristics;
+    // copies[i][j] is the copy of heuristics[j] used by thread i + 1.
+    std::vector<std::vector<std::shared_ptr<Evaluator>>> copies;
+
+public:
+    BatchEvaluator(int num_threads, const utils::LogProxy &log);
+
+    void initialize(EvaluationContext &eval_context);
+    bool is_initialized() const {
+        return initialized;
+    }
+
+    int get_num_threads() const {
+        return thread_pool.get_num_threads();
+    }
+
+    std::vector<EvaluationContext> evaluate(
+        const std::vector<State> &states, SearchStatistics &statistics);
+};
+
+/*
+  Construct a new evaluator from the description (i.e., the configuration
+  string) of the given one. Throws utils::ContextError if the description
+  cannot be parsed on its own, e.g., because it refers to a predefined
+  evaluator, and plugins::BadAnyCast if it does not describe an evaluator.
+*/
+extern std::shared_ptr<Evaluator> copy_evaluator(const Evaluator &evaluator);
+
+/*
+  Create a batch evaluator if the option "evaluation_threads" asks for more
+  than one thread and return nullptr otherwise.
+*/
+extern std::unique_ptr<BatchEvaluator> create_batch_evaluator(
+    const plugins::Options &opts, const utils::LogProxy &log);
+
+extern void add_batch_evaluation_option_to_feature(plugins::Feature &feature);
+
+#endif
@@ -127,6 +127,11 @@ public:
             "true");
         Heuristic::add_options_to_feature(*this);
         utils::add_rng_options(*this);
+        /*
+          The cost partitioning ignores abstract states that are unreachable
+          from the initial state.
+        */
+        set_depends_on_initial_state();
 
         document_language_support("action costs", "supported");
         document_language_support("conditional effects", "not supported");
@@ -80,7 +80,8 @@ static vector<string> replace_old_style_predefinitions(const vector<string> &arg
     return new_args;
 }
 
-static shared_ptr<SearchEngine> parse_cmd_line_aux(const vector<string> &args) {
+static shared_ptr<SearchEngine> parse_cmd_line_aux(
+    const vector<string> &args, const shared_ptr<parser::LetCache> &let_cache) {
     string plan_filename = "sas_plan";
     int num_previously_generated_plans = 0;
     bool is_part_of_anytime_portfolio = false;
@@ -102,7 +103,9 @@ static shared_ptr<SearchEngine> parse_cmd_line_aux(const vector<string> &args) {
                 parser::TokenStream tokens = parser::split_tokens(search_arg);
                 parser::ASTNodePtr parsed = parser::parse(tokens);
                 parser::DecoratedASTNodePtr decorated = parsed->decorate();
-                plugins::Any constructed = decorated->construct();
+                parser::ConstructContext context(let_cache);
+                utils::TraceBlock block(context, "Constructing parsed object");
+                plugins::Any constructed = decorated->construct(context);
                 engine = plugins::any_cast<SearchPtr>(constructed);
             } catch (const utils::ContextError &e) {
                 input_error(e.get_message());
@@ -165,11 +168,16 @@ static shared_ptr<SearchEngine> parse_cmd_line_aux(const vector<string> &args) {
 
 shared_ptr<SearchEngine> parse_cmd_line(
     int argc, const char **argv, bool is_unit_cost) {
+    return parse_cmd_line(
+        vector<string>(argv + 1, argv + argc), is_unit_cost, nullptr);
+}
+
+shared_ptr<SearchEngine> parse_cmd_line(
+    const vector<string> &all_args, bool is_unit_cost,
+    const shared_ptr<parser::LetCache> &let_cache) {
     vector<string> args;
     bool active = true;
-    for (int i = 1; i < argc; ++i) {
-        string arg = argv[i];
-
+    for (const string &arg : all_args) {
         if (arg == "--if-unit-cost") {
             active = is_unit_cost;
         } else if (arg == "--if-non-unit-cost") {
@@ -181,7 +189,7 @@ shared_ptr<SearchEngine> parse_cmd_line(
         }
     }
     args = replace_old_style_predefinitions(args);
-    return parse_cmd_line_aux(args);
+    return parse_cmd_line_aux(args, let_cache);
 }
 
 
@@ -194,6 +202,11 @@ string usage(const string &progname) {
            "--help [NAME]\n"
            "    Prints help for all heuristics, open lists, etc. called NAME.\n"
            "    Without parameter: prints help for everything available\n"
+           "--server\n"
+           "    Reads the translator output and then a stream of queries from\n"
+           "    stdin, each one with an initial state and a search\n"
+           "    configuration, and writes the plans to stdout (see\n"
+           "    planner_server.h)\n"
            "--internal-plan-file FILENAME\n"
            "    Plan will be output to a file called FILENAME\n\n"
            "--internal-previous-portfolio-plans COUNTER\n"
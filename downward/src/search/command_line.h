@@ -1,14 +1,28 @@
 #ifndef COMMAND_LINE_H
 #define COMMAND_LINE_H
 
+#include "parser/decorated_abstract_syntax_tree.h"
+
 #include <memory>
 #include <string>
+#include <vector>
 
 class SearchEngine;
 
 extern std::shared_ptr<SearchEngine> parse_cmd_line(
     int argc, const char **argv, bool is_unit_cost);
 
+/*
+  Same as above for the arguments args (without the program name). If
+  let_cache is given, the values of the predefinitions (--evaluator,
+  --landmarks, ...) are taken from it if they are there and added to it
+  otherwise, i.e., engines parsed from the same arguments with the same cache
+  share their evaluators.
+*/
+extern std::shared_ptr<SearchEngine> parse_cmd_line(
+    const std::vector<std::string> &args, bool is_unit_cost,
+    const std::shared_ptr<parser::LetCache> &let_cache);
+
 extern std::string usage(const std::string &progname);
 
 #endif
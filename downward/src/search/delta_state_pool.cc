@@ -0,0 +1,153 @@
+#include "delta_state_pool.h"
+
+#include "task_proxy.h"
+
+#include "task_utils/task_properties.h"
+#include "utils/logging.h"
+
+#include <algorithm>
+#include <cassert>
+
+using namespace std;
+
+DeltaStatePool::DeltaStatePool(
+    const TaskProxy &task_proxy, const int_packer::IntPacker &state_packer,
+    int max_delta_depth, int cache_size)
+    : task_proxy(task_proxy),
+      state_packer(state_packer),
+      state_size(state_packer.get_num_bins()),
+      max_delta_depth(max_delta_depth),
+      full_states(state_size),
+      cache(cache_size),
+      decoding_buffer(state_size),
+      parent_buffer(state_size),
+      num_lookups(0),
+      num_cache_misses(0) {
+    assert(max_delta_depth >= 1 && max_delta_depth <= MAX_DELTA_DEPTH);
+    assert(cache_size >= 1);
+    assert(!task_properties::has_axioms(task_proxy));
+}
+
+bool DeltaStatePool::is_worth_compressing(
+    const TaskProxy &task_proxy, const int_packer::IntPacker &state_packer) {
+    size_t delta_size = sizeof(Entry) + sizeof(uint8_t);
+    size_t state_size = state_packer.get_num_bins() * sizeof(PackedStateBin);
+    return delta_size < state_size && !task_properties::has_axioms(task_proxy);
+}
+
+DeltaStatePool::CacheEntry &DeltaStatePool::get_cache_entry(int id) const {
+    return cache[id % cache.size()];
+}
+
+void DeltaStatePool::add_to_cache(int id, const PackedStateBin *data) const {
+    CacheEntry &entry = get_cache_entry(id);
+    entry.id = id;
+    // Reuse the buffer unless a state still refers to it.
+    if (!entry.data || entry.data.use_count() > 1)
+        entry.data = make_shared<Buffer>(state_size);
+    copy(data, data + state_size, entry.data->begin());
+}
+
+void DeltaStatePool::apply_operator(
+    const PackedStateBin *parent_data, const OperatorProxy &op,
+    PackedStateBin *data) const {
+    copy(parent_data, parent_data + state_size, data);
+    for (EffectProxy effect : op.get_effects()) {
+        bool fires = true;
+        for (FactProxy condition : effect.get_conditions()) {
+            FactPair condition_pair = condition.get_pair();
+            if (state_packer.get(parent_data, condition_pair.var) !=
+                condition_pair.value) {
+                fires = false;
+                break;
+            }
+        }
+        if (fires) {
+            FactPair effect_pair = effect.get_fact().get_pair();
+            state_packer.set(data, effect_pair.var, effect_pair.value);
+        }
+    }
+}
+
+void DeltaStatePool::push_back(const PackedStateBin *data) {
+    entries.push_back(Entry(full_states.size(), -1));
+    depths.push_back(0);
+    full_states.push_back(data);
+    add_to_cache(entries.size() - 1, data);
+}
+
+void DeltaStatePool::push_back(
+    const PackedStateBin *data, int parent_id, int op_id) {
+    assert(parent_id >= 0 && parent_id < static_cast<int>(size()));
+    int depth = depths[parent_id] + 1;
+    if (depth > max_delta_depth) {
+        push_back(data);
+        return;
+    }
+    entries.push_back(Entry(parent_id, op_id));
+    depths.push_back(depth);
+    add_to_cache(entries.size() - 1, data);
+}
+
+void DeltaStatePool::pop_back() {
+    int id = entries.size() - 1;
+    if (is_full_state(id)) {
+        assert(entries[id].reference ==
+               static_cast<int>(full_states.size()) - 1);
+        full_states.pop_back();
+    }
+    entries.pop_back();
+    depths.pop_back();
+    CacheEntry &entry = get_cache_entry(id);
+    if (entry.id == id)
+        entry.id = -1;
+}
+
+shared_ptr<const vector<PackedStateBin>> DeltaStatePool::lookup(int id) const {
+    ++num_lookups;
+    CacheEntry &entry = get_cache_entry(id);
+    if (entry.id == id)
+        return entry.data;
+    ++num_cache_misses;
+
+    // Collect the deltas up to a cached state or a state stored in full.
+    vector<int> chain;
+    int current = id;
+    while (true) {
+        const CacheEntry &current_entry = get_cache_entry(current);
+        if (current_entry.id == current) {
+            copy(current_entry.data->begin(), current_entry.data->end(),
+                 decoding_buffer.begin());
+            break;
+        } else if (is_full_state(current)) {
+            const PackedStateBin *data = full_states[entries[current].reference];
+            copy(data, data + state_size, decoding_buffer.begin());
+            break;
+        }
+        chain.push_back(current);
+        current = entries[current].reference;
+    }
+
+    OperatorsProxy operators = task_proxy.get_operators();
+    for (auto it = chain.rbegin(); it != chain.rend(); ++it) {
+        parent_buffer.swap(decoding_buffer);
+        apply_operator(parent_buffer.data(), operators[entries[*it].op_id],
+                       decoding_buffer.data());
+    }
+    add_to_cache(id, decoding_buffer.data());
+    return entry.data;
+}
+
+void DeltaStatePool::print_statistics(utils::LogProxy &log) const {
+    size_t num_deltas = entries.size() - full_states.size();
+    size_t bytes = entries.size() * (sizeof(Entry) + sizeof(uint8_t)) +
+        full_states.size() * state_size * sizeof(PackedStateBin);
+    size_t uncompressed_bytes =
+        entries.size() * state_size * sizeof(PackedStateBin);
+    log << "States stored as deltas: " << num_deltas << "/" << entries.size()
+        << endl;
+    log << "Compressed state data: " << bytes << " bytes (uncompressed: "
+        << uncompressed_bytes << " bytes)" << endl;
+    log << "Decoded state cache misses: " << num_cache_misses << "/"
+        << num_lookups << endl;
+}
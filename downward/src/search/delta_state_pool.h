@@ -0,0 +1,121 @@
+#ifndef DELTA_STATE_POOL_H
+#define DELTA_STATE_POOL_H
+
+#include "algorithms/int_packer.h"
+#include "algorithms/segmented_vector.h"
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+class OperatorProxy;
+class TaskProxy;
+
+namespace utils {
+class LogProxy;
+}
+
+using PackedStateBin = int_packer::IntPacker::Bin;
+
+/*
+  Compressed storage for the packed data of the states of a StateRegistry.
+
+  Most states are stored as a delta to their parent state, i.e., as the ID
+  of the parent together with the ID of the operator that leads from the
+  parent to the state. This needs 9 bytes per state, independently of the
+  size of the state. Decoding a state applies the operators along the
+  chain of deltas that leads to it from a state that is stored in full or
+  cached. A state is stored in full if this chain would become longer than
+  max_delta_depth, so this parameter trades memory for time.
+
+  Since decoding does not evaluate axioms, the pool can only be used for
+  tasks without axioms.
+
+  The cache of recently decoded states is direct-mapped by state ID, which
+  is cheaper than a least-recently-used policy and works well because
+  searches mostly look up states that were generated or expanded recently.
+  Decoded states are returned as shared pointers so that they stay valid
+  when they are evicted from the cache.
+*/
+class DeltaStatePool {
+    using Buffer = std::vector<PackedStateBin>;
+
+    const TaskProxy &task_proxy;
+    const int_packer::IntPacker &state_packer;
+    const int state_size;
+    const int max_delta_depth;
+
+    struct Entry {
+        /*
+          For deltas, reference is the ID of the parent and op_id the ID of
+          the operator. For states stored in full, reference is the index in
+          full_states and op_id is -1.
+        */
+        int reference;
+        int op_id;
+
+        Entry(int reference, int op_id)
+            : reference(reference), op_id(op_id) {
+        }
+    };
+    segmented_vector::SegmentedVector<Entry> entries;
+    // Length of the chain of deltas leading to each state.
+    segmented_vector::SegmentedVector<std::uint8_t> depths;
+    segmented_vector::SegmentedArrayVector<PackedStateBin> full_states;
+
+    struct CacheEntry {
+        int id;
+        std::shared_ptr<Buffer> data;
+        CacheEntry()
+            : id(-1) {
+        }
+    };
+    mutable std::vector<CacheEntry> cache;
+    mutable Buffer decoding_buffer;
+    mutable Buffer parent_buffer;
+
+    mutable long long num_lookups;
+    mutable long long num_cache_misses;
+
+    bool is_full_state(int id) const {
+        return entries[id].op_id == -1;
+    }
+    CacheEntry &get_cache_entry(int id) const;
+    void add_to_cache(int id, const PackedStateBin *data) const;
+    void apply_operator(
+        const PackedStateBin *parent_data, const OperatorProxy &op,
+        PackedStateBin *data) const;
+
+public:
+    static const int MAX_DELTA_DEPTH = 255;
+
+    DeltaStatePool(
+        const TaskProxy &task_proxy, const int_packer::IntPacker &state_packer,
+        int max_delta_depth, int cache_size);
+
+    /*
+      Return true if deltas need less memory than the states of the task
+      and the pool supports the task.
+    */
+    static bool is_worth_compressing(
+        const TaskProxy &task_proxy, const int_packer::IntPacker &state_packer);
+
+    // Store data in full.
+    void push_back(const PackedStateBin *data);
+    /*
+      Store data, which must be the result of applying the operator with ID
+      op_id to the (already stored) parent, as a delta if possible.
+    */
+    void push_back(const PackedStateBin *data, int parent_id, int op_id);
+    void pop_back();
+
+    std::size_t size() const {
+        return entries.size();
+    }
+
+    std::shared_ptr<const Buffer> lookup(int id) const;
+
+    void print_statistics(utils::LogProxy &log) const;
+};
+
+#endif
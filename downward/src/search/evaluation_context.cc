@@ -55,6 +55,11 @@ const EvaluationResult &EvaluationContext::get_result(Evaluator *evaluator) {
     return result;
 }
 
+void EvaluationContext::set_result(
+    Evaluator *evaluator, const EvaluationResult &result) {
+    cache[evaluator] = result;
+}
+
 const EvaluatorCache &EvaluationContext::get_cache() const {
     return cache;
 }
@@ -89,6 +89,11 @@ public:
         SearchStatistics *statistics = nullptr, bool calculate_preferred = false);
 
     const EvaluationResult &get_result(Evaluator *eval);
+    /*
+      Store a result for eval that was computed elsewhere, e.g., by a copy of
+      eval on another thread (see BatchEvaluator).
+    */
+    void set_result(Evaluator *eval, const EvaluationResult &result);
     const EvaluatorCache &get_cache() const;
     const State &get_state() const;
     int get_g_value() const;
@@ -107,3 +107,10 @@ int Heuristic::get_cached_estimate(const State &state) const {
     assert(is_estimate_cached(state));
     return heuristic_cache[state].h;
 }
+
+void Heuristic::set_cached_estimate(const State &state, int value) {
+    if (cache_evaluator_values) {
+        int h = (value == EvaluationResult::INFTY) ? DEAD_END : value;
+        heuristic_cache[state] = HEntry(h, false);
+    }
+}
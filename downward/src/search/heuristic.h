@@ -88,6 +88,13 @@ public:
     virtual bool does_cache_estimates() const override;
     virtual bool is_estimate_cached(const State &state) const override;
     virtual int get_cached_estimate(const State &state) const override;
+
+    /*
+      Store the estimate for state computed by another instance of this
+      heuristic (see BatchEvaluator). Does nothing if estimates are not
+      cached.
+    */
+    void set_cached_estimate(const State &state, int value);
 };
 
 #endif
@@ -288,6 +288,8 @@ void LandmarkFactory::generate_operators_lookups(const TaskProxy &task_proxy) {
 
 void add_landmark_factory_options_to_feature(plugins::Feature &feature) {
     utils::add_log_options_to_feature(feature);
+    // Landmarks are computed for the initial state.
+    feature.set_depends_on_initial_state();
 }
 
 void add_use_orders_option_to_feature(plugins::Feature &feature) {
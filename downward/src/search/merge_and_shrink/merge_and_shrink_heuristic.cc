@@ -173,6 +173,8 @@ public:
 
         Heuristic::add_options_to_feature(*this);
         add_merge_and_shrink_algorithm_options_to_feature(*this);
+        // Pruning removes the states that are unreachable from the initial state.
+        set_depends_on_initial_state();
 
         document_note(
             "Note",
@@ -16,13 +16,24 @@
 using namespace std;
 
 namespace parser {
+/*
+  The registry can only be constructed once per process because it registers
+  its types globally, so it is shared by all decorations (e.g., the planner
+  server decorates the configuration of every query).
+*/
+static const plugins::Registry &get_shared_registry() {
+    static const plugins::Registry registry =
+        plugins::RawRegistry::instance()->construct_registry();
+    return registry;
+}
+
 class DecorateContext : public utils::Context {
-    const plugins::Registry registry;
+    const plugins::Registry &registry;
     unordered_map<string, const plugins::Type *> variables;
 
 public:
     DecorateContext()
-        : registry(plugins::RawRegistry::instance()->construct_registry()) {
+        : registry(get_shared_registry()) {
     }
 
     void add_variable(const string &name, const plugins::Type &type) {
@@ -11,6 +11,10 @@
 using namespace std;
 
 namespace parser {
+ConstructContext::ConstructContext(const shared_ptr<LetCache> &let_cache)
+    : let_cache(let_cache) {
+}
+
 void ConstructContext::set_variable(const string &name, const plugins::Any &value) {
     variables[name] = value;
 }
@@ -28,6 +32,22 @@ plugins::Any ConstructContext::get_variable(const string &name) const {
     return variable;
 }
 
+const shared_ptr<LetCache> &ConstructContext::get_let_cache() const {
+    return let_cache;
+}
+
+void ConstructContext::set_variable_depends_on_initial_state(
+    const string &name, bool depends) {
+    if (depends)
+        initial_state_dependent_variables.insert(name);
+    else
+        initial_state_dependent_variables.erase(name);
+}
+
+const VariableNames &ConstructContext::get_initial_state_dependent_variables() const {
+    return initial_state_dependent_variables;
+}
+
 LazyValue::LazyValue(const DecoratedASTNode &node, const ConstructContext &context)
     : context(context), node(node.clone()) {
 }
@@ -71,6 +91,10 @@ plugins::Any DecoratedASTNode::construct() const {
     return construct(context);
 }
 
+bool DecoratedASTNode::depends_on_initial_state(const VariableNames &) const {
+    return false;
+}
+
 FunctionArgument::FunctionArgument(const string &key, DecoratedASTNodePtr value,
                                    bool lazy_construction)
     : key(key), value(move(value)), lazy_construction(lazy_construction) {
@@ -105,20 +129,42 @@ DecoratedLetNode::DecoratedLetNode(
 plugins::Any DecoratedLetNode::construct(ConstructContext &context) const {
     utils::TraceBlock block(context, "Constructing let-expression");
     plugins::Any variable_value;
-    {
+    bool variable_depends_on_initial_state =
+        variable_definition->depends_on_initial_state(
+            context.get_initial_state_dependent_variables());
+    shared_ptr<LetCache> let_cache = context.get_let_cache();
+    if (let_cache && let_cache->count(variable_name)) {
+        variable_value = let_cache->at(variable_name).value;
+    } else {
         utils::TraceBlock block(context, "Constructing variable '" + variable_name + "'");
         variable_value = variable_definition->construct(context);
+        if (let_cache)
+            (*let_cache)[variable_name] =
+                {variable_value, variable_depends_on_initial_state};
     }
     plugins::Any result;
     {
         utils::TraceBlock block(context, "Constructing nested value");
         context.set_variable(variable_name, variable_value);
+        context.set_variable_depends_on_initial_state(
+            variable_name, variable_depends_on_initial_state);
         result = nested_value->construct(context);
+        context.set_variable_depends_on_initial_state(variable_name, false);
         context.remove_variable(variable_name);
     }
     return result;
 }
 
+bool DecoratedLetNode::depends_on_initial_state(
+    const VariableNames &dependent_variables) const {
+    VariableNames nested_dependent_variables = dependent_variables;
+    if (variable_definition->depends_on_initial_state(dependent_variables))
+        nested_dependent_variables.insert(variable_name);
+    else
+        nested_dependent_variables.erase(variable_name);
+    return nested_value->depends_on_initial_state(nested_dependent_variables);
+}
+
 void DecoratedLetNode::dump(string indent) const {
     cout << indent << "LET:" << variable_name << " = " << endl;
     indent = "| " + indent;
@@ -149,6 +195,17 @@ plugins::Any DecoratedFunctionCallNode::construct(ConstructContext &context) con
     return feature->construct(opts, context);
 }
 
+bool DecoratedFunctionCallNode::depends_on_initial_state(
+    const VariableNames &dependent_variables) const {
+    if (feature->depends_on_initial_state())
+        return true;
+    for (const FunctionArgument &arg : arguments) {
+        if (arg.get_value().depends_on_initial_state(dependent_variables))
+            return true;
+    }
+    return false;
+}
+
 void DecoratedFunctionCallNode::dump(string indent) const {
     cout << indent << "FUNC:" << feature->get_title()
          << " (returns " << feature->get_type().name() << ")" << endl;
@@ -175,6 +232,15 @@ plugins::Any DecoratedListNode::construct(ConstructContext &context) const {
     return result;
 }
 
+bool DecoratedListNode::depends_on_initial_state(
+    const VariableNames &dependent_variables) const {
+    for (const DecoratedASTNodePtr &element : elements) {
+        if (element->depends_on_initial_state(dependent_variables))
+            return true;
+    }
+    return false;
+}
+
 void DecoratedListNode::dump(string indent) const {
     cout << indent << "LIST:" << endl;
     indent = "| " + indent;
@@ -195,6 +261,11 @@ plugins::Any VariableNode::construct(ConstructContext &context) const {
     return context.get_variable(name);
 }
 
+bool VariableNode::depends_on_initial_state(
+    const VariableNames &dependent_variables) const {
+    return dependent_variables.count(name);
+}
+
 void VariableNode::dump(string indent) const {
     cout << indent << "VAR: " << name << endl;
 }
@@ -331,6 +402,11 @@ plugins::Any ConvertNode::construct(ConstructContext &context) const {
     return converted_value;
 }
 
+bool ConvertNode::depends_on_initial_state(
+    const VariableNames &dependent_variables) const {
+    return value->depends_on_initial_state(dependent_variables);
+}
+
 void ConvertNode::dump(string indent) const {
     cout << indent << "CONVERT: "
          << from_type.name() << " to " << to_type.name() << endl;
@@ -393,6 +469,11 @@ plugins::Any CheckBoundsNode::construct(ConstructContext &context) const {
     return v;
 }
 
+bool CheckBoundsNode::depends_on_initial_state(
+    const VariableNames &dependent_variables) const {
+    return value->depends_on_initial_state(dependent_variables);
+}
+
 void CheckBoundsNode::dump(string indent) const {
     cout << indent << "CHECK-BOUNDS: " << endl;
     value->dump("| " + indent);
@@ -7,6 +7,8 @@
 
 #include <memory>
 #include <string>
+#include <unordered_map>
+#include <unordered_set>
 #include <vector>
 
 namespace plugins {
@@ -15,13 +17,37 @@ class Options;
 
 namespace parser {
 // TODO: if we can get rid of lazy values, this class could be moved to the cc file.
+/*
+  Values of let-variables that are kept across several constructions of the
+  same expression (see DecoratedLetNode::construct). The planner server uses
+  this to construct the predefined evaluators of a configuration only once.
+  Values that depend on the initial state (see
+  DecoratedASTNode::depends_on_initial_state) must be dropped when the
+  initial state changes.
+*/
+struct CachedLetValue {
+    plugins::Any value;
+    bool depends_on_initial_state;
+};
+using LetCache = std::unordered_map<std::string, CachedLetValue>;
+using VariableNames = std::unordered_set<std::string>;
+
 class ConstructContext : public utils::Context {
     std::unordered_map<std::string, plugins::Any> variables;
+    std::shared_ptr<LetCache> let_cache;
+    // Variables whose values depend on the initial state
+    VariableNames initial_state_dependent_variables;
 public:
+    ConstructContext() = default;
+    explicit ConstructContext(const std::shared_ptr<LetCache> &let_cache);
     void set_variable(const std::string &name, const plugins::Any &value);
     void remove_variable(const std::string &name);
     bool has_variable(const std::string &name) const;
     plugins::Any get_variable(const std::string &name) const;
+    const std::shared_ptr<LetCache> &get_let_cache() const;
+    void set_variable_depends_on_initial_state(
+        const std::string &name, bool depends);
+    const VariableNames &get_initial_state_dependent_variables() const;
 };
 
 class DecoratedASTNode {
@@ -30,6 +56,14 @@ public:
     plugins::Any construct() const;
     virtual plugins::Any construct(ConstructContext &context) const = 0;
     virtual void dump(std::string indent = "+") const = 0;
+    /*
+      Returns true if the constructed value contains a component whose
+      feature depends on the initial state (see
+      plugins::Feature::depends_on_initial_state) or one of the given
+      variables.
+    */
+    virtual bool depends_on_initial_state(
+        const VariableNames &dependent_variables) const;
 
     // TODO: This is here only for the iterated search. Once we switch to builders, we won't need it any more.
     virtual std::unique_ptr<DecoratedASTNode> clone() const = 0;
@@ -86,6 +120,8 @@ public:
 
     plugins::Any construct(ConstructContext &context) const override;
     void dump(std::string indent) const override;
+    bool depends_on_initial_state(
+        const VariableNames &dependent_variables) const override;
 
     // TODO: once we get rid of lazy construction, this should no longer be necessary.
     virtual std::unique_ptr<DecoratedASTNode> clone() const override;
@@ -105,6 +141,8 @@ public:
 
     plugins::Any construct(ConstructContext &context) const override;
     void dump(std::string indent) const override;
+    bool depends_on_initial_state(
+        const VariableNames &dependent_variables) const override;
 
     // TODO: once we get rid of lazy construction, this should no longer be necessary.
     virtual std::unique_ptr<DecoratedASTNode> clone() const override;
@@ -119,6 +157,8 @@ public:
 
     plugins::Any construct(ConstructContext &context) const override;
     void dump(std::string indent) const override;
+    bool depends_on_initial_state(
+        const VariableNames &dependent_variables) const override;
 
     // TODO: once we get rid of lazy construction, this should no longer be necessary.
     virtual std::unique_ptr<DecoratedASTNode> clone() const override;
@@ -136,6 +176,8 @@ public:
 
     plugins::Any construct(ConstructContext &context) const override;
     void dump(std::string indent) const override;
+    bool depends_on_initial_state(
+        const VariableNames &dependent_variables) const override;
 
     // TODO: once we get rid of lazy construction, this should no longer be necessary.
     virtual std::unique_ptr<DecoratedASTNode> clone() const override;
@@ -210,6 +252,8 @@ public:
 
     plugins::Any construct(ConstructContext &context) const override;
     void dump(std::string indent) const override;
+    bool depends_on_initial_state(
+        const VariableNames &dependent_variables) const override;
 
     // TODO: once we get rid of lazy construction, this should no longer be necessary.
     virtual std::unique_ptr<DecoratedASTNode> clone() const override;
@@ -227,6 +271,8 @@ public:
 
     plugins::Any construct(ConstructContext &context) const override;
     void dump(std::string indent) const override;
+    bool depends_on_initial_state(
+        const VariableNames &dependent_variables) const override;
 
     // TODO: once we get rid of lazy construction, this should no longer be necessary.
     virtual std::unique_ptr<DecoratedASTNode> clone() const override;
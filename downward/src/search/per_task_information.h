@@ -8,6 +8,7 @@
 #include "utils/memory.h"
 
 #include <functional>
+#include <mutex>
 
 /*
   A PerTaskInformation<T> acts like a HashMap<TaskID, T>
@@ -18,7 +19,16 @@
   (2) If a task is destroyed, its associated data in all PerTaskInformation
       objects is automatically destroyed as well.
 
+  Searches that run concurrently on several threads (see parallel_portfolio)
+  share the entries, so they must not be modified after their construction.
+  Accessing and creating entries is thread-safe. We use a single recursive
+  mutex for all PerTaskInformation objects because creating an entry can
+  access other PerTaskInformation objects (e.g., the successor generator
+  uses the state packer) and because all objects subscribe to the same
+  tasks.
 */
+inline std::recursive_mutex g_per_task_information_mutex;
+
 template<class Entry>
 class PerTaskInformation : public subscriber::Subscriber<AbstractTask> {
     /*
@@ -50,6 +60,7 @@ public:
     }
 
     Entry &operator[](const TaskProxy &task_proxy) {
+        std::lock_guard<std::recursive_mutex> lock(g_per_task_information_mutex);
         TaskID id = task_proxy.get_id();
         const auto &it = entries.find(id);
         if (it == entries.end()) {
@@ -60,6 +71,7 @@ public:
     }
 
     virtual void notify_service_destroyed(const AbstractTask *task) override {
+        std::lock_guard<std::recursive_mutex> lock(g_per_task_information_mutex);
         TaskID id = TaskProxy(*task).get_id();
         entries.erase(id);
     }
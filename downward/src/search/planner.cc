@@ -1,4 +1,5 @@
 #include "command_line.h"
+#include "planner_server.h"
 #include "search_engine.h"
 
 #include "tasks/root_task.h"
@@ -20,10 +21,23 @@ int main(int argc, const char **argv) {
         utils::exit_with(ExitCode::SEARCH_INPUT_ERROR);
     }
 
+    if (static_cast<string>(argv[1]) == "--server") {
+        /*
+          The log (which goes to cout) is redirected to cerr, so that stdout
+          only contains the results of the queries.
+        */
+        ostream results(cout.rdbuf());
+        cout.rdbuf(cerr.rdbuf());
+        run_planner_server(cin, results);
+        cout.rdbuf(results.rdbuf());
+        utils::report_exit_code_reentrant(ExitCode::SUCCESS);
+        return static_cast<int>(ExitCode::SUCCESS);
+    }
+
     bool unit_cost = false;
     if (static_cast<string>(argv[1]) != "--help") {
         utils::g_log << "reading input..." << endl;
-        tasks::read_root_task(cin);
+        tasks::read_root_task_from_stdin();
         utils::g_log << "done reading input!" << endl;
         TaskProxy task_proxy(*tasks::g_root_task);
         unit_cost = task_properties::is_unit_cost(task_proxy);
@@ -0,0 +1,210 @@
+#include "planner_server.h"
+
+#include "command_line.h"
+#include "plan_manager.h"
+#include "search_engine.h"
+
+#include "parser/decorated_abstract_syntax_tree.h"
+#include "tasks/root_task.h"
+#include "task_utils/task_properties.h"
+#include "utils/logging.h"
+#include "utils/system.h"
+#include "utils/timer.h"
+
+#include <iostream>
+#include <limits>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+using namespace std;
+using utils::ExitCode;
+
+namespace {
+struct Query {
+    vector<string> args;
+    vector<FactPair> facts;
+};
+
+/*
+  The let-expressions (predefinitions) constructed for a list of arguments
+  and the initial state the ones that depend on it were constructed for.
+*/
+struct LetCacheEntry {
+    vector<int> initial_state;
+    shared_ptr<parser::LetCache> let_cache;
+};
+
+void erase_initial_state_dependent_values(parser::LetCache &let_cache) {
+    for (auto it = let_cache.begin(); it != let_cache.end();) {
+        if (it->second.depends_on_initial_state)
+            it = let_cache.erase(it);
+        else
+            ++it;
+    }
+}
+
+NO_RETURN
+void query_error(const string &msg) {
+    cerr << "Invalid query: " << msg << endl;
+    utils::exit_with(ExitCode::SEARCH_INPUT_ERROR);
+}
+
+void skip_rest_of_line(istream &in) {
+    in.ignore(numeric_limits<streamsize>::max(), '\n');
+}
+
+int read_count(istream &in, const string &what) {
+    int count;
+    if (!(in >> count) || count < 0)
+        query_error("expected the number of " + what);
+    skip_rest_of_line(in);
+    return count;
+}
+
+/*
+  Reads the next query from in. Returns false at the end of the input or if
+  the next line is "quit".
+*/
+bool read_query(istream &in, Query &query) {
+    string line;
+    do {
+        if (!getline(in, line))
+            return false;
+    } while (line.empty());
+    if (line == "quit")
+        return false;
+    if (line != "begin_query")
+        query_error("expected 'begin_query', got '" + line + "'");
+
+    int num_args = read_count(in, "arguments");
+    query.args.resize(num_args);
+    for (string &arg : query.args) {
+        if (!getline(in, arg))
+            query_error("missing arguments");
+    }
+
+    int num_facts = read_count(in, "facts");
+    query.facts.clear();
+    for (int i = 0; i < num_facts; ++i) {
+        int var, value;
+        if (!(in >> var >> value))
+            query_error("expected a fact '<var> <value>'");
+        query.facts.emplace_back(var, value);
+        skip_rest_of_line(in);
+    }
+
+    if (!getline(in, line) || line != "end_query")
+        query_error("expected 'end_query'");
+    return true;
+}
+
+/*
+  Returns an error message if the facts of the query do not fit the task and
+  an empty string otherwise.
+*/
+string check_query_facts(const Query &query, const TaskProxy &task_proxy) {
+    VariablesProxy variables = task_proxy.get_variables();
+    int num_variables = variables.size();
+    for (const FactPair &fact : query.facts) {
+        if (fact.var < 0 || fact.var >= num_variables)
+            return "invalid variable " + to_string(fact.var);
+        if (fact.value < 0 ||
+            fact.value >= variables[fact.var].get_domain_size()) {
+            return "invalid value " + to_string(fact.value) +
+                   " for variable " + to_string(fact.var);
+        }
+    }
+    return "";
+}
+
+void write_invalid_result(ostream &results) {
+    results << "begin_result" << endl
+            << "invalid" << endl << -1 << endl << 0 << endl
+            << "end_result" << endl;
+}
+
+void write_result(
+    ostream &results, const SearchEngine &engine, const TaskProxy &task_proxy) {
+    results << "begin_result" << endl;
+    if (engine.found_solution()) {
+        const Plan &plan = engine.get_plan();
+        OperatorsProxy operators = task_proxy.get_operators();
+        results << "solved" << endl
+                << calculate_plan_cost(plan, task_proxy) << endl
+                << plan.size() << endl;
+        for (OperatorID op_id : plan) {
+            results << operators[op_id].get_name() << endl;
+        }
+    } else {
+        results << (engine.get_status() == TIMEOUT ? "timeout" : "unsolved")
+                << endl << -1 << endl << 0 << endl;
+    }
+    results << "end_result" << endl;
+}
+}
+
+void run_planner_server(istream &in, ostream &results) {
+    utils::g_log << "reading input..." << endl;
+    tasks::read_root_task(in);
+    utils::g_log << "done reading input!" << endl;
+    TaskProxy task_proxy(*tasks::g_root_task);
+    bool unit_cost = task_properties::is_unit_cost(task_proxy);
+    const vector<int> task_initial_state =
+        tasks::g_root_task->get_initial_state_values();
+
+    /*
+      Components built for one initial state can be wrong for another one
+      (e.g., landmark graphs), so we only reuse those for queries with the
+      same arguments and the same initial state. All other predefinitions
+      are reused for any query with the same arguments.
+    */
+    unordered_map<string, LetCacheEntry> let_caches;
+    Query query;
+    int num_queries = 0;
+    while (read_query(in, query)) {
+        ++num_queries;
+        string error = check_query_facts(query, task_proxy);
+        if (!error.empty()) {
+            cerr << "Invalid query #" << num_queries << ": " << error << endl;
+            write_invalid_result(results);
+            results.flush();
+            continue;
+        }
+        vector<int> initial_state = task_initial_state;
+        for (const FactPair &fact : query.facts) {
+            initial_state[fact.var] = fact.value;
+        }
+        tasks::set_root_task_initial_state(initial_state);
+
+        string key;
+        for (const string &arg : query.args) {
+            key += arg;
+            key += '\n';
+        }
+        LetCacheEntry &entry = let_caches[key];
+        if (!entry.let_cache) {
+            entry.let_cache = make_shared<parser::LetCache>();
+        } else if (entry.initial_state != initial_state) {
+            erase_initial_state_dependent_values(*entry.let_cache);
+        }
+        entry.initial_state = initial_state;
+        const shared_ptr<parser::LetCache> &let_cache = entry.let_cache;
+
+        utils::g_log << "Query #" << num_queries << endl;
+        utils::Timer search_timer;
+        shared_ptr<SearchEngine> engine =
+            parse_cmd_line(query.args, unit_cost, let_cache);
+        if (!engine)
+            query_error("no search engine (missing --search)");
+        engine->search();
+        search_timer.stop();
+        engine->print_statistics();
+        utils::g_log << "Search time: " << search_timer << endl;
+
+        write_result(results, *engine, task_proxy);
+        results.flush();
+    }
+    utils::g_log << "Answered " << num_queries << " queries" << endl;
+}
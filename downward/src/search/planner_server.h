@@ -0,0 +1,52 @@
+#ifndef PLANNER_SERVER_H
+#define PLANNER_SERVER_H
+
+#include <iosfwd>
+
+/*
+  Planner server ("downward --server"): reads the translator output once and
+  then answers a stream of queries, so that clients that need plans from many
+  initial states of the same task (e.g., the teacher of ASNets) do not pay for
+  starting the planner and reading the task for every state.
+
+  After the task, the input contains any number of queries of the form
+
+    begin_query
+    <number of arguments>
+    <argument>                     (one per line, as on the command line,
+    ...                             e.g., "--search" and "astar(lmcut())")
+    <number of facts>
+    <var> <value>                  (one per line)
+    ...
+    end_query
+
+  The initial state of the query is the initial state of the task where the
+  given facts replace the values of their variables. The answer to each query
+  is written to the results stream as
+
+    begin_result
+    <status>                       (solved, unsolved, timeout or invalid)
+    <plan cost>                    (-1 if no plan was found)
+    <plan length>
+    <operator name>                (one per line)
+    ...
+    end_result
+
+  The status is "invalid" if a fact of the query does not exist in the task.
+  The server stops at the end of the input or when it reads "quit".
+
+  The evaluators defined as predefinitions (--evaluator, --landmarks, ...)
+  are constructed for the first query with a given list of arguments and
+  reused by later queries with the same arguments, also if they have another
+  initial state. Only predefinitions that use a feature whose precomputation
+  is valid for one initial state only (landmark factories, and cegar and
+  merge_and_shrink, which ignore the abstract states that are unreachable
+  from the initial state) are constructed again when the initial state
+  changes. The other ones (e.g., pdb, cpdbs, hm, hmax, lmcut and the
+  potential heuristics) keep their precomputation; for potential heuristics
+  optimized for the initial state this only affects their accuracy, not
+  their admissibility.
+*/
+extern void run_planner_server(std::istream &in, std::ostream &results);
+
+#endif
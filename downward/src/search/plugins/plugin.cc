@@ -6,7 +6,7 @@ using namespace std;
 
 namespace plugins {
 Feature::Feature(const Type &type, const string &key)
-    : type(type), key(utils::tolower(key)) {
+    : type(type), key(utils::tolower(key)), initial_state_dependent(false) {
 }
 
 void Feature::document_subcategory(const string &subcategory) {
@@ -36,6 +36,14 @@ void Feature::document_note(
     notes.emplace_back(name, note, long_text);
 }
 
+void Feature::set_depends_on_initial_state() {
+    initial_state_dependent = true;
+}
+
+bool Feature::depends_on_initial_state() const {
+    return initial_state_dependent;
+}
+
 const Type &Feature::get_type() const {
     return type;
 }
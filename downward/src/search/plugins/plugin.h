@@ -29,6 +29,7 @@ class Feature {
     std::vector<PropertyInfo> properties;
     std::vector<LanguageSupportInfo> language_support;
     std::vector<NoteInfo> notes;
+    bool initial_state_dependent;
 public:
     Feature(const Type &type, const std::string &key);
     virtual ~Feature() = default;
@@ -63,6 +64,15 @@ public:
     void document_note(
         const std::string &title, const std::string &note, bool long_text = false);
 
+    /*
+      Declare that the constructed components are only valid for the
+      initial state of the task at construction time (e.g., landmark
+      graphs). The planner server constructs them again for queries with
+      another initial state.
+    */
+    void set_depends_on_initial_state();
+    bool depends_on_initial_state() const;
+
     const Type &get_type() const;
     std::string get_key() const;
     std::string get_title() const;
@@ -13,6 +13,7 @@
 #include "utils/system.h"
 #include "utils/timer.h"
 
+#include <algorithm>
 #include <cassert>
 #include <iostream>
 #include <limits>
@@ -47,7 +48,8 @@ SearchEngine::SearchEngine(const plugins::Options &opts)
       task(tasks::g_root_task),
       task_proxy(*task),
       log(utils::get_log_from_options(opts)),
-      state_registry(task_proxy),
+      state_registry(task_proxy, opts.get<int>("state_delta_depth", 0),
+                     opts.get<int>("decoded_state_cache_size", 1)),
       successor_generator(get_successor_generator(task_proxy, log)),
       search_space(state_registry, log),
       statistics(log),
@@ -60,6 +62,11 @@ SearchEngine::SearchEngine(const plugins::Options &opts)
     }
     bound = opts.get<int>("bound");
     task_properties::print_variable_statistics(task_proxy);
+    if (opts.get<int>("state_delta_depth", 0) > 0 &&
+        !state_registry.stores_deltas()) {
+        log << "Storing states in full because deltas would not be smaller "
+            << "or the task has axioms." << endl;
+    }
 }
 
 SearchEngine::~SearchEngine() {
@@ -81,6 +88,10 @@ const Plan &SearchEngine::get_plan() const {
 void SearchEngine::set_plan(const Plan &p) {
     solution_found = true;
     plan = p;
+    if (concurrent_search_info) {
+        concurrent_search_info->lower_bound(
+            calculate_plan_cost(plan, task_proxy));
+    }
 }
 
 void SearchEngine::search() {
@@ -93,6 +104,14 @@ void SearchEngine::search() {
             status = TIMEOUT;
             break;
         }
+        if (concurrent_search_info && status == IN_PROGRESS) {
+            if (concurrent_search_info->is_stop_requested()) {
+                log << "Search stopped by another search." << endl;
+                status = TIMEOUT;
+                break;
+            }
+            bound = min(bound, concurrent_search_info->get_bound());
+        }
     }
     // TODO: Revise when and which search times are logged.
     log << "Actual search time: " << timer.get_elapsed_time() << endl;
@@ -148,6 +167,22 @@ void SearchEngine::add_options_to_feature(plugins::Feature &feature) {
         "experiments. Timed-out searches are treated as failed searches, "
         "just like incomplete search algorithms that exhaust their search space.",
         "infinity");
+    feature.add_option<int>(
+        "state_delta_depth",
+        "store registered states as their parent state plus the operator "
+        "leading to them to save memory. A state is stored in full if more "
+        "than this number of operators would have to be applied to obtain "
+        "it. The default 0 stores all states in full. Larger values use less "
+        "memory but make looking up states slower. This is only done for "
+        "tasks without axioms whose states need more than 9 bytes.",
+        "0",
+        plugins::Bounds("0", to_string(DeltaStatePool::MAX_DELTA_DEPTH)));
+    feature.add_option<int>(
+        "decoded_state_cache_size",
+        "number of decoded states that are kept in memory if "
+        "state_delta_depth > 0",
+        "4096",
+        plugins::Bounds("1", "infinity"));
     utils::add_log_options_to_feature(feature);
 }
 
@@ -12,6 +12,8 @@
 
 #include "utils/logging.h"
 
+#include <atomic>
+#include <memory>
 #include <vector>
 
 namespace plugins {
@@ -30,6 +32,42 @@ class SuccessorGenerator;
 
 enum SearchStatus {IN_PROGRESS, TIMEOUT, FAILED, SOLVED};
 
+/*
+  Information shared by search engines that run concurrently on several
+  threads (see ParallelPortfolioSearch). After each step, an engine stops
+  (with status TIMEOUT) if another thread requested it, and lowers its bound
+  to the cost of the cheapest plan found by any engine so far. Engines
+  report the costs of their plans in set_plan().
+*/
+class ConcurrentSearchInfo {
+    std::atomic<bool> stop_requested;
+    std::atomic<int> bound;
+public:
+    explicit ConcurrentSearchInfo(int bound)
+        : stop_requested(false), bound(bound) {
+    }
+
+    void request_stop() {
+        stop_requested.store(true, std::memory_order_relaxed);
+    }
+
+    bool is_stop_requested() const {
+        return stop_requested.load(std::memory_order_relaxed);
+    }
+
+    void lower_bound(int new_bound) {
+        int old_bound = bound.load(std::memory_order_relaxed);
+        while (new_bound < old_bound &&
+               !bound.compare_exchange_weak(
+                   old_bound, new_bound, std::memory_order_relaxed)) {
+        }
+    }
+
+    int get_bound() const {
+        return bound.load(std::memory_order_relaxed);
+    }
+};
+
 class SearchEngine {
     std::string description;
     SearchStatus status;
@@ -52,6 +90,7 @@ protected:
     OperatorCost cost_type;
     bool is_unit_cost;
     double max_time;
+    std::shared_ptr<ConcurrentSearchInfo> concurrent_search_info;
 
     virtual void initialize() {}
     virtual SearchStatus step() = 0;
@@ -71,6 +110,10 @@ public:
     const SearchStatistics &get_statistics() const {return statistics;}
     void set_bound(int b) {bound = b;}
     int get_bound() {return bound;}
+    void set_concurrent_search_info(
+        const std::shared_ptr<ConcurrentSearchInfo> &info) {
+        concurrent_search_info = info;
+    }
     PlanManager &get_plan_manager() {return plan_manager;}
     std::string get_description() {return description;}
 
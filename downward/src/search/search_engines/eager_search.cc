@@ -1,5 +1,6 @@
 #include "eager_search.h"
 
+#include "../batch_evaluator.h"
 #include "../evaluation_context.h"
 #include "../evaluator.h"
 #include "../open_list_factory.h"
@@ -10,6 +11,7 @@
 #include "../task_utils/successor_generator.h"
 #include "../utils/logging.h"
 
+#include <algorithm>
 #include <cassert>
 #include <cstdlib>
 #include <memory>
@@ -27,11 +29,25 @@ EagerSearch::EagerSearch(const plugins::Options &opts)
       f_evaluator(opts.get<shared_ptr<Evaluator>>("f_eval", nullptr)),
       preferred_operator_evaluators(opts.get_list<shared_ptr<Evaluator>>("preferred")),
       lazy_evaluator(opts.get<shared_ptr<Evaluator>>("lazy_evaluator", nullptr)),
-      pruning_method(opts.get<shared_ptr<PruningMethod>>("pruning")) {
+      pruning_method(opts.get<shared_ptr<PruningMethod>>("pruning")),
+      batch_evaluator(create_batch_evaluator(opts, log)),
+      in_successor_batch(false) {
     if (lazy_evaluator && !lazy_evaluator->does_cache_estimates()) {
         cerr << "lazy_evaluator must cache its estimates" << endl;
         utils::exit_with(utils::ExitCode::SEARCH_INPUT_ERROR);
     }
+    /*
+      The copies of the heuristics used by other threads do not share the
+      cache of the lazy evaluator, so its cached estimates would be missing.
+    */
+    if (lazy_evaluator && batch_evaluator) {
+        cerr << "lazy_evaluator cannot be combined with evaluation_threads > 1"
+             << endl;
+        utils::exit_with(utils::ExitCode::SEARCH_INPUT_ERROR);
+    }
+}
+
+EagerSearch::~EagerSearch() {
 }
 
 void EagerSearch::initialize() {
@@ -98,6 +114,9 @@ void EagerSearch::initialize() {
 
     print_initial_evaluator_values(eval_context);
 
+    if (batch_evaluator)
+        batch_evaluator->initialize(eval_context);
+
     pruning_method->initialize(task);
 }
 
@@ -189,12 +208,22 @@ SearchStatus EagerSearch::step() {
                                     preferred_operators);
     }
 
-    for (OperatorID op_id : applicable_ops) {
+    vector<State> successors;
+    vector<EvaluationContext> batch_contexts;
+    vector<int> batch_indices;
+    if (batch_evaluator)
+        evaluate_successors_in_batch(
+            *node, applicable_ops, successors, batch_contexts, batch_indices);
+
+    for (size_t i = 0; i < applicable_ops.size(); ++i) {
+        OperatorID op_id = applicable_ops[i];
         OperatorProxy op = task_proxy.get_operators()[op_id];
         if ((node->get_real_g() + op.get_cost()) >= bound)
             continue;
 
-        State succ_state = state_registry.get_successor_state(s, op);
+        State succ_state = batch_evaluator
+            ? move(successors[i])
+            : state_registry.get_successor_state(s, op);
         statistics.inc_generated();
         bool is_preferred = preferred_operators.contains(op_id);
 
@@ -217,8 +246,12 @@ SearchStatus EagerSearch::step() {
             // TODO: Make this less fragile.
             int succ_g = node->get_g() + get_adjusted_cost(op);
 
-            EvaluationContext succ_eval_context(
-                succ_state, succ_g, is_preferred, &statistics);
+            EvaluationContext succ_eval_context =
+                (batch_evaluator && batch_indices[i] != -1)
+                ? EvaluationContext(batch_contexts[batch_indices[i]], succ_g,
+                                    is_preferred, &statistics)
+                : EvaluationContext(succ_state, succ_g, is_preferred,
+                                    &statistics);
             statistics.inc_evaluated_states();
 
             if (open_list->is_dead_end(succ_eval_context)) {
@@ -281,6 +314,49 @@ SearchStatus EagerSearch::step() {
     return IN_PROGRESS;
 }
 
+/*
+  Generate the successors of node and compute the heuristic values of the
+  new ones in parallel. Operators that exceed the bound are removed from
+  applicable_ops, and successors[i] is the successor for applicable_ops[i],
+  so step() does not generate the successors again. batch_indices[i] is the
+  position of the context for applicable_ops[i] in batch_contexts, or -1 if
+  the successor is not part of the batch. Like the main loop in step(), we
+  only consider the first operator leading to a successor.
+*/
+void EagerSearch::evaluate_successors_in_batch(
+    const SearchNode &node, vector<OperatorID> &applicable_ops,
+    vector<State> &successors, vector<EvaluationContext> &batch_contexts,
+    vector<int> &batch_indices) {
+    const State &s = node.get_state();
+    OperatorsProxy operators = task_proxy.get_operators();
+    applicable_ops.erase(
+        remove_if(applicable_ops.begin(), applicable_ops.end(),
+                  [&](OperatorID op_id) {
+                      return node.get_real_g() + operators[op_id].get_cost()
+                      >= bound;
+                  }),
+        applicable_ops.end());
+
+    vector<State> batch;
+    successors.reserve(applicable_ops.size());
+    batch_indices.assign(applicable_ops.size(), -1);
+    for (size_t i = 0; i < applicable_ops.size(); ++i) {
+        OperatorProxy op = operators[applicable_ops[i]];
+        successors.push_back(state_registry.get_successor_state(s, op));
+        const State &succ_state = successors.back();
+        SearchNode succ_node = search_space.get_node(succ_state);
+        if (succ_node.is_new() && !in_successor_batch[succ_state]) {
+            in_successor_batch[succ_state] = true;
+            batch_indices[i] = batch.size();
+            batch.push_back(succ_state);
+        }
+    }
+    for (const State &succ_state : batch) {
+        in_successor_batch[succ_state] = false;
+    }
+    batch_contexts = batch_evaluator->evaluate(batch, statistics);
+}
+
 void EagerSearch::reward_progress() {
     // Boost the "preferred operator" open lists somewhat whenever
     // one of the heuristics finds a state with a new best h value.
@@ -310,5 +386,6 @@ void EagerSearch::update_f_value_statistics(EvaluationContext &eval_context) {
 void add_options_to_feature(plugins::Feature &feature) {
     SearchEngine::add_pruning_option(feature);
     SearchEngine::add_options_to_feature(feature);
+    add_batch_evaluation_option_to_feature(feature);
 }
 }
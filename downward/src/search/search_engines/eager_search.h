@@ -2,11 +2,13 @@
 #define SEARCH_ENGINES_EAGER_SEARCH_H
 
 #include "../open_list.h"
+#include "../per_state_information.h"
 #include "../search_engine.h"
 
 #include <memory>
 #include <vector>
 
+class BatchEvaluator;
 class Evaluator;
 class PruningMethod;
 
@@ -27,6 +29,14 @@ class EagerSearch : public SearchEngine {
 
     std::shared_ptr<PruningMethod> pruning_method;
 
+    std::unique_ptr<BatchEvaluator> batch_evaluator;
+    PerStateInformation<bool> in_successor_batch;
+
+    void evaluate_successors_in_batch(
+        const SearchNode &node, std::vector<OperatorID> &applicable_ops,
+        std::vector<State> &successors,
+        std::vector<EvaluationContext> &batch_contexts,
+        std::vector<int> &batch_indices);
     void start_f_value_statistics(EvaluationContext &eval_context);
     void update_f_value_statistics(EvaluationContext &eval_context);
     void reward_progress();
@@ -37,7 +47,7 @@ protected:
 
 public:
     explicit EagerSearch(const plugins::Options &opts);
-    virtual ~EagerSearch() = default;
+    virtual ~EagerSearch() override;
 
     virtual void print_statistics() const override;
 
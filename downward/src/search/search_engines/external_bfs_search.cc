@@ -0,0 +1,542 @@
+#include "external_bfs_search.h"
+
+#include "../plugins/plugin.h"
+#include "../task_utils/successor_generator.h"
+#include "../task_utils/task_properties.h"
+#include "../utils/logging.h"
+#include "../utils/memory.h"
+#include "../utils/system.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cerrno>
+#include <cstring>
+#include <functional>
+#include <limits>
+#include <queue>
+
+#if OPERATING_SYSTEM == LINUX || OPERATING_SYSTEM == OSX
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+using namespace std;
+using utils::ExitCode;
+
+namespace external_bfs_search {
+/*
+  A layer record consists of the packed state, the index of the parent in
+  the previous layer (high and low half) and the ID of the operator.
+*/
+static const int NUM_EXTRA_BINS = 3;
+static const uint64_t NO_PARENT = numeric_limits<uint64_t>::max();
+
+// Number of bytes that are read before releasing them.
+static const size_t RELEASE_INTERVAL = size_t(64) << 20;
+// Number of bins that are buffered before writing them to a file.
+static const size_t WRITE_BUFFER_SIZE = size_t(1) << 14;
+/*
+  Runs are compacted into a single run when there are more than this many,
+  so that the number of open files stays bounded.
+*/
+static const size_t MAX_NUM_RUNS = 256;
+
+NO_RETURN
+static void file_error(const string &action) {
+    cerr << "external_bfs: could not " << action << ": " << strerror(errno)
+         << endl;
+    utils::exit_with(ExitCode::SEARCH_CRITICAL_ERROR);
+}
+
+#if OPERATING_SYSTEM == LINUX || OPERATING_SYSTEM == OSX
+/*
+  Temporary file of fixed-size records that is written sequentially and then
+  read through memory mappings. The file is removed from the directory right
+  after creating it, so it disappears when the planner exits.
+*/
+class RecordFile {
+    int fd;
+    const int record_size;
+    uint64_t num_records;
+    vector<PackedStateBin> write_buffer;
+
+    void flush() {
+        const char *data = reinterpret_cast<const char *>(write_buffer.data());
+        size_t remaining = write_buffer.size() * sizeof(PackedStateBin);
+        while (remaining > 0) {
+            ssize_t written = write(fd, data, remaining);
+            if (written < 0) {
+                if (errno == EINTR)
+                    continue;
+                file_error("write to a temporary file");
+            }
+            data += written;
+            remaining -= written;
+        }
+        write_buffer.clear();
+    }
+
+public:
+    explicit RecordFile(int record_size)
+        : record_size(record_size),
+          num_records(0) {
+        char name[] = "external_bfs.XXXXXX";
+        fd = mkstemp(name);
+        if (fd == -1)
+            file_error("create a temporary file in the working directory");
+        unlink(name);
+        write_buffer.reserve(WRITE_BUFFER_SIZE);
+    }
+
+    ~RecordFile() {
+        close(fd);
+    }
+
+    RecordFile(const RecordFile &) = delete;
+    RecordFile &operator=(const RecordFile &) = delete;
+
+    void append(const PackedStateBin *record) {
+        write_buffer.insert(write_buffer.end(), record, record + record_size);
+        ++num_records;
+        if (write_buffer.size() >= WRITE_BUFFER_SIZE)
+            flush();
+    }
+
+    // Must be called before mapping the file.
+    void finish() {
+        flush();
+    }
+
+    uint64_t size() const {
+        return num_records;
+    }
+
+    int get_record_size() const {
+        return record_size;
+    }
+
+    int get_fd() const {
+        return fd;
+    }
+};
+
+/*
+  Read-only mapping of a RecordFile. Sequential readers call release_before()
+  to tell the kernel that they do not need the pages they have read anymore,
+  so they do not accumulate in memory.
+*/
+class MappedRecords {
+    const PackedStateBin *data;
+    size_t length;
+    int record_size;
+    uint64_t num_records;
+    size_t released_bytes;
+
+public:
+    MappedRecords(const RecordFile &file, int advice)
+        : data(nullptr),
+          length(file.size() * file.get_record_size() * sizeof(PackedStateBin)),
+          record_size(file.get_record_size()),
+          num_records(file.size()),
+          released_bytes(0) {
+        if (length == 0)
+            return;
+        void *mapping = mmap(nullptr, length, PROT_READ, MAP_SHARED,
+                             file.get_fd(), 0);
+        if (mapping == MAP_FAILED)
+            file_error("map a temporary file");
+        madvise(mapping, length, advice);
+        data = static_cast<const PackedStateBin *>(mapping);
+    }
+
+    ~MappedRecords() {
+        if (data)
+            munmap(const_cast<PackedStateBin *>(data), length);
+    }
+
+    MappedRecords(const MappedRecords &) = delete;
+    MappedRecords &operator=(const MappedRecords &) = delete;
+
+    uint64_t size() const {
+        return num_records;
+    }
+
+    const PackedStateBin *operator[](uint64_t index) const {
+        assert(index < num_records);
+        return data + index * record_size;
+    }
+
+    void release_before(uint64_t index) {
+        static const size_t page_size = sysconf(_SC_PAGESIZE);
+        size_t offset = index * record_size * sizeof(PackedStateBin);
+        offset -= offset % page_size;
+        if (offset >= released_bytes + RELEASE_INTERVAL) {
+            char *start = const_cast<char *>(
+                reinterpret_cast<const char *>(data)) + released_bytes;
+            madvise(start, offset - released_bytes, MADV_DONTNEED);
+            released_bytes = offset;
+        }
+    }
+};
+#else
+class RecordFile {
+public:
+    explicit RecordFile(int) {
+        cerr << "external_bfs is not supported on this operating system."
+             << endl;
+        utils::exit_with(ExitCode::SEARCH_UNSUPPORTED);
+    }
+
+    void append(const PackedStateBin *) {}
+    void finish() {}
+    uint64_t size() const {return 0;}
+    int get_record_size() const {return 0;}
+};
+
+static const int MADV_SEQUENTIAL = 0;
+static const int MADV_RANDOM = 0;
+
+class MappedRecords {
+public:
+    MappedRecords(const RecordFile &, int) {}
+    uint64_t size() const {return 0;}
+    const PackedStateBin *operator[](uint64_t) const {return nullptr;}
+    void release_before(uint64_t) {}
+};
+#endif
+
+static uint64_t get_parent_index(const PackedStateBin *record, int state_size) {
+    return (uint64_t(record[state_size]) << 32) | record[state_size + 1];
+}
+
+static int get_operator_id(const PackedStateBin *record, int state_size) {
+    return record[state_size + 2];
+}
+
+/*
+  Cursor into a sorted run that is merged with the others. Runs are ordered
+  by their current records, so that a priority queue of cursors yields the
+  records of all runs in sorted order.
+*/
+struct RunCursor {
+    unique_ptr<MappedRecords> records;
+    uint64_t position;
+
+    explicit RunCursor(const RecordFile &file)
+        : records(utils::make_unique_ptr<MappedRecords>(file, MADV_SEQUENTIAL)),
+          position(0) {
+    }
+
+    const PackedStateBin *get_record() const {
+        return (*records)[position];
+    }
+};
+
+ExternalBFSSearch::ExternalBFSSearch(const plugins::Options &opts)
+    : SearchEngine(opts),
+      max_buffered_states(opts.get<int>("max_buffered_states")),
+      state_size(state_registry.get_state_packer().get_num_bins()),
+      record_size(state_size + NUM_EXTRA_BINS) {
+}
+
+ExternalBFSSearch::~ExternalBFSSearch() {
+}
+
+void ExternalBFSSearch::initialize() {
+    log << "Conducting breadth-first search with delayed duplicate detection "
+        << "in external memory" << endl;
+    const State &initial_state = state_registry.get_initial_state();
+    vector<PackedStateBin> record(record_size, 0);
+    copy(initial_state.get_buffer(), initial_state.get_buffer() + state_size,
+         record.begin());
+    record[state_size] = NO_PARENT >> 32;
+    record[state_size + 1] = NO_PARENT & 0xffffffff;
+    record[state_size + 2] = -1;
+
+    layers.push_back(utils::make_unique_ptr<RecordFile>(record_size));
+    layers.back()->append(record.data());
+    layers.back()->finish();
+    reached_states = utils::make_unique_ptr<RecordFile>(state_size);
+    reached_states->append(record.data());
+    reached_states->finish();
+
+    statistics.inc_evaluated_states();
+    if (is_goal(record.data())) {
+        log << "Solution found!" << endl;
+        set_plan(Plan());
+    }
+}
+
+bool ExternalBFSSearch::is_goal(const PackedStateBin *state_data) const {
+    const int_packer::IntPacker &state_packer = state_registry.get_state_packer();
+    for (FactProxy goal : task_proxy.get_goals()) {
+        FactPair fact = goal.get_pair();
+        if (state_packer.get(state_data, fact.var) != fact.value)
+            return false;
+    }
+    return true;
+}
+
+void ExternalBFSSearch::add_successor(
+    const PackedStateBin *state_data, uint64_t parent_index, int op_id) {
+    buffer.insert(buffer.end(), state_data, state_data + state_size);
+    buffer.push_back(parent_index >> 32);
+    buffer.push_back(parent_index & 0xffffffff);
+    buffer.push_back(op_id);
+    if (static_cast<int>(buffer.size() / record_size) >= max_buffered_states)
+        write_run();
+}
+
+/*
+  Sort the buffered records and write them to a new run, keeping only the
+  first record of each state. Records are compared lexicographically, so
+  for every state the record with the smallest parent index is kept.
+*/
+void ExternalBFSSearch::write_run() {
+    size_t num_records = buffer.size() / record_size;
+    vector<size_t> order(num_records);
+    for (size_t i = 0; i < num_records; ++i)
+        order[i] = i;
+    const PackedStateBin *data = buffer.data();
+    int size = record_size;
+    sort(order.begin(), order.end(),
+         [data, size](size_t lhs, size_t rhs) {
+             return lexicographical_compare(
+                 data + lhs * size, data + (lhs + 1) * size,
+                 data + rhs * size, data + (rhs + 1) * size);
+         });
+
+    runs.push_back(utils::make_unique_ptr<RecordFile>(record_size));
+    RecordFile &run = *runs.back();
+    const PackedStateBin *last_state = nullptr;
+    for (size_t index : order) {
+        const PackedStateBin *record = data + index * record_size;
+        if (!last_state || !equal(record, record + state_size, last_state)) {
+            run.append(record);
+            last_state = record;
+        }
+    }
+    run.finish();
+    buffer.clear();
+    if (runs.size() > MAX_NUM_RUNS)
+        compact_runs();
+}
+
+/*
+  Call visit for the first record of each state in the runs in sorted order
+  until it returns false.
+*/
+void ExternalBFSSearch::merge_sorted_runs(
+    const function<bool(const PackedStateBin *)> &visit) {
+    vector<RunCursor> cursors;
+    cursors.reserve(runs.size());
+    for (const unique_ptr<RecordFile> &run : runs) {
+        if (run->size() > 0)
+            cursors.emplace_back(*run);
+    }
+    int size = record_size;
+    auto greater = [&cursors, size](int lhs, int rhs) {
+            const PackedStateBin *lhs_record = cursors[lhs].get_record();
+            const PackedStateBin *rhs_record = cursors[rhs].get_record();
+            return lexicographical_compare(
+                rhs_record, rhs_record + size, lhs_record, lhs_record + size);
+        };
+    priority_queue<int, vector<int>, decltype(greater)> queue(greater);
+    for (size_t i = 0; i < cursors.size(); ++i)
+        queue.push(i);
+
+    vector<PackedStateBin> last_state;
+    while (!queue.empty()) {
+        int run_id = queue.top();
+        queue.pop();
+        RunCursor &cursor = cursors[run_id];
+        // The record stays mapped until the cursor is destroyed.
+        const PackedStateBin *record = cursor.get_record();
+        ++cursor.position;
+        if (cursor.position % 4096 == 0)
+            cursor.records->release_before(cursor.position);
+        if (cursor.position < cursor.records->size())
+            queue.push(run_id);
+
+        if (!last_state.empty() &&
+            equal(record, record + state_size, last_state.begin()))
+            continue;
+        last_state.assign(record, record + state_size);
+        if (!visit(record))
+            return;
+    }
+}
+
+void ExternalBFSSearch::compact_runs() {
+    auto compacted_run = utils::make_unique_ptr<RecordFile>(record_size);
+    merge_sorted_runs(
+        [&compacted_run](const PackedStateBin *record) {
+            compacted_run->append(record);
+            return true;
+        });
+    compacted_run->finish();
+    runs.clear();
+    runs.push_back(move(compacted_run));
+}
+
+/*
+  Merge the runs of the current layer with the states reached before. The
+  result is the next layer (all new states) and the updated file of reached
+  states. Both are sorted because all inputs are sorted.
+*/
+SearchStatus ExternalBFSSearch::merge_runs() {
+    if (!buffer.empty())
+        write_run();
+
+    MappedRecords reached(*reached_states, MADV_SEQUENTIAL);
+    uint64_t reached_position = 0;
+    auto new_layer = utils::make_unique_ptr<RecordFile>(record_size);
+    auto new_reached_states = utils::make_unique_ptr<RecordFile>(state_size);
+    bool solved = false;
+
+    merge_sorted_runs(
+        [&](const PackedStateBin *record) {
+            while (reached_position < reached.size() &&
+                   lexicographical_compare(
+                       reached[reached_position],
+                       reached[reached_position] + state_size,
+                       record, record + state_size)) {
+                new_reached_states->append(reached[reached_position]);
+                ++reached_position;
+                if (reached_position % 4096 == 0)
+                    reached.release_before(reached_position);
+            }
+            if (reached_position < reached.size() &&
+                equal(record, record + state_size, reached[reached_position]))
+                return true;
+
+            new_layer->append(record);
+            new_reached_states->append(record);
+            statistics.inc_evaluated_states();
+            if (is_goal(record)) {
+                log << "Solution found!" << endl;
+                extract_plan(get_parent_index(record, state_size),
+                             get_operator_id(record, state_size));
+                solved = true;
+                return false;
+            }
+            return true;
+        });
+    if (solved)
+        return SOLVED;
+
+    for (; reached_position < reached.size(); ++reached_position) {
+        new_reached_states->append(reached[reached_position]);
+    }
+    new_layer->finish();
+    new_reached_states->finish();
+    runs.clear();
+
+    log << "Layer " << layers.size() << ": " << new_layer->size()
+        << " new states, " << new_reached_states->size() << " reached"
+        << endl;
+    if (new_layer->size() == 0) {
+        log << "Completely explored state space -- no solution!" << endl;
+        return FAILED;
+    }
+    layers.push_back(move(new_layer));
+    reached_states = move(new_reached_states);
+    return IN_PROGRESS;
+}
+
+SearchStatus ExternalBFSSearch::step() {
+    if (found_solution())
+        return SOLVED;
+
+    const int_packer::IntPacker &state_packer = state_registry.get_state_packer();
+    int num_variables = task_proxy.get_variables().size();
+    OperatorsProxy operators = task_proxy.get_operators();
+    vector<OperatorID> applicable_ops;
+    vector<PackedStateBin> successor_data(state_size);
+
+    MappedRecords layer(*layers.back(), MADV_SEQUENTIAL);
+    for (uint64_t i = 0; i < layer.size(); ++i) {
+        const PackedStateBin *record = layer[i];
+        vector<int> values(num_variables);
+        for (int var = 0; var < num_variables; ++var)
+            values[var] = state_packer.get(record, var);
+        State state = task_proxy.create_state(move(values));
+        statistics.inc_expanded();
+
+        applicable_ops.clear();
+        successor_generator.generate_applicable_ops(state, applicable_ops);
+        for (OperatorID op_id : applicable_ops) {
+            OperatorProxy op = operators[op_id];
+            if (op.get_cost() >= bound)
+                continue;
+            State successor = state.get_unregistered_successor(op);
+            statistics.inc_generated();
+            fill(successor_data.begin(), successor_data.end(), 0);
+            for (int var = 0; var < num_variables; ++var)
+                state_packer.set(successor_data.data(), var,
+                                 successor[var].get_value());
+            add_successor(successor_data.data(), i, op_id.get_index());
+        }
+        if (i % 4096 == 0)
+            layer.release_before(i);
+    }
+    return merge_runs();
+}
+
+void ExternalBFSSearch::extract_plan(uint64_t parent_index, int op_id) {
+    Plan plan;
+    plan.push_back(OperatorID(op_id));
+    for (size_t layer_id = layers.size() - 1; layer_id > 0; --layer_id) {
+        MappedRecords layer(*layers[layer_id], MADV_RANDOM);
+        const PackedStateBin *record = layer[parent_index];
+        plan.push_back(OperatorID(get_operator_id(record, state_size)));
+        parent_index = get_parent_index(record, state_size);
+    }
+    reverse(plan.begin(), plan.end());
+    set_plan(plan);
+}
+
+void ExternalBFSSearch::print_statistics() const {
+    statistics.print_detailed_statistics();
+    log << "Number of layers: " << layers.size() << endl;
+}
+
+class ExternalBFSSearchFeature : public plugins::TypedFeature<SearchEngine, ExternalBFSSearch> {
+public:
+    ExternalBFSSearchFeature() : TypedFeature("external_bfs") {
+        document_title("Breadth-first search in external memory");
+        document_synopsis(
+            "Breadth-first search with delayed duplicate detection (Korf "
+            "2003) that stores the layers of the search in temporary files "
+            "in the working directory instead of memory. Duplicates are "
+            "removed by sorting the successors of each layer and merging "
+            "them with the sorted file of all states reached before. Its "
+            "memory usage does not grow with the number of states, so it can "
+            "explore state spaces that do not fit into memory as long as "
+            "they fit on disk. The search finds plans with the minimal number "
+            "of operators.");
+
+        add_option<int>(
+            "max_buffered_states",
+            "number of successor states that are collected in memory before "
+            "they are sorted and written to disk",
+            "1000000",
+            plugins::Bounds("1", "infinity"));
+        SearchEngine::add_options_to_feature(*this);
+
+        document_note(
+            "Bound",
+            "The search is not cost-aware: bound only prunes operators whose "
+            "own cost reaches the bound.");
+        document_language_support("action costs", "ignored");
+        document_language_support("conditional effects", "supported");
+        document_language_support("axioms", "supported");
+        document_property("admissible", "no (yes for unit-cost tasks)");
+        document_property("complete", "yes");
+        document_property("safe", "yes");
+        document_property("preferred operators", "no");
+    }
+};
+
+static plugins::FeaturePlugin<ExternalBFSSearchFeature> _plugin;
+}
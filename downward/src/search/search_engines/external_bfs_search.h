@@ -0,0 +1,74 @@
+#ifndef SEARCH_ENGINES_EXTERNAL_BFS_SEARCH_H
+#define SEARCH_ENGINES_EXTERNAL_BFS_SEARCH_H
+
+#include "../search_engine.h"
+
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <vector>
+
+namespace plugins {
+class Options;
+}
+
+namespace external_bfs_search {
+class RecordFile;
+
+/*
+  Breadth-first search with delayed duplicate detection (Korf 2003) that
+  keeps its state sets in files instead of memory.
+
+  Each layer of the search is a file of records (packed state, index of the
+  parent in the previous layer, operator) that is sorted by the packed
+  state. The successors of a layer are collected in a buffer of at most
+  max_buffered_states records. Whenever the buffer is full, it is sorted and
+  written to a run file. After the layer is expanded, the runs are merged
+  with the file of all previously reached states (also sorted), which
+  removes duplicates in a single sequential pass and produces the next
+  layer and the new file of reached states.
+
+  Files are read through memory mappings with sequential access hints, and
+  pages that have been read are released immediately, so the memory usage
+  only depends on max_buffered_states and not on the number of states. The
+  files are created in the working directory and deleted on exit.
+
+  The search only keeps the packed states and does not use the state
+  registry or the search space. It finds plans with the minimal number of
+  operators.
+*/
+class ExternalBFSSearch : public SearchEngine {
+    const int max_buffered_states;
+    const int state_size;
+    // Number of bins of a layer record.
+    const int record_size;
+
+    std::vector<std::unique_ptr<RecordFile>> layers;
+    std::unique_ptr<RecordFile> reached_states;
+
+    std::vector<PackedStateBin> buffer;
+    std::vector<std::unique_ptr<RecordFile>> runs;
+
+    void add_successor(
+        const PackedStateBin *state_data, uint64_t parent_index, int op_id);
+    void write_run();
+    void merge_sorted_runs(
+        const std::function<bool(const PackedStateBin *)> &visit);
+    void compact_runs();
+    SearchStatus merge_runs();
+    bool is_goal(const PackedStateBin *state_data) const;
+    void extract_plan(uint64_t parent_index, int op_id);
+
+protected:
+    virtual void initialize() override;
+    virtual SearchStatus step() override;
+
+public:
+    explicit ExternalBFSSearch(const plugins::Options &opts);
+    virtual ~ExternalBFSSearch() override;
+
+    virtual void print_statistics() const override;
+};
+}
+
+#endif
@@ -0,0 +1,541 @@
+#include "hda_astar_search.h"
+#include "search_common.h"
+
+#include "../evaluation_context.h"
+#include "../evaluator.h"
+#include "../open_list_factory.h"
+#include "../per_state_information.h"
+
+#include "../parser/decorated_abstract_syntax_tree.h"
+#include "../plugins/plugin.h"
+#include "../task_utils/successor_generator.h"
+#include "../task_utils/task_properties.h"
+#include "../utils/countdown_timer.h"
+#include "../utils/logging.h"
+#include "../utils/markup.h"
+#include "../utils/memory.h"
+
+#include <algorithm>
+#include <cassert>
+#include <limits>
+#include <random>
+#include <set>
+#include <thread>
+#include <utility>
+
+using namespace std;
+
+namespace hda_astar_search {
+/*
+  Messages to the same thread are collected in batches. A batch is sent
+  when it is full, every FLUSH_INTERVAL expansions and when the sending
+  thread runs out of work.
+*/
+static const int MESSAGE_BATCH_SIZE = 64;
+static const int FLUSH_INTERVAL = 32;
+
+struct Message {
+    uint64_t hash;
+    int g;
+    int real_g;
+    int parent_worker;
+    StateID parent_id;
+    OperatorID creating_operator;
+
+    Message(uint64_t hash, int g, int real_g, int parent_worker,
+            StateID parent_id, OperatorID creating_operator)
+        : hash(hash), g(g), real_g(real_g), parent_worker(parent_worker),
+          parent_id(parent_id), creating_operator(creating_operator) {
+    }
+};
+
+struct MessageBatch {
+    vector<Message> messages;
+    // Packed data of the states, one block of bins per message.
+    vector<PackedStateBin> state_data;
+    MessageBatch *next = nullptr;
+};
+
+/*
+  Stack of message batches with several producers and a single consumer.
+  The consumer always takes the complete stack, so there is no ABA problem.
+*/
+class MessageStack {
+    atomic<MessageBatch *> head;
+public:
+    MessageStack() : head(nullptr) {
+    }
+
+    ~MessageStack() {
+        MessageBatch *batch = take_all();
+        while (batch) {
+            delete exchange(batch, batch->next);
+        }
+    }
+
+    void push(MessageBatch *batch) {
+        batch->next = head.load(memory_order_relaxed);
+        while (!head.compare_exchange_weak(
+                   batch->next, batch,
+                   memory_order_release, memory_order_relaxed)) {
+        }
+    }
+
+    MessageBatch *take_all() {
+        return head.exchange(nullptr, memory_order_acquire);
+    }
+
+    bool empty() const {
+        return head.load(memory_order_acquire) == nullptr;
+    }
+};
+
+struct NodeInfo {
+    uint64_t hash = 0;
+    int g = -1;
+    int real_g = -1;
+    int h = -1;
+    int parent_worker = -1;
+    StateID parent_id = StateID::no_state;
+    OperatorID creating_operator = OperatorID::no_operator;
+    bool closed = false;
+    bool dead_end = false;
+
+    bool is_new() const {
+        return g == -1;
+    }
+};
+
+struct Worker {
+    const int id;
+    shared_ptr<Evaluator> evaluator;
+    unique_ptr<StateOpenList> open_list;
+    StateRegistry state_registry;
+    PerStateInformation<NodeInfo> node_infos;
+    SearchStatistics statistics;
+    MessageStack inbox;
+    vector<unique_ptr<MessageBatch>> outboxes;
+    vector<PackedStateBin> successor_buffer;
+
+    Worker(int id, const shared_ptr<Evaluator> &evaluator,
+           const plugins::Options &opts, const TaskProxy &task_proxy,
+           int num_threads, utils::LogProxy &log)
+        : id(id),
+          evaluator(evaluator),
+          state_registry(task_proxy),
+          statistics(log),
+          outboxes(num_threads) {
+        plugins::Options open_list_opts(opts);
+        open_list_opts.set("eval", evaluator);
+        open_list = search_common::create_astar_open_list_factory_and_f_eval(
+            open_list_opts).first->create_state_open_list();
+        successor_buffer.resize(
+            state_registry.get_state_packer().get_num_bins());
+    }
+};
+
+static vector<shared_ptr<Evaluator>> create_evaluators(
+    const parser::LazyValue &eval_config, int num_threads) {
+    vector<shared_ptr<Evaluator>> evaluators;
+    for (int i = 0; i < num_threads; ++i) {
+        shared_ptr<Evaluator> evaluator;
+        try {
+            evaluator = eval_config.construct<shared_ptr<Evaluator>>();
+        } catch (const utils::ContextError &e) {
+            cerr << "Delayed construction of LazyValue failed" << endl;
+            cerr << e.get_message() << endl;
+            utils::exit_with(utils::ExitCode::SEARCH_INPUT_ERROR);
+        }
+        if (i > 0 && evaluator == evaluators[0]) {
+            cerr << "hda_astar needs an evaluator for each thread, so eval "
+                 << "must not be a predefined evaluator." << endl;
+            utils::exit_with(utils::ExitCode::SEARCH_INPUT_ERROR);
+        }
+        set<Evaluator *> path_dependent_evaluators;
+        evaluator->get_path_dependent_evaluators(path_dependent_evaluators);
+        if (!path_dependent_evaluators.empty()) {
+            cerr << "hda_astar does not support path-dependent evaluators."
+                 << endl;
+            utils::exit_with(utils::ExitCode::SEARCH_UNSUPPORTED);
+        }
+        evaluators.push_back(evaluator);
+    }
+    return evaluators;
+}
+
+HDAStarSearch::HDAStarSearch(const plugins::Options &opts)
+    : SearchEngine(opts),
+      num_threads(opts.get<int>("threads")),
+      outstanding_work(0),
+      done(false),
+      timed_out(false),
+      incumbent_cost(numeric_limits<int>::max()),
+      incumbent_worker(-1),
+      incumbent_state(StateID::no_state) {
+    /*
+      The axiom evaluator of the task is shared by all state registries and
+      is not thread-safe.
+    */
+    task_properties::verify_no_axioms(task_proxy);
+
+    vector<shared_ptr<Evaluator>> evaluators = create_evaluators(
+        opts.get<parser::LazyValue>("eval"), num_threads);
+    workers.reserve(num_threads);
+    for (int i = 0; i < num_threads; ++i) {
+        workers.push_back(utils::make_unique_ptr<Worker>(
+                              i, evaluators[i], opts, task_proxy, num_threads,
+                              log));
+    }
+
+    // Use a fixed seed, so that the partitioning of the states is deterministic.
+    mt19937_64 rng(2013);
+    for (VariableProxy var : task_proxy.get_variables()) {
+        vector<uint64_t> keys(var.get_domain_size());
+        for (uint64_t &key : keys)
+            key = rng();
+        zobrist_keys.push_back(move(keys));
+    }
+}
+
+HDAStarSearch::~HDAStarSearch() {
+}
+
+uint64_t HDAStarSearch::compute_hash(const State &state) const {
+    uint64_t hash = 0;
+    for (FactProxy fact : state) {
+        FactPair pair = fact.get_pair();
+        hash ^= zobrist_keys[pair.var][pair.value];
+    }
+    return hash;
+}
+
+int HDAStarSearch::get_owner(uint64_t hash) const {
+    return static_cast<int>((hash >> 32) % num_threads);
+}
+
+void HDAStarSearch::initialize() {
+    log << "Conducting hash distributed A* search with " << num_threads
+        << " threads, (real) bound = " << bound << endl;
+
+    State initial_state = state_registry.get_initial_state();
+    Message message(compute_hash(initial_state), 0, 0, -1,
+                    StateID::no_state, OperatorID::no_operator);
+    Worker &owner = *workers[get_owner(message.hash)];
+    insert_state(owner, initial_state.get_buffer(), message);
+
+    State owner_initial_state = owner.state_registry.insert_state(
+        initial_state.get_buffer());
+    const NodeInfo &info = owner.node_infos[owner_initial_state];
+    if (info.dead_end) {
+        log << "Initial state is a dead end." << endl;
+    } else {
+        log << "Initial heuristic value for "
+            << owner.evaluator->get_description() << ": " << info.h << endl;
+    }
+}
+
+void HDAStarSearch::insert_state(
+    Worker &worker, const PackedStateBin *buffer, const Message &message) {
+    State state = worker.state_registry.insert_state(buffer);
+    NodeInfo &info = worker.node_infos[state];
+    if (info.dead_end)
+        return;
+
+    if (info.is_new()) {
+        EvaluationContext eval_context(
+            state, message.g, false, &worker.statistics);
+        worker.statistics.inc_evaluated_states();
+        if (worker.open_list->is_dead_end(eval_context)) {
+            info.dead_end = true;
+            worker.statistics.inc_dead_ends();
+            return;
+        }
+        info.hash = message.hash;
+        info.h = eval_context.get_evaluator_value(worker.evaluator.get());
+    } else if (info.g > message.g) {
+        // We found a new cheapest path to an open or closed state.
+        if (info.closed) {
+            worker.statistics.inc_reopened();
+            info.closed = false;
+        }
+    } else {
+        return;
+    }
+    info.g = message.g;
+    info.real_g = message.real_g;
+    info.parent_worker = message.parent_worker;
+    info.parent_id = message.parent_id;
+    info.creating_operator = message.creating_operator;
+    EvaluationContext eval_context(state, info.g, false, &worker.statistics);
+    worker.open_list->insert(eval_context, state.get_id());
+}
+
+void HDAStarSearch::expand_next_state(Worker &worker) {
+    StateID id = worker.open_list->remove_min();
+    State state = worker.state_registry.lookup_state(id);
+    NodeInfo &info = worker.node_infos[state];
+    if (info.closed)
+        return;
+    // States that cannot lead to a cheaper plan than the incumbent are discarded.
+    if (info.g + info.h >= incumbent_cost.load(memory_order_relaxed))
+        return;
+    info.closed = true;
+    worker.statistics.inc_expanded();
+
+    if (task_properties::is_goal_state(task_proxy, state)) {
+        report_solution(worker, id, info.g);
+        return;
+    }
+
+    vector<OperatorID> applicable_ops;
+    successor_generator.generate_applicable_ops(state, applicable_ops);
+    worker.statistics.inc_generated_ops(applicable_ops.size());
+
+    const int_packer::IntPacker &state_packer =
+        worker.state_registry.get_state_packer();
+    PackedStateBin *buffer = worker.successor_buffer.data();
+    int num_bins = worker.successor_buffer.size();
+    // Copy the node info, since inserting successors may invalidate references.
+    const NodeInfo parent_info = info;
+    for (OperatorID op_id : applicable_ops) {
+        OperatorProxy op = task_proxy.get_operators()[op_id];
+        if (parent_info.real_g + op.get_cost() >= bound)
+            continue;
+
+        copy_n(state.get_buffer(), num_bins, buffer);
+        uint64_t hash = parent_info.hash;
+        for (EffectProxy effect : op.get_effects()) {
+            if (does_fire(effect, state)) {
+                FactPair fact = effect.get_fact().get_pair();
+                int old_value = state_packer.get(buffer, fact.var);
+                if (old_value != fact.value) {
+                    state_packer.set(buffer, fact.var, fact.value);
+                    hash ^= zobrist_keys[fact.var][old_value] ^
+                        zobrist_keys[fact.var][fact.value];
+                }
+            }
+        }
+        worker.statistics.inc_generated();
+
+        Message message(
+            hash, parent_info.g + get_adjusted_cost(op),
+            parent_info.real_g + op.get_cost(), worker.id, id, op_id);
+
+        int owner = get_owner(hash);
+        if (owner == worker.id) {
+            insert_state(worker, buffer, message);
+        } else {
+            unique_ptr<MessageBatch> &batch = worker.outboxes[owner];
+            if (!batch)
+                batch = utils::make_unique_ptr<MessageBatch>();
+            batch->messages.push_back(message);
+            batch->state_data.insert(
+                batch->state_data.end(), buffer, buffer + num_bins);
+            if (batch->messages.size() >= MESSAGE_BATCH_SIZE)
+                flush_outbox(worker, owner);
+        }
+    }
+}
+
+void HDAStarSearch::report_solution(Worker &worker, StateID state_id, int g) {
+    lock_guard<mutex> lock(incumbent_mutex);
+    if (g < incumbent_cost.load(memory_order_relaxed)) {
+        incumbent_cost.store(g, memory_order_relaxed);
+        incumbent_worker = worker.id;
+        incumbent_state = state_id;
+    }
+}
+
+void HDAStarSearch::flush_outbox(Worker &worker, int to_worker) {
+    unique_ptr<MessageBatch> &batch = worker.outboxes[to_worker];
+    if (batch && !batch->messages.empty()) {
+        /*
+          The messages are counted before they become visible to the
+          receiver, which decreases the counter after processing them.
+        */
+        outstanding_work.fetch_add(
+            batch->messages.size(), memory_order_relaxed);
+        workers[to_worker]->inbox.push(batch.release());
+    }
+}
+
+void HDAStarSearch::flush_outboxes(Worker &worker) {
+    for (int i = 0; i < num_threads; ++i) {
+        flush_outbox(worker, i);
+    }
+}
+
+void HDAStarSearch::process_inbox(Worker &worker) {
+    MessageBatch *batch = worker.inbox.take_all();
+    int num_bins = worker.successor_buffer.size();
+    while (batch) {
+        const PackedStateBin *buffer = batch->state_data.data();
+        for (const Message &message : batch->messages) {
+            insert_state(worker, buffer, message);
+            buffer += num_bins;
+        }
+        /*
+          Messages sent while processing this batch have already been
+          counted, so the counter cannot drop to zero too early.
+        */
+        outstanding_work.fetch_sub(
+            batch->messages.size(), memory_order_acq_rel);
+        delete exchange(batch, batch->next);
+    }
+}
+
+/*
+  Called when the open list of the worker is empty. Returns true when new
+  messages arrived and false when the search is over.
+*/
+bool HDAStarSearch::wait_for_messages(Worker &worker) {
+    flush_outboxes(worker);
+    outstanding_work.fetch_sub(1, memory_order_acq_rel);
+    while (true) {
+        if (!worker.inbox.empty()) {
+            outstanding_work.fetch_add(1, memory_order_acq_rel);
+            return true;
+        }
+        if (outstanding_work.load(memory_order_acquire) == 0)
+            done.store(true, memory_order_release);
+        if (done.load(memory_order_acquire))
+            return false;
+        this_thread::yield();
+    }
+}
+
+void HDAStarSearch::run_worker(Worker &worker, const utils::CountdownTimer &timer) {
+    int num_expansions = 0;
+    while (!done.load(memory_order_acquire)) {
+        process_inbox(worker);
+        if (worker.open_list->empty()) {
+            if (!wait_for_messages(worker))
+                return;
+            continue;
+        }
+        expand_next_state(worker);
+        if (++num_expansions % FLUSH_INTERVAL == 0) {
+            flush_outboxes(worker);
+            if (timer.is_expired()) {
+                timed_out.store(true, memory_order_relaxed);
+                done.store(true, memory_order_release);
+            }
+        }
+    }
+}
+
+SearchStatus HDAStarSearch::step() {
+    utils::CountdownTimer timer(max_time);
+    outstanding_work.store(num_threads);
+    vector<thread> threads;
+    threads.reserve(num_threads);
+    for (unique_ptr<Worker> &worker : workers) {
+        threads.emplace_back(
+            &HDAStarSearch::run_worker, this, ref(*worker), cref(timer));
+    }
+    for (thread &worker_thread : threads) {
+        worker_thread.join();
+    }
+
+    for (const unique_ptr<Worker> &worker : workers) {
+        const SearchStatistics &worker_statistics = worker->statistics;
+        statistics.inc_expanded(worker_statistics.get_expanded());
+        statistics.inc_evaluated_states(worker_statistics.get_evaluated_states());
+        statistics.inc_evaluations(worker_statistics.get_evaluations());
+        statistics.inc_generated(worker_statistics.get_generated());
+        statistics.inc_reopened(worker_statistics.get_reopened());
+        statistics.inc_generated_ops(worker_statistics.get_generated_ops());
+        statistics.inc_dead_ends(worker_statistics.get_dead_ends());
+    }
+
+    if (incumbent_worker != -1 && !timed_out) {
+        log << "Solution found!" << endl;
+        set_plan(extract_plan());
+        return SOLVED;
+    }
+    if (timed_out) {
+        // SearchEngine::search() reports that the time limit was reached.
+        return TIMEOUT;
+    }
+    log << "Completely explored state space -- no solution!" << endl;
+    return FAILED;
+}
+
+Plan HDAStarSearch::extract_plan() const {
+    Plan plan;
+    int worker_id = incumbent_worker;
+    StateID state_id = incumbent_state;
+    while (true) {
+        const Worker &worker = *workers[worker_id];
+        State state = worker.state_registry.lookup_state(state_id);
+        const NodeInfo &info = worker.node_infos[state];
+        if (info.creating_operator == OperatorID::no_operator)
+            break;
+        plan.push_back(info.creating_operator);
+        worker_id = info.parent_worker;
+        state_id = info.parent_id;
+    }
+    reverse(plan.begin(), plan.end());
+    return plan;
+}
+
+void HDAStarSearch::print_statistics() const {
+    statistics.print_detailed_statistics();
+    size_t num_registered_states = 0;
+    for (const unique_ptr<Worker> &worker : workers) {
+        log << "Thread " << worker->id << ": expanded "
+            << worker->statistics.get_expanded() << " state(s), registered "
+            << worker->state_registry.size() << " state(s)" << endl;
+        num_registered_states += worker->state_registry.size();
+    }
+    log << "Number of registered states: " << num_registered_states << endl;
+}
+
+class HDAStarSearchFeature : public plugins::TypedFeature<SearchEngine, HDAStarSearch> {
+public:
+    HDAStarSearchFeature() : TypedFeature("hda_astar") {
+        document_title("Hash distributed A* search");
+        document_synopsis(
+            "Multi-threaded A* search that distributes the states among the "
+            "threads by hashing. Each thread has its own open list, closed "
+            "list and heuristic, and sends generated states that belong to "
+            "other threads to their owners. The search only terminates when "
+            "all threads have run out of states with an f value lower than "
+            "the cost of the best plan found so far, so the plan is optimal "
+            "if the heuristic is admissible. See:"
+            + utils::format_journal_reference(
+                {"Akihiro Kishimoto", "Alex Fukunaga", "Adi Botea"},
+                "Evaluation of a simple, scalable, parallel best-first "
+                "search strategy",
+                "https://doi.org/10.1016/j.artint.2012.10.007",
+                "Artificial Intelligence",
+                "195",
+                "222-248",
+                "2013"));
+
+        add_option<shared_ptr<Evaluator>>(
+            "eval",
+            "evaluator for h-value. It is constructed once for each thread.",
+            "",
+            plugins::Bounds::unlimited(),
+            true);
+        add_option<int>(
+            "threads",
+            "number of search threads",
+            "2",
+            plugins::Bounds("1", "infinity"));
+        SearchEngine::add_options_to_feature(*this);
+
+        document_note(
+            "Evaluators",
+            "Since every thread needs its own instance of the evaluator, eval "
+            "cannot refer to evaluators defined with --evaluator or let. "
+            "Path-dependent evaluators are not supported.");
+        document_language_support("action costs", "supported");
+        document_language_support("conditional effects", "supported");
+        document_language_support("axioms", "not supported");
+    }
+};
+
+static plugins::FeaturePlugin<HDAStarSearchFeature> _plugin;
+}
@@ -0,0 +1,88 @@
+#ifndef SEARCH_ENGINES_HDA_ASTAR_SEARCH_H
+#define SEARCH_ENGINES_HDA_ASTAR_SEARCH_H
+
+#include "../search_engine.h"
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace plugins {
+class Options;
+}
+
+namespace utils {
+class CountdownTimer;
+}
+
+namespace hda_astar_search {
+struct Message;
+struct Worker;
+
+/*
+  Hash Distributed A* (Kishimoto, Fukunaga and Botea, 2013).
+
+  Every thread owns a part of the state space: a state registry, an open
+  list and an instance of the heuristic. States are assigned to threads by
+  a Zobrist hash of their variable values, which is updated incrementally
+  when generating successors. A thread that generates a state owned by
+  another thread sends it to the owner, which performs the duplicate check
+  and the evaluation. Messages are collected in batches and pushed to
+  lock-free stacks.
+
+  Each thread expands the states of its open list in A* order. A goal state
+  becomes the incumbent solution if it is cheaper than the current one, and
+  states whose f value is not lower than the cost of the incumbent are
+  discarded. The search terminates when all threads are idle and no
+  messages are left, so the incumbent is optimal for admissible heuristics.
+*/
+class HDAStarSearch : public SearchEngine {
+    const int num_threads;
+    std::vector<std::unique_ptr<Worker>> workers;
+    std::vector<std::vector<uint64_t>> zobrist_keys;
+
+    /*
+      Number of active threads plus the number of messages that have been
+      sent but not processed yet. When it drops to zero, no thread can
+      receive new work and the search is over.
+    */
+    std::atomic<int64_t> outstanding_work;
+    std::atomic<bool> done;
+    std::atomic<bool> timed_out;
+
+    std::atomic<int> incumbent_cost;
+    std::mutex incumbent_mutex;
+    int incumbent_worker;
+    StateID incumbent_state;
+
+    uint64_t compute_hash(const State &state) const;
+    int get_owner(uint64_t hash) const;
+
+    void insert_state(
+        Worker &worker, const PackedStateBin *buffer, const Message &message);
+    void expand_next_state(Worker &worker);
+    void report_solution(Worker &worker, StateID state_id, int g);
+
+    void flush_outbox(Worker &worker, int to_worker);
+    void flush_outboxes(Worker &worker);
+    void process_inbox(Worker &worker);
+    bool wait_for_messages(Worker &worker);
+    void run_worker(Worker &worker, const utils::CountdownTimer &timer);
+
+    Plan extract_plan() const;
+
+protected:
+    virtual void initialize() override;
+    virtual SearchStatus step() override;
+
+public:
+    explicit HDAStarSearch(const plugins::Options &opts);
+    virtual ~HDAStarSearch() override;
+
+    virtual void print_statistics() const override;
+};
+}
+
+#endif
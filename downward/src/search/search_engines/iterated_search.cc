@@ -64,6 +64,9 @@ SearchStatus IteratedSearch::step() {
     if (pass_bound) {
         current_search->set_bound(best_bound);
     }
+    if (concurrent_search_info) {
+        current_search->set_concurrent_search_info(concurrent_search_info);
+    }
     ++phase;
 
     current_search->search();
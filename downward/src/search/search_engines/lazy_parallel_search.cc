@@ -0,0 +1,680 @@
+#include "lazy_parallel_search.h"
+#include "search_common.h"
+
+#include "../batch_evaluator.h"
+#include "../evaluation_context.h"
+#include "../evaluator.h"
+#include "../open_list_factory.h"
+#include "../per_state_information.h"
+#include "../search_progress.h"
+
+#include "../algorithms/ordered_set.h"
+#include "../plugins/plugin.h"
+#include "../task_utils/successor_generator.h"
+#include "../task_utils/task_properties.h"
+#include "../utils/countdown_timer.h"
+#include "../utils/hash.h"
+#include "../utils/logging.h"
+#include "../utils/memory.h"
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cassert>
+#include <limits>
+#include <map>
+#include <set>
+#include <thread>
+#include <utility>
+
+using namespace std;
+
+namespace lazy_parallel_search {
+// A busy thread sends up to this many edges to a hungry one.
+static const int DONATION_SIZE = 64;
+static const int TIMER_CHECK_INTERVAL = 32;
+static const int MAX_THREADS = 255;
+
+static const StateRef NO_STATE_REF = numeric_limits<StateRef>::max();
+
+static StateRef make_state_ref(int thread_id, uint32_t index) {
+    return (static_cast<StateRef>(thread_id) << 32) | index;
+}
+
+static int get_thread_id(StateRef ref) {
+    return static_cast<int>(ref >> 32);
+}
+
+static uint32_t get_index(StateRef ref) {
+    return static_cast<uint32_t>(ref);
+}
+
+static concurrent_int_hash_set::HashType compute_hash(
+    const PackedStateBin *buffer, int num_bins) {
+    return utils::finalize_word_array_hash(
+        utils::get_word_array_hash_sum(buffer, num_bins));
+}
+
+struct PoolNode {
+    concurrent_int_hash_set::HashType hash;
+    int creating_operator;
+    StateRef parent;
+};
+
+/*
+  Append-only storage for the states that a thread reached first, together
+  with their parents. Only the owning thread appends states, but all threads
+  read them when comparing states in the closed list, so existing entries
+  never move: the pool consists of segments of exponentially growing size.
+
+  The owning thread writes the next state into the slot at index size()
+  before inserting it into the closed list and only keeps it if the
+  insertion succeeds.
+*/
+class StatePool {
+    static const size_t FIRST_SEGMENT_SIZE = 1024;
+    static const int MAX_SEGMENTS = 32;
+
+    const int num_bins;
+    array<unique_ptr<PackedStateBin[]>, MAX_SEGMENTS> state_segments;
+    array<unique_ptr<PoolNode[]>, MAX_SEGMENTS> node_segments;
+    uint32_t num_states;
+
+    static pair<int, size_t> get_position(uint32_t index) {
+        size_t first_segment_index = index / FIRST_SEGMENT_SIZE + 1;
+        int segment = bit_width(first_segment_index) - 1;
+        size_t offset =
+            index - FIRST_SEGMENT_SIZE * ((size_t(1) << segment) - 1);
+        return make_pair(segment, offset);
+    }
+
+    void prepare_next_slot() {
+        int segment = get_position(num_states).first;
+        if (!state_segments[segment]) {
+            size_t segment_size = FIRST_SEGMENT_SIZE << segment;
+            state_segments[segment].reset(
+                new PackedStateBin[segment_size * num_bins]);
+            node_segments[segment].reset(new PoolNode[segment_size]);
+        }
+    }
+
+public:
+    explicit StatePool(int num_bins)
+        : num_bins(num_bins),
+          num_states(0) {
+    }
+
+    uint32_t size() const {
+        return num_states;
+    }
+
+    const PackedStateBin *get_buffer(uint32_t index) const {
+        pair<int, size_t> position = get_position(index);
+        return &state_segments[position.first][position.second * num_bins];
+    }
+
+    const PoolNode &get_node(uint32_t index) const {
+        pair<int, size_t> position = get_position(index);
+        return node_segments[position.first][position.second];
+    }
+
+    PackedStateBin *get_next_buffer() {
+        prepare_next_slot();
+        return const_cast<PackedStateBin *>(get_buffer(num_states));
+    }
+
+    PoolNode &get_next_node() {
+        prepare_next_slot();
+        return const_cast<PoolNode &>(get_node(num_states));
+    }
+
+    void push_back() {
+        if (num_states == numeric_limits<uint32_t>::max()) {
+            cerr << "Too many states for one thread." << endl;
+            utils::exit_with(utils::ExitCode::SEARCH_OUT_OF_MEMORY);
+        }
+        ++num_states;
+    }
+
+    bool equal(uint32_t index, const PackedStateBin *buffer) const {
+        const PackedStateBin *data = get_buffer(index);
+        return std::equal(data, data + num_bins, buffer);
+    }
+};
+
+struct NodeInfo {
+    int g = -1;
+    int real_g = -1;
+    StateRef ref = NO_STATE_REF;
+};
+
+// The source state of donated edges and the operators of the edges.
+struct DonatedState {
+    StateRef ref;
+    int g;
+    int real_g;
+    vector<OperatorID> operators;
+};
+
+struct Donation {
+    vector<DonatedState> states;
+    // Packed data of the states, one block of bins per state.
+    vector<PackedStateBin> state_data;
+};
+
+struct Worker {
+    const int id;
+    vector<shared_ptr<Evaluator>> preferred_operator_evaluators;
+    unique_ptr<EdgeOpenList> open_list;
+    StateRegistry state_registry;
+    PerStateInformation<NodeInfo> node_infos;
+    StatePool state_pool;
+    SearchStatistics statistics;
+    SearchProgress search_progress;
+    int num_donations_sent;
+    int num_donations_received;
+
+    atomic<bool> hungry;
+    atomic<bool> has_donations;
+    mutex inbox_mutex;
+    vector<unique_ptr<Donation>> inbox;
+
+    Worker(int id, const vector<shared_ptr<Evaluator>> &evaluators,
+           const vector<shared_ptr<Evaluator>> &preferred_operator_evaluators,
+           const plugins::Options &opts, const TaskProxy &task_proxy,
+           utils::LogProxy &log)
+        : id(id),
+          preferred_operator_evaluators(preferred_operator_evaluators),
+          state_registry(task_proxy),
+          state_pool(state_registry.get_state_packer().get_num_bins()),
+          statistics(log),
+          num_donations_sent(0),
+          num_donations_received(0),
+          hungry(false),
+          has_donations(false) {
+        plugins::Options open_list_opts(opts);
+        open_list_opts.set("evals", evaluators);
+        open_list_opts.set("preferred", preferred_operator_evaluators);
+        open_list = search_common::create_greedy_open_list_factory(
+            open_list_opts)->create_edge_open_list();
+    }
+};
+
+concurrent_int_hash_set::HashType StateRefHash::operator()(StateRef ref) const {
+    return workers[get_thread_id(ref)]->state_pool.get_node(get_index(ref)).hash;
+}
+
+bool StateRefEqual::operator()(StateRef ref1, StateRef ref2) const {
+    const StatePool &pool2 = workers[get_thread_id(ref2)]->state_pool;
+    return workers[get_thread_id(ref1)]->state_pool.equal(
+        get_index(ref1), pool2.get_buffer(get_index(ref2)));
+}
+
+/*
+  Evaluators are not thread-safe, so every thread except the first one uses
+  copies of them. Evaluators that occur several times (e.g., in evals and
+  preferred) are copied only once per thread.
+*/
+static shared_ptr<Evaluator> get_copy_for_thread(
+    const shared_ptr<Evaluator> &evaluator,
+    map<Evaluator *, shared_ptr<Evaluator>> &copies) {
+    shared_ptr<Evaluator> &copy = copies[evaluator.get()];
+    if (!copy) {
+        try {
+            copy = copy_evaluator(*evaluator);
+        } catch (const utils::ContextError &e) {
+            cerr << "lazy_greedy_parallel cannot copy the evaluator "
+                 << evaluator->get_description() << " for another thread."
+                 << endl << e.get_message() << endl;
+            utils::exit_with(utils::ExitCode::SEARCH_INPUT_ERROR);
+        } catch (const plugins::BadAnyCast &) {
+            cerr << "lazy_greedy_parallel cannot copy the evaluator "
+                 << evaluator->get_description() << " for another thread."
+                 << endl;
+            utils::exit_with(utils::ExitCode::SEARCH_INPUT_ERROR);
+        }
+    }
+    return copy;
+}
+
+LazyParallelSearch::LazyParallelSearch(const plugins::Options &opts)
+    : SearchEngine(opts),
+      num_threads(opts.get<int>("threads")),
+      closed_list(StateRefHash(workers), StateRefEqual(workers)),
+      outstanding_work(0),
+      num_hungry_workers(0),
+      done(false),
+      timed_out(false),
+      goal_state(NO_STATE_REF) {
+    /*
+      The axiom evaluator of the task is shared by all state registries and
+      is not thread-safe.
+    */
+    task_properties::verify_no_axioms(task_proxy);
+
+    vector<shared_ptr<Evaluator>> evals =
+        opts.get_list<shared_ptr<Evaluator>>("evals");
+    vector<shared_ptr<Evaluator>> preferred =
+        opts.get_list<shared_ptr<Evaluator>>("preferred");
+    set<Evaluator *> path_dependent_evaluators;
+    for (const shared_ptr<Evaluator> &evaluator : evals)
+        evaluator->get_path_dependent_evaluators(path_dependent_evaluators);
+    for (const shared_ptr<Evaluator> &evaluator : preferred)
+        evaluator->get_path_dependent_evaluators(path_dependent_evaluators);
+    if (!path_dependent_evaluators.empty()) {
+        cerr << "lazy_greedy_parallel does not support path-dependent "
+             << "evaluators." << endl;
+        utils::exit_with(utils::ExitCode::SEARCH_UNSUPPORTED);
+    }
+
+    workers.reserve(num_threads);
+    for (int i = 0; i < num_threads; ++i) {
+        vector<shared_ptr<Evaluator>> thread_evals = evals;
+        vector<shared_ptr<Evaluator>> thread_preferred = preferred;
+        if (i > 0) {
+            map<Evaluator *, shared_ptr<Evaluator>> copies;
+            for (shared_ptr<Evaluator> &evaluator : thread_evals)
+                evaluator = get_copy_for_thread(evaluator, copies);
+            for (shared_ptr<Evaluator> &evaluator : thread_preferred)
+                evaluator = get_copy_for_thread(evaluator, copies);
+        }
+        workers.push_back(utils::make_unique_ptr<Worker>(
+                              i, thread_evals, thread_preferred, opts,
+                              task_proxy, log));
+    }
+}
+
+LazyParallelSearch::~LazyParallelSearch() {
+}
+
+void LazyParallelSearch::initialize() {
+    log << "Conducting parallel lazy greedy search with " << num_threads
+        << " threads, (real) bound = " << bound << endl;
+
+    /*
+      Evaluate the copies of the evaluators once on this thread, so that
+      everything they set up lazily (e.g., shared per-task information)
+      exists before they are used concurrently.
+    */
+    for (size_t i = 1; i < workers.size(); ++i) {
+        Worker &worker = *workers[i];
+        EvaluationContext eval_context(
+            worker.state_registry.get_initial_state(), 0, true, nullptr);
+        worker.open_list->is_dead_end(eval_context);
+        for (const shared_ptr<Evaluator> &evaluator :
+             worker.preferred_operator_evaluators) {
+            eval_context.get_result(evaluator.get());
+        }
+    }
+
+    Worker &worker = *workers[0];
+    State initial_state = worker.state_registry.get_initial_state();
+    PackedStateBin *buffer = worker.state_pool.get_next_buffer();
+    int num_bins = worker.state_registry.get_state_packer().get_num_bins();
+    copy_n(initial_state.get_buffer(), num_bins, buffer);
+    StateRef ref;
+    bool inserted = insert_into_closed_list(
+        worker, compute_hash(buffer, num_bins), NO_STATE_REF,
+        OperatorID::no_operator, ref);
+    utils::unused_variable(inserted);
+    assert(inserted);
+    worker.node_infos[initial_state] = {0, 0, ref};
+
+    EvaluationContext eval_context(initial_state, 0, true, &worker.statistics);
+    print_initial_evaluator_values(eval_context);
+    expand_state(worker, initial_state, eval_context);
+}
+
+bool LazyParallelSearch::insert_into_closed_list(
+    Worker &worker, concurrent_int_hash_set::HashType hash, StateRef parent,
+    OperatorID creating_operator, StateRef &ref) {
+    // The caller has written the state to the next buffer of the pool.
+    PoolNode &node = worker.state_pool.get_next_node();
+    node.hash = hash;
+    node.creating_operator = creating_operator.get_index();
+    node.parent = parent;
+    ref = make_state_ref(worker.id, worker.state_pool.size());
+    if (!closed_list.insert(ref, hash).second)
+        return false;
+    worker.state_pool.push_back();
+    return true;
+}
+
+void LazyParallelSearch::expand_state(
+    Worker &worker, const State &state, EvaluationContext &eval_context) {
+    worker.statistics.inc_evaluated_states();
+    if (worker.open_list->is_dead_end(eval_context)) {
+        worker.statistics.inc_dead_ends();
+        return;
+    }
+
+    if (task_properties::is_goal_state(task_proxy, state)) {
+        StateRef expected = NO_STATE_REF;
+        goal_state.compare_exchange_strong(
+            expected, worker.node_infos[state].ref);
+        done.store(true, memory_order_release);
+        return;
+    }
+
+    bool progress;
+    {
+        lock_guard<mutex> lock(progress_mutex);
+        progress = worker.search_progress.check_progress(eval_context);
+    }
+    if (progress)
+        worker.open_list->boost_preferred();
+
+    vector<OperatorID> applicable_ops;
+    successor_generator.generate_applicable_ops(state, applicable_ops);
+    worker.statistics.inc_generated(applicable_ops.size());
+    insert_edges(worker, state, eval_context, applicable_ops);
+    worker.statistics.inc_expanded();
+}
+
+void LazyParallelSearch::insert_edges(
+    Worker &worker, const State &state, EvaluationContext &eval_context,
+    const vector<OperatorID> &operators) {
+    ordered_set::OrderedSet<OperatorID> preferred_operators;
+    for (const shared_ptr<Evaluator> &evaluator :
+         worker.preferred_operator_evaluators) {
+        collect_preferred_operators(
+            eval_context, evaluator.get(), preferred_operators);
+    }
+
+    const NodeInfo &info = worker.node_infos[state];
+    for (OperatorID op_id : operators) {
+        OperatorProxy op = task_proxy.get_operators()[op_id];
+        int new_g = info.g + get_adjusted_cost(op);
+        int new_real_g = info.real_g + op.get_cost();
+        if (new_real_g < bound) {
+            EvaluationContext new_eval_context(
+                eval_context, new_g, preferred_operators.contains(op_id),
+                nullptr);
+            worker.open_list->insert(
+                new_eval_context, make_pair(state.get_id(), op_id));
+        }
+    }
+}
+
+void LazyParallelSearch::process_next_edge(Worker &worker) {
+    EdgeOpenListEntry edge = worker.open_list->remove_min();
+    State parent = worker.state_registry.lookup_state(edge.first);
+    const NodeInfo parent_info = worker.node_infos[parent];
+    OperatorProxy op = task_proxy.get_operators()[edge.second];
+
+    /*
+      Generate the successor in the pool instead of the state registry, so
+      that the registry only contains the states that this thread expands.
+    */
+    const int_packer::IntPacker &state_packer =
+        worker.state_registry.get_state_packer();
+    int num_bins = state_packer.get_num_bins();
+    PackedStateBin *buffer = worker.state_pool.get_next_buffer();
+    copy_n(parent.get_buffer(), num_bins, buffer);
+    for (EffectProxy effect : op.get_effects()) {
+        if (does_fire(effect, parent)) {
+            FactPair fact = effect.get_fact().get_pair();
+            state_packer.set(buffer, fact.var, fact.value);
+        }
+    }
+    StateRef ref;
+    if (!insert_into_closed_list(
+            worker, compute_hash(buffer, num_bins), parent_info.ref,
+            edge.second, ref))
+        return;
+
+    State state = worker.state_registry.insert_state(buffer);
+    NodeInfo &info = worker.node_infos[state];
+    info.g = parent_info.g + get_adjusted_cost(op);
+    info.real_g = parent_info.real_g + op.get_cost();
+    info.ref = ref;
+    EvaluationContext eval_context(state, info.g, true, &worker.statistics);
+    expand_state(worker, state, eval_context);
+}
+
+/*
+  Send the best edges of the worker to a hungry thread, if there is one.
+  The receiving thread registers the source states of the edges in its own
+  registry and evaluates them again to insert the edges into its open list.
+*/
+void LazyParallelSearch::donate_edges(Worker &worker) {
+    Worker *receiver = nullptr;
+    for (const unique_ptr<Worker> &other : workers) {
+        bool expected = true;
+        if (other.get() != &worker &&
+            other->hungry.compare_exchange_strong(expected, false)) {
+            receiver = other.get();
+            break;
+        }
+    }
+    if (!receiver)
+        return;
+    num_hungry_workers.fetch_sub(1, memory_order_relaxed);
+
+    int num_bins = worker.state_registry.get_state_packer().get_num_bins();
+    unique_ptr<Donation> donation = utils::make_unique_ptr<Donation>();
+    vector<StateID> donated_ids;
+    for (int i = 0; i < DONATION_SIZE && !worker.open_list->empty(); ++i) {
+        EdgeOpenListEntry edge = worker.open_list->remove_min();
+        auto it = find(donated_ids.begin(), donated_ids.end(), edge.first);
+        if (it == donated_ids.end()) {
+            State state = worker.state_registry.lookup_state(edge.first);
+            const NodeInfo &info = worker.node_infos[state];
+            donation->states.push_back({info.ref, info.g, info.real_g, {}});
+            donation->state_data.insert(
+                donation->state_data.end(), state.get_buffer(),
+                state.get_buffer() + num_bins);
+            donated_ids.push_back(edge.first);
+            it = donated_ids.end() - 1;
+        }
+        donation->states[it - donated_ids.begin()].operators.push_back(
+            edge.second);
+    }
+    ++worker.num_donations_sent;
+
+    /*
+      The donation is counted before it becomes visible to the receiver,
+      which decreases the counter after processing it.
+    */
+    outstanding_work.fetch_add(1, memory_order_relaxed);
+    lock_guard<mutex> lock(receiver->inbox_mutex);
+    receiver->inbox.push_back(move(donation));
+    receiver->has_donations.store(true, memory_order_release);
+}
+
+void LazyParallelSearch::process_donations(Worker &worker) {
+    vector<unique_ptr<Donation>> donations;
+    {
+        lock_guard<mutex> lock(worker.inbox_mutex);
+        donations.swap(worker.inbox);
+        worker.has_donations.store(false, memory_order_relaxed);
+    }
+    int num_bins = worker.state_registry.get_state_packer().get_num_bins();
+    for (const unique_ptr<Donation> &donation : donations) {
+        const PackedStateBin *buffer = donation->state_data.data();
+        for (const DonatedState &donated_state : donation->states) {
+            State state = worker.state_registry.insert_state(buffer);
+            buffer += num_bins;
+            NodeInfo &info = worker.node_infos[state];
+            if (info.g == -1 || donated_state.g < info.g) {
+                info.g = donated_state.g;
+                info.real_g = donated_state.real_g;
+                info.ref = donated_state.ref;
+            }
+            EvaluationContext eval_context(
+                state, info.g, true, &worker.statistics);
+            if (!worker.open_list->is_dead_end(eval_context)) {
+                insert_edges(
+                    worker, state, eval_context, donated_state.operators);
+            }
+        }
+        ++worker.num_donations_received;
+    }
+    /*
+      Donations sent while processing these ones have already been counted,
+      so the counter cannot drop to zero too early.
+    */
+    outstanding_work.fetch_sub(donations.size(), memory_order_acq_rel);
+}
+
+/*
+  Called when the open list of the worker is empty. Returns true when new
+  donations arrived and false when the search is over.
+*/
+bool LazyParallelSearch::wait_for_donations(Worker &worker) {
+    if (!worker.hungry.exchange(true))
+        num_hungry_workers.fetch_add(1, memory_order_relaxed);
+    outstanding_work.fetch_sub(1, memory_order_acq_rel);
+    while (true) {
+        if (worker.has_donations.load(memory_order_acquire)) {
+            outstanding_work.fetch_add(1, memory_order_acq_rel);
+            return true;
+        }
+        if (outstanding_work.load(memory_order_acquire) == 0)
+            done.store(true, memory_order_release);
+        if (done.load(memory_order_acquire))
+            return false;
+        this_thread::yield();
+    }
+}
+
+void LazyParallelSearch::run_worker(
+    Worker &worker, const utils::CountdownTimer &timer) {
+    int num_steps = 0;
+    while (!done.load(memory_order_acquire)) {
+        if (worker.has_donations.load(memory_order_acquire))
+            process_donations(worker);
+        if (worker.open_list->empty()) {
+            if (!wait_for_donations(worker))
+                return;
+            continue;
+        }
+        process_next_edge(worker);
+        /*
+          Donate only after processing an edge. Otherwise, two threads could
+          pass the same edges back and forth without making progress.
+        */
+        if (num_hungry_workers.load(memory_order_relaxed) > 0 &&
+            !worker.open_list->empty()) {
+            donate_edges(worker);
+        }
+        if (++num_steps % TIMER_CHECK_INTERVAL == 0 && timer.is_expired()) {
+            timed_out.store(true, memory_order_relaxed);
+            done.store(true, memory_order_release);
+        }
+    }
+}
+
+SearchStatus LazyParallelSearch::step() {
+    utils::CountdownTimer timer(max_time);
+    outstanding_work.store(num_threads);
+    vector<thread> threads;
+    threads.reserve(num_threads);
+    for (unique_ptr<Worker> &worker : workers) {
+        threads.emplace_back(
+            &LazyParallelSearch::run_worker, this, ref(*worker), cref(timer));
+    }
+    for (thread &worker_thread : threads) {
+        worker_thread.join();
+    }
+
+    for (const unique_ptr<Worker> &worker : workers) {
+        const SearchStatistics &worker_statistics = worker->statistics;
+        statistics.inc_expanded(worker_statistics.get_expanded());
+        statistics.inc_evaluated_states(worker_statistics.get_evaluated_states());
+        statistics.inc_evaluations(worker_statistics.get_evaluations());
+        statistics.inc_generated(worker_statistics.get_generated());
+        statistics.inc_dead_ends(worker_statistics.get_dead_ends());
+    }
+
+    if (goal_state != NO_STATE_REF) {
+        log << "Solution found!" << endl;
+        set_plan(extract_plan());
+        return SOLVED;
+    }
+    if (timed_out) {
+        // SearchEngine::search() reports that the time limit was reached.
+        return TIMEOUT;
+    }
+    log << "Completely explored state space -- no solution!" << endl;
+    return FAILED;
+}
+
+Plan LazyParallelSearch::extract_plan() const {
+    Plan plan;
+    StateRef ref = goal_state;
+    while (true) {
+        const PoolNode &node =
+            workers[get_thread_id(ref)]->state_pool.get_node(get_index(ref));
+        if (node.creating_operator == OperatorID::no_operator.get_index())
+            break;
+        plan.push_back(OperatorID(node.creating_operator));
+        ref = node.parent;
+    }
+    reverse(plan.begin(), plan.end());
+    return plan;
+}
+
+void LazyParallelSearch::print_statistics() const {
+    statistics.print_detailed_statistics();
+    for (const unique_ptr<Worker> &worker : workers) {
+        log << "Thread " << worker->id << ": expanded "
+            << worker->statistics.get_expanded() << " state(s), sent "
+            << worker->num_donations_sent << " and received "
+            << worker->num_donations_received << " donation(s)" << endl;
+    }
+    log << "Number of reached states: " << closed_list.size() << endl;
+    closed_list.print_statistics(log);
+}
+
+class LazyParallelSearchFeature : public plugins::TypedFeature<SearchEngine, LazyParallelSearch> {
+public:
+    LazyParallelSearchFeature() : TypedFeature("lazy_greedy_parallel") {
+        document_title("Parallel greedy search (lazy)");
+        document_synopsis(
+            "Multi-threaded greedy best-first search with deferred "
+            "evaluation. Each thread has its own open list and copies of the "
+            "evaluators, and all threads share a concurrent closed list, so "
+            "every state is expanded by at most one thread. Threads that run "
+            "out of work receive edges from the open lists of the others. "
+            "The search stops as soon as one thread finds a plan.");
+
+        add_list_option<shared_ptr<Evaluator>>(
+            "evals",
+            "evaluators");
+        add_list_option<shared_ptr<Evaluator>>(
+            "preferred",
+            "use preferred operators of these evaluators",
+            "[]");
+        add_option<int>(
+            "boost",
+            "boost value for alternation queues that are restricted "
+            "to preferred operator nodes",
+            "1000");
+        add_option<int>(
+            "threads",
+            "number of search threads",
+            "2",
+            plugins::Bounds("1", to_string(MAX_THREADS)));
+        SearchEngine::add_options_to_feature(*this);
+
+        document_note(
+            "Open lists",
+            "Each thread uses the same open list as lazy_greedy with the "
+            "given evaluators.");
+        document_note(
+            "Evaluators",
+            "The threads other than the first one construct their own "
+            "evaluators from the configuration strings of the given ones. "
+            "Therefore, evaluators must be fully specified in the "
+            "configuration of the search (or in a definition with "
+            "--evaluator or let that does not refer to other definitions). "
+            "Path-dependent evaluators are not supported.");
+        document_language_support("action costs", "supported");
+        document_language_support("conditional effects", "supported");
+        document_language_support("axioms", "not supported");
+    }
+};
+
+static plugins::FeaturePlugin<LazyParallelSearchFeature> _plugin;
+}
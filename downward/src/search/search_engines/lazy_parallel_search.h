@@ -0,0 +1,124 @@
+#ifndef SEARCH_ENGINES_LAZY_PARALLEL_SEARCH_H
+#define SEARCH_ENGINES_LAZY_PARALLEL_SEARCH_H
+
+#include "../search_engine.h"
+
+#include "../algorithms/concurrent_int_hash_set.h"
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace plugins {
+class Options;
+}
+
+namespace utils {
+class CountdownTimer;
+}
+
+namespace lazy_parallel_search {
+class StatePool;
+struct Worker;
+
+/*
+  The global reference of a state consists of the ID of the thread that
+  reached it first (upper bits) and the index of the state in the state pool
+  of that thread (lower 32 bits).
+*/
+using StateRef = std::uint64_t;
+
+struct StateRefHash {
+    const std::vector<std::unique_ptr<Worker>> &workers;
+
+    explicit StateRefHash(const std::vector<std::unique_ptr<Worker>> &workers)
+        : workers(workers) {
+    }
+
+    concurrent_int_hash_set::HashType operator()(StateRef ref) const;
+};
+
+struct StateRefEqual {
+    const std::vector<std::unique_ptr<Worker>> &workers;
+
+    explicit StateRefEqual(const std::vector<std::unique_ptr<Worker>> &workers)
+        : workers(workers) {
+    }
+
+    bool operator()(StateRef ref1, StateRef ref2) const;
+};
+
+/*
+  Greedy best-first search with deferred evaluation on several threads.
+
+  Every thread runs a lazy search with its own state registry, open list of
+  (state, operator) edges and copies of the evaluators. The threads share a
+  closed list: a concurrent hash set of all states that were reached so far.
+  When a thread removes an edge from its open list, it generates the target
+  state and inserts it into the closed list. Only the thread whose insertion
+  succeeds evaluates and expands the state, so no state is expanded twice.
+
+  Threads that run out of edges steal work from the others: an idle thread
+  announces that it is hungry, and the next busy thread that notices this
+  removes its best edges from its open list and sends them, together with
+  the data of their source states, to the idle thread. The states remain in
+  the state pool of the thread that reached them first, so the plan is
+  extracted by following the references to the parents across the pools.
+
+  The search stops when a thread reaches a goal state or when all threads
+  are idle and no work is in flight.
+*/
+class LazyParallelSearch : public SearchEngine {
+    using ClosedList = concurrent_int_hash_set::ConcurrentIntHashSet<
+        StateRefHash, StateRefEqual>;
+
+    const int num_threads;
+    std::vector<std::unique_ptr<Worker>> workers;
+    ClosedList closed_list;
+
+    /*
+      Number of active threads plus the number of donations that have been
+      sent but not processed yet. When it drops to zero, no thread can
+      receive new work and the search is over.
+    */
+    std::atomic<int64_t> outstanding_work;
+    std::atomic<int> num_hungry_workers;
+    std::atomic<bool> done;
+    std::atomic<bool> timed_out;
+    std::atomic<StateRef> goal_state;
+
+    // Evaluators report new minimum values to the shared log.
+    std::mutex progress_mutex;
+
+    bool insert_into_closed_list(
+        Worker &worker, concurrent_int_hash_set::HashType hash,
+        StateRef parent, OperatorID creating_operator, StateRef &ref);
+    void expand_state(
+        Worker &worker, const State &state, EvaluationContext &eval_context);
+    void insert_edges(
+        Worker &worker, const State &state, EvaluationContext &eval_context,
+        const std::vector<OperatorID> &operators);
+    void process_next_edge(Worker &worker);
+
+    void donate_edges(Worker &worker);
+    void process_donations(Worker &worker);
+    bool wait_for_donations(Worker &worker);
+    void run_worker(Worker &worker, const utils::CountdownTimer &timer);
+
+    Plan extract_plan() const;
+
+protected:
+    virtual void initialize() override;
+    virtual SearchStatus step() override;
+
+public:
+    explicit LazyParallelSearch(const plugins::Options &opts);
+    virtual ~LazyParallelSearch() override;
+
+    virtual void print_statistics() const override;
+};
+}
+
+#endif
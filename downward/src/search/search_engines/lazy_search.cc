@@ -1,5 +1,6 @@
 #include "lazy_search.h"
 
+#include "../batch_evaluator.h"
 #include "../open_list_factory.h"
 
 #include "../algorithms/ordered_set.h"
@@ -30,13 +31,17 @@ LazySearch::LazySearch(const plugins::Options &opts)
       current_operator_id(OperatorID::no_operator),
       current_g(0),
       current_real_g(0),
-      current_eval_context(current_state, 0, true, &statistics) {
+      current_eval_context(current_state, 0, true, &statistics),
+      batch_evaluator(create_batch_evaluator(opts, log)) {
     /*
       We initialize current_eval_context in such a way that the initial node
       counts as "preferred".
     */
 }
 
+LazySearch::~LazySearch() {
+}
+
 void LazySearch::set_preferred_operator_evaluators(
     vector<shared_ptr<Evaluator>> &evaluators) {
     preferred_operator_evaluators = evaluators;
@@ -115,16 +120,66 @@ void LazySearch::generate_successors() {
     }
 }
 
+/*
+  Remove up to one edge per evaluation thread from the open list and compute
+  the heuristic values of their target states in parallel. The edges are
+  processed in the order in which they were removed, so the search behaves
+  like a serial lazy search that expands the states of a batch without
+  looking at the successors of the earlier states in the batch.
+*/
+void LazySearch::prefetch_edges() {
+    assert(prefetched_edges.empty());
+    int batch_size = batch_evaluator->get_num_threads();
+    vector<State> batch;
+    vector<int> batch_indices;
+    while (static_cast<int>(prefetched_edges.size()) < batch_size &&
+           !open_list->empty()) {
+        EdgeOpenListEntry next = open_list->remove_min();
+        State predecessor = state_registry.lookup_state(next.first);
+        OperatorProxy op = task_proxy.get_operators()[next.second];
+        State state = state_registry.get_successor_state(predecessor, op);
+
+        int batch_index = -1;
+        if (search_space.get_node(state).is_new()) {
+            auto it = find_if(batch.begin(), batch.end(),
+                              [&](const State &batched_state) {
+                                  return batched_state.get_id() == state.get_id();
+                              });
+            batch_index = it - batch.begin();
+            if (it == batch.end())
+                batch.push_back(state);
+        }
+        batch_indices.push_back(batch_index);
+        prefetched_edges.push_back(
+            {next.first, next.second, EvaluationContext(state)});
+    }
+
+    vector<EvaluationContext> batch_contexts =
+        batch_evaluator->evaluate(batch, statistics);
+    for (size_t i = 0; i < prefetched_edges.size(); ++i) {
+        if (batch_indices[i] != -1)
+            prefetched_edges[i].eval_context = batch_contexts[batch_indices[i]];
+    }
+}
+
 SearchStatus LazySearch::fetch_next_state() {
-    if (open_list->empty()) {
+    if (batch_evaluator && batch_evaluator->is_initialized() &&
+        prefetched_edges.empty())
+        prefetch_edges();
+
+    if (prefetched_edges.empty() && open_list->empty()) {
         log << "Completely explored state space -- no solution!" << endl;
         return FAILED;
     }
 
-    EdgeOpenListEntry next = open_list->remove_min();
-
-    current_predecessor_id = next.first;
-    current_operator_id = next.second;
+    if (prefetched_edges.empty()) {
+        EdgeOpenListEntry next = open_list->remove_min();
+        current_predecessor_id = next.first;
+        current_operator_id = next.second;
+    } else {
+        current_predecessor_id = prefetched_edges.front().predecessor_id;
+        current_operator_id = prefetched_edges.front().operator_id;
+    }
     State current_predecessor = state_registry.lookup_state(current_predecessor_id);
     OperatorProxy current_operator = task_proxy.get_operators()[current_operator_id];
     assert(task_properties::is_applicable(current_operator, current_predecessor));
@@ -142,7 +197,13 @@ SearchStatus LazySearch::fetch_next_state() {
       associate with the expanded vs. evaluated nodes in lazy search
       and where to obtain it from.
     */
-    current_eval_context = EvaluationContext(current_state, current_g, true, &statistics);
+    if (prefetched_edges.empty()) {
+        current_eval_context = EvaluationContext(current_state, current_g, true, &statistics);
+    } else {
+        current_eval_context = EvaluationContext(
+            prefetched_edges.front().eval_context, current_g, true, &statistics);
+        prefetched_edges.pop_front();
+    }
 
     return IN_PROGRESS;
 }
@@ -203,6 +264,8 @@ SearchStatus LazySearch::step() {
         }
         if (current_predecessor_id == StateID::no_state) {
             print_initial_evaluator_values(current_eval_context);
+            if (batch_evaluator)
+                batch_evaluator->initialize(current_eval_context);
         }
     }
     return fetch_next_state();
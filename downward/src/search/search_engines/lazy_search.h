@@ -11,10 +11,24 @@
 
 #include "../utils/rng.h"
 
+#include <deque>
 #include <memory>
 #include <vector>
 
+class BatchEvaluator;
+
 namespace lazy_search {
+/*
+  An edge that has been removed from the open list before its turn, together
+  with an evaluation context for its target state that holds the heuristic
+  values computed by the batch evaluator.
+*/
+struct PrefetchedEdge {
+    StateID predecessor_id;
+    OperatorID operator_id;
+    EvaluationContext eval_context;
+};
+
 class LazySearch : public SearchEngine {
 protected:
     std::unique_ptr<EdgeOpenList> open_list;
@@ -35,11 +49,15 @@ protected:
     int current_real_g;
     EvaluationContext current_eval_context;
 
+    std::unique_ptr<BatchEvaluator> batch_evaluator;
+    std::deque<PrefetchedEdge> prefetched_edges;
+
     virtual void initialize() override;
     virtual SearchStatus step() override;
 
     void generate_successors();
     SearchStatus fetch_next_state();
+    void prefetch_edges();
 
     void reward_progress();
 
@@ -48,7 +66,7 @@ protected:
 
 public:
     explicit LazySearch(const plugins::Options &opts);
-    virtual ~LazySearch() = default;
+    virtual ~LazySearch() override;
 
     void set_preferred_operator_evaluators(std::vector<std::shared_ptr<Evaluator>> &evaluators);
 
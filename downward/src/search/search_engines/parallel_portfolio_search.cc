@@ -0,0 +1,206 @@
+#include "parallel_portfolio_search.h"
+
+#include "../plugins/plugin.h"
+#include "../utils/countdown_timer.h"
+#include "../utils/logging.h"
+#include "../utils/system.h"
+
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <thread>
+
+using namespace std;
+
+namespace parallel_portfolio_search {
+ParallelPortfolioSearch::ParallelPortfolioSearch(const plugins::Options &opts)
+    : SearchEngine(opts),
+      engine_configs(opts.get_list<parser::LazyValue>("engine_configs")),
+      continue_on_solve(opts.get<bool>("continue_on_solve")),
+      num_running_engines(0),
+      best_bound(bound) {
+}
+
+void ParallelPortfolioSearch::initialize() {
+    /*
+      Construct all engines before starting the first thread: construction
+      computes and caches the per-task information (e.g., the successor
+      generator) and the preprocessing of shared components, which is not
+      thread-safe.
+    */
+    shared_info = make_shared<ConcurrentSearchInfo>(bound);
+    for (parser::LazyValue &engine_config : engine_configs) {
+        shared_ptr<SearchEngine> engine;
+        try {
+            engine = engine_config.construct<shared_ptr<SearchEngine>>();
+        } catch (const utils::ContextError &e) {
+            cerr << "Delayed construction of LazyValue failed" << endl;
+            cerr << e.get_message() << endl;
+            utils::exit_with(utils::ExitCode::SEARCH_INPUT_ERROR);
+        }
+        engine->set_bound(min(engine->get_bound(), bound));
+        engine->set_concurrent_search_info(shared_info);
+        engines.push_back(engine);
+    }
+    log << "Running " << engines.size() << " searches in parallel." << endl;
+}
+
+void ParallelPortfolioSearch::run_engine(SearchEngine &engine) {
+    engine.search();
+
+    lock_guard<mutex> lock(engines_mutex);
+    if (engine.found_solution()) {
+        const Plan &found_plan = engine.get_plan();
+        int plan_cost = calculate_plan_cost(found_plan, task_proxy);
+        if (plan_cost < best_bound) {
+            log << "Solution of cost " << plan_cost << " found by search: "
+                << engine.get_description() << endl;
+            best_bound = plan_cost;
+            set_plan(found_plan);
+            if (continue_on_solve) {
+                plan_manager.save_plan(found_plan, task_proxy, true);
+            }
+        }
+        if (!continue_on_solve) {
+            shared_info->request_stop();
+        }
+    }
+    --num_running_engines;
+    engine_finished.notify_one();
+}
+
+SearchStatus ParallelPortfolioSearch::step() {
+    num_running_engines = engines.size();
+    vector<thread> threads;
+    threads.reserve(engines.size());
+    for (const shared_ptr<SearchEngine> &engine : engines) {
+        threads.emplace_back(
+            &ParallelPortfolioSearch::run_engine, this, ref(*engine));
+    }
+
+    bool timed_out = false;
+    {
+        unique_lock<mutex> lock(engines_mutex);
+        auto all_engines_finished = [this]() {
+                return num_running_engines == 0;
+            };
+        if (isinf(max_time)) {
+            engine_finished.wait(lock, all_engines_finished);
+        } else if (!engine_finished.wait_for(
+                       lock, chrono::duration<double>(max_time),
+                       all_engines_finished)) {
+            log << "Time limit reached. Stop all searches." << endl;
+            shared_info->request_stop();
+            timed_out = true;
+        }
+    }
+    for (thread &t : threads) {
+        t.join();
+    }
+
+    bool some_engine_timed_out = false;
+    for (const shared_ptr<SearchEngine> &engine : engines) {
+        log << "Statistics of search: " << engine->get_description() << endl;
+        engine->print_statistics();
+
+        const SearchStatistics &engine_stats = engine->get_statistics();
+        statistics.inc_expanded(engine_stats.get_expanded());
+        statistics.inc_evaluated_states(engine_stats.get_evaluated_states());
+        statistics.inc_evaluations(engine_stats.get_evaluations());
+        statistics.inc_generated(engine_stats.get_generated());
+        statistics.inc_generated_ops(engine_stats.get_generated_ops());
+        statistics.inc_reopened(engine_stats.get_reopened());
+
+        if (engine->get_status() == TIMEOUT)
+            some_engine_timed_out = true;
+    }
+
+    if (found_solution()) {
+        log << "Best solution cost: " << best_bound << endl;
+        return SOLVED;
+    }
+    /*
+      Engines that were stopped report a timeout, so the portfolio only
+      failed if all engines completed their search without a plan.
+    */
+    return (timed_out || some_engine_timed_out) ? TIMEOUT : FAILED;
+}
+
+void ParallelPortfolioSearch::print_statistics() const {
+    log << "Cumulative statistics:" << endl;
+    statistics.print_detailed_statistics();
+}
+
+void ParallelPortfolioSearch::save_plan_if_necessary() {
+    // With continue_on_solve, we save each improving plan as it is found.
+    if (!continue_on_solve) {
+        SearchEngine::save_plan_if_necessary();
+    }
+}
+
+class ParallelPortfolioSearchFeature
+    : public plugins::TypedFeature<SearchEngine, ParallelPortfolioSearch> {
+public:
+    ParallelPortfolioSearchFeature() : TypedFeature("parallel_portfolio") {
+        document_title("Parallel portfolio search");
+        document_synopsis(
+            "Runs several search engines concurrently, each on its own "
+            "thread. All engines share the per-task information (e.g., the "
+            "successor generator and the causal graph) and prune states with "
+            "the cost of the best plan that any of them has found so far.");
+
+        add_list_option<shared_ptr<SearchEngine>>(
+            "engine_configs",
+            "list of search engines that run in parallel",
+            "",
+            true);
+        add_option<bool>(
+            "continue_on_solve",
+            "keep the other searches running after a solution is found and "
+            "save every plan that improves on the best one so far",
+            "false");
+        SearchEngine::add_options_to_feature(*this);
+
+        document_note(
+            "Sharing components",
+            "Components that are predefined with --evaluator or let and used "
+            "by several configurations are constructed only once. This works "
+            "for components that are only used during construction, such as "
+            "landmark factories:\n```\n"
+            "--search \"let(lmg, lm_rhw(), parallel_portfolio(["
+            "lazy_greedy([landmark_sum(lmg)]), "
+            "lazy_wastar([landmark_sum(lmg)], w=3)]))\"\n"
+            "```\n"
+            "Evaluators cache information per state and must not be "
+            "shared between configurations, since the searches would "
+            "modify them concurrently.");
+        document_note(
+            "Random numbers",
+            "Components that use the global random number generator "
+            "(random_seed=-1) are not thread-safe. Set random_seed for all "
+            "such components in the portfolio.");
+        document_note(
+            "Stopping",
+            "Engines check between search steps whether they should stop. "
+            "Engines that do all their work in one step (e.g., the parallel "
+            "search engines) only stop when they reach their own time limit.");
+        document_note(
+            "Anytime searches",
+            "Iterated searches save each plan they find themselves. If the "
+            "portfolio contains several of them, they write to the same plan "
+            "files, so only use one anytime search per portfolio.");
+    }
+
+    virtual shared_ptr<ParallelPortfolioSearch> create_component(const plugins::Options &options, const utils::Context &context) const override {
+        plugins::Options options_copy(options);
+        // See IteratedSearchFeature::create_component.
+        vector<parser::LazyValue> engine_configs =
+            options.get<parser::LazyValue>("engine_configs").construct_lazy_list();
+        options_copy.set("engine_configs", engine_configs);
+        plugins::verify_list_non_empty<parser::LazyValue>(context, options_copy, "engine_configs");
+        return make_shared<ParallelPortfolioSearch>(options_copy);
+    }
+};
+
+static plugins::FeaturePlugin<ParallelPortfolioSearchFeature> _plugin;
+}
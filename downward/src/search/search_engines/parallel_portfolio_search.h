@@ -0,0 +1,51 @@
+#ifndef SEARCH_ENGINES_PARALLEL_PORTFOLIO_SEARCH_H
+#define SEARCH_ENGINES_PARALLEL_PORTFOLIO_SEARCH_H
+
+#include "../search_engine.h"
+
+#include "../parser/decorated_abstract_syntax_tree.h"
+
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace parallel_portfolio_search {
+/*
+  Run several search engines on the same task concurrently, one thread per
+  engine. The engines are constructed one after the other on the main
+  thread, so components that are predefined and shared between the
+  configurations (e.g., landmark factories) are only computed once.
+
+  Engines share a ConcurrentSearchInfo: a plan found by one engine bounds
+  the searches of all others. Unless continue_on_solve is set, the first
+  plan stops the portfolio.
+*/
+class ParallelPortfolioSearch : public SearchEngine {
+    std::vector<parser::LazyValue> engine_configs;
+    bool continue_on_solve;
+
+    std::vector<std::shared_ptr<SearchEngine>> engines;
+    std::shared_ptr<ConcurrentSearchInfo> shared_info;
+
+    // Protects the best plan and the number of running engines.
+    std::mutex engines_mutex;
+    std::condition_variable engine_finished;
+    int num_running_engines;
+    int best_bound;
+
+    void run_engine(SearchEngine &engine);
+
+protected:
+    virtual void initialize() override;
+    virtual SearchStatus step() override;
+
+public:
+    explicit ParallelPortfolioSearch(const plugins::Options &opts);
+
+    virtual void save_plan_if_necessary() override;
+    virtual void print_statistics() const override;
+};
+}
+
+#endif
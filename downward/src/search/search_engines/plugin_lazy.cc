@@ -1,6 +1,8 @@
 #include "lazy_search.h"
 #include "search_common.h"
 
+#include "../batch_evaluator.h"
+
 #include "../plugins/plugin.h"
 
 using namespace std;
@@ -18,6 +20,7 @@ public:
             "preferred",
             "use preferred operators of these evaluators", "[]");
         SearchEngine::add_succ_order_options(*this);
+        add_batch_evaluation_option_to_feature(*this);
         SearchEngine::add_options_to_feature(*this);
     }
 
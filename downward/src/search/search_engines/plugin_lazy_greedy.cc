@@ -1,6 +1,8 @@
 #include "lazy_search.h"
 #include "search_common.h"
 
+#include "../batch_evaluator.h"
+
 #include "../plugins/plugin.h"
 
 using namespace std;
@@ -31,6 +33,7 @@ public:
             "to preferred operator nodes",
             DEFAULT_LAZY_BOOST);
         SearchEngine::add_succ_order_options(*this);
+        add_batch_evaluation_option_to_feature(*this);
         SearchEngine::add_options_to_feature(*this);
 
         document_note(
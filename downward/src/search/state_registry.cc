@@ -5,29 +5,75 @@
 
 #include "task_utils/task_properties.h"
 #include "utils/logging.h"
+#include "utils/memory.h"
+
+#include <algorithm>
 
 using namespace std;
 
-StateRegistry::StateRegistry(const TaskProxy &task_proxy)
+StateRegistry::StateRegistry(
+    const TaskProxy &task_proxy, int max_delta_depth, int decoded_cache_size)
     : task_proxy(task_proxy),
       state_packer(task_properties::g_state_packers[task_proxy]),
       axiom_evaluator(g_axiom_evaluators[task_proxy]),
       num_variables(task_proxy.get_variables().size()),
       state_data_pool(get_bins_per_state()),
       registered_states(
-          StateIDSemanticHash(state_data_pool, get_bins_per_state()),
-          StateIDSemanticEqual(state_data_pool, get_bins_per_state())) {
+          StateIDSemanticHash(state_data_pool, delta_pool, get_bins_per_state()),
+          StateIDSemanticEqual(state_data_pool, delta_pool, get_bins_per_state())),
+      use_incremental_hashing(
+          utils::get_num_word_chunks(get_bins_per_state()) >
+          MAX_CHUNKS_FOR_FULL_HASHING),
+      cached_hash_sum_id(StateID::no_state),
+      cached_hash_sum(0) {
+    if (max_delta_depth > 0 &&
+        DeltaStatePool::is_worth_compressing(this->task_proxy, state_packer)) {
+        delta_pool = utils::make_unique_ptr<DeltaStatePool>(
+            this->task_proxy, state_packer, max_delta_depth,
+            decoded_cache_size);
+        successor_buffer.resize(get_bins_per_state());
+    }
 }
 
-StateID StateRegistry::insert_id_or_pop_state() {
+uint64_t StateRegistry::get_hash_sum(const State &predecessor) {
+    if (predecessor.get_registry() != this) {
+        return utils::get_word_array_hash_sum(
+            predecessor.get_buffer(), get_bins_per_state());
+    }
+    if (predecessor.get_id() != cached_hash_sum_id) {
+        cached_hash_sum_id = predecessor.get_id();
+        cached_hash_sum = utils::get_word_array_hash_sum(
+            predecessor.get_buffer(), get_bins_per_state());
+    }
+    return cached_hash_sum;
+}
+
+int_hash_set::HashType StateRegistry::get_hash(
+    const PackedStateBin *buffer) const {
+    return utils::finalize_word_array_hash(
+        utils::get_word_array_hash_sum(buffer, get_bins_per_state()));
+}
+
+StateID StateRegistry::insert_id_or_pop_state(int_hash_set::HashType hash) {
     /*
       Attempt to insert a StateID for the last state of state_data_pool
       if none is present yet. If this fails (another entry for this state
       is present), we have to remove the duplicate entry from the
-      state data pool.
+      state data pool. The given hash must be the hash of the last state.
     */
+    if (delta_pool) {
+        StateID id(delta_pool->size() - 1);
+        pair<int, bool> result =
+            registered_states.insert_with_hash(id.value, hash);
+        bool is_new_entry = result.second;
+        if (!is_new_entry) {
+            delta_pool->pop_back();
+        }
+        assert(registered_states.size() == static_cast<int>(delta_pool->size()));
+        return StateID(result.first);
+    }
     StateID id(state_data_pool.size() - 1);
-    pair<int, bool> result = registered_states.insert(id.value);
+    pair<int, bool> result = registered_states.insert_with_hash(id.value, hash);
     bool is_new_entry = result.second;
     if (!is_new_entry) {
         state_data_pool.pop_back();
@@ -37,6 +83,9 @@ StateID StateRegistry::insert_id_or_pop_state() {
 }
 
 State StateRegistry::lookup_state(StateID id) const {
+    if (delta_pool) {
+        return task_proxy.create_state(*this, id, delta_pool->lookup(id.value));
+    }
     const PackedStateBin *buffer = state_data_pool[id.value];
     return task_proxy.create_state(*this, id, buffer);
 }
@@ -52,8 +101,12 @@ const State &StateRegistry::get_initial_state() {
         for (size_t i = 0; i < initial_state.size(); ++i) {
             state_packer.set(buffer.get(), i, initial_state[i].get_value());
         }
-        state_data_pool.push_back(buffer.get());
-        StateID id = insert_id_or_pop_state();
+        if (delta_pool) {
+            delta_pool->push_back(buffer.get());
+        } else {
+            state_data_pool.push_back(buffer.get());
+        }
+        StateID id = insert_id_or_pop_state(get_hash(buffer.get()));
         cached_initial_state = utils::make_unique_ptr<State>(lookup_state(id));
     }
     return *cached_initial_state;
@@ -64,8 +117,16 @@ const State &StateRegistry::get_initial_state() {
 //     operating on state buffers (PackedStateBin *).
 State StateRegistry::get_successor_state(const State &predecessor, const OperatorProxy &op) {
     assert(!op.is_axiom());
-    state_data_pool.push_back(predecessor.get_buffer());
-    PackedStateBin *buffer = state_data_pool[state_data_pool.size() - 1];
+    PackedStateBin *buffer;
+    if (delta_pool) {
+        const PackedStateBin *predecessor_buffer = predecessor.get_buffer();
+        copy(predecessor_buffer, predecessor_buffer + get_bins_per_state(),
+             successor_buffer.begin());
+        buffer = successor_buffer.data();
+    } else {
+        state_data_pool.push_back(predecessor.get_buffer());
+        buffer = state_data_pool[state_data_pool.size() - 1];
+    }
     /* Experiments for issue348 showed that for tasks with axioms it's faster
        to compute successor states using unpacked data. */
     if (task_properties::has_axioms(task_proxy)) {
@@ -81,20 +142,70 @@ State StateRegistry::get_successor_state(const State &predecessor, const Operato
         for (size_t i = 0; i < new_values.size(); ++i) {
             state_packer.set(buffer, i, new_values[i]);
         }
-        StateID id = insert_id_or_pop_state();
+        // Tasks with axioms never use delta_pool.
+        assert(!delta_pool);
+        StateID id = insert_id_or_pop_state(get_hash(buffer));
         return task_proxy.create_state(*this, id, buffer, move(new_values));
     } else {
+        changed_chunks.clear();
         for (EffectProxy effect : op.get_effects()) {
             if (does_fire(effect, predecessor)) {
                 FactPair effect_pair = effect.get_fact().get_pair();
                 state_packer.set(buffer, effect_pair.var, effect_pair.value);
+                if (use_incremental_hashing) {
+                    int chunk = state_packer.get_bin_index(effect_pair.var) / 2;
+                    if (find(changed_chunks.begin(), changed_chunks.end(),
+                             chunk) == changed_chunks.end()) {
+                        changed_chunks.push_back(chunk);
+                    }
+                }
+            }
+        }
+        int_hash_set::HashType hash;
+        if (use_incremental_hashing) {
+            int num_bins = get_bins_per_state();
+            const PackedStateBin *predecessor_buffer = predecessor.get_buffer();
+            uint64_t hash_sum = get_hash_sum(predecessor);
+            for (int chunk : changed_chunks) {
+                hash_sum -= utils::get_word_chunk_hash(
+                    predecessor_buffer, num_bins, chunk);
+                hash_sum += utils::get_word_chunk_hash(buffer, num_bins, chunk);
             }
+            hash = utils::finalize_word_array_hash(hash_sum);
+        } else {
+            hash = get_hash(buffer);
+        }
+        if (delta_pool) {
+            return insert_successor_buffer(predecessor, op.get_id(), hash);
         }
-        StateID id = insert_id_or_pop_state();
+        StateID id = insert_id_or_pop_state(hash);
         return task_proxy.create_state(*this, id, buffer);
     }
 }
 
+State StateRegistry::insert_successor_buffer(
+    const State &predecessor, int op_id, int_hash_set::HashType hash) {
+    assert(delta_pool);
+    if (predecessor.get_registry() == this) {
+        delta_pool->push_back(successor_buffer.data(),
+                              predecessor.get_id().value, op_id);
+    } else {
+        delta_pool->push_back(successor_buffer.data());
+    }
+    StateID id = insert_id_or_pop_state(hash);
+    return lookup_state(id);
+}
+
+State StateRegistry::insert_state(const PackedStateBin *buffer) {
+    if (delta_pool) {
+        delta_pool->push_back(buffer);
+    } else {
+        state_data_pool.push_back(buffer);
+    }
+    StateID id = insert_id_or_pop_state(get_hash(buffer));
+    return lookup_state(id);
+}
+
 int StateRegistry::get_bins_per_state() const {
     return state_packer.get_num_bins();
 }
@@ -106,4 +217,7 @@ int StateRegistry::get_state_size_in_bytes() const {
 void StateRegistry::print_statistics(utils::LogProxy &log) const {
     log << "Number of registered states: " << size() << endl;
     registered_states.print_statistics(log);
+    if (delta_pool) {
+        delta_pool->print_statistics(log);
+    }
 }
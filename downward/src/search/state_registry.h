@@ -3,6 +3,7 @@
 
 #include "abstract_task.h"
 #include "axioms.h"
+#include "delta_state_pool.h"
 #include "state_id.h"
 
 #include "algorithms/int_hash_set.h"
@@ -11,6 +12,7 @@
 #include "algorithms/subscriber.h"
 #include "utils/hash.h"
 
+#include <memory>
 #include <set>
 
 /*
@@ -59,6 +61,11 @@
     while avoiding dynamically allocating each state individually.
     The index within this vector corresponds to the ID of the state.
 
+  DeltaStatePool
+    Optionally, the registry stores most states as differences to their
+    parent states instead (see delta_state_pool.h). Registered states then
+    share ownership of a decoded copy of their data.
+
   PerStateInformation<T>
     Associates a value of type T with every state in a given StateRegistry.
     Can be thought of as a very compactly implemented map from State to T.
@@ -115,35 +122,51 @@ using PackedStateBin = int_packer::IntPacker::Bin;
 class StateRegistry : public subscriber::SubscriberService<StateRegistry> {
     struct StateIDSemanticHash {
         const segmented_vector::SegmentedArrayVector<PackedStateBin> &state_data_pool;
+        const std::unique_ptr<DeltaStatePool> &delta_pool;
         int state_size;
         StateIDSemanticHash(
             const segmented_vector::SegmentedArrayVector<PackedStateBin> &state_data_pool,
+            const std::unique_ptr<DeltaStatePool> &delta_pool,
             int state_size)
             : state_data_pool(state_data_pool),
+              delta_pool(delta_pool),
               state_size(state_size) {
         }
 
+        int_hash_set::HashType get_hash(const PackedStateBin *data) const {
+            return utils::finalize_word_array_hash(
+                utils::get_word_array_hash_sum(data, state_size));
+        }
+
         int_hash_set::HashType operator()(int id) const {
-            const PackedStateBin *data = state_data_pool[id];
-            utils::HashState hash_state;
-            for (int i = 0; i < state_size; ++i) {
-                hash_state.feed(data[i]);
+            if (delta_pool) {
+                return get_hash(delta_pool->lookup(id)->data());
             }
-            return hash_state.get_hash32();
+            return get_hash(state_data_pool[id]);
         }
     };
 
     struct StateIDSemanticEqual {
         const segmented_vector::SegmentedArrayVector<PackedStateBin> &state_data_pool;
+        const std::unique_ptr<DeltaStatePool> &delta_pool;
         int state_size;
         StateIDSemanticEqual(
             const segmented_vector::SegmentedArrayVector<PackedStateBin> &state_data_pool,
+            const std::unique_ptr<DeltaStatePool> &delta_pool,
             int state_size)
             : state_data_pool(state_data_pool),
+              delta_pool(delta_pool),
               state_size(state_size) {
         }
 
         bool operator()(int lhs, int rhs) const {
+            if (delta_pool) {
+                std::shared_ptr<const std::vector<PackedStateBin>> lhs_data =
+                    delta_pool->lookup(lhs);
+                std::shared_ptr<const std::vector<PackedStateBin>> rhs_data =
+                    delta_pool->lookup(rhs);
+                return *lhs_data == *rhs_data;
+            }
             const PackedStateBin *lhs_data = state_data_pool[lhs];
             const PackedStateBin *rhs_data = state_data_pool[rhs];
             return std::equal(lhs_data, lhs_data + state_size, rhs_data);
@@ -163,14 +186,43 @@ class StateRegistry : public subscriber::SubscriberService<StateRegistry> {
     const int num_variables;
 
     segmented_vector::SegmentedArrayVector<PackedStateBin> state_data_pool;
+    // Replaces state_data_pool if states are stored as deltas.
+    std::unique_ptr<DeltaStatePool> delta_pool;
+    std::vector<PackedStateBin> successor_buffer;
     StateIDSet registered_states;
 
     std::unique_ptr<State> cached_initial_state;
 
-    StateID insert_id_or_pop_state();
+    /*
+      Successors of a state are usually generated in a row, so we cache the
+      hash sum (see utils::get_word_array_hash_sum()) of the last predecessor
+      and compute the hashes of its successors incrementally from the chunks
+      that the operator changes. For states with at most
+      MAX_CHUNKS_FOR_FULL_HASHING chunks, hashing the successor from scratch
+      is as fast (see experiments/state-hashing/hash-microbenchmark).
+    */
+    static const int MAX_CHUNKS_FOR_FULL_HASHING = 2;
+    const bool use_incremental_hashing;
+    StateID cached_hash_sum_id;
+    std::uint64_t cached_hash_sum;
+    std::vector<int> changed_chunks;
+
+    std::uint64_t get_hash_sum(const State &predecessor);
+    int_hash_set::HashType get_hash(const PackedStateBin *buffer) const;
+    StateID insert_id_or_pop_state(int_hash_set::HashType hash);
+    State insert_successor_buffer(
+        const State &predecessor, int op_id, int_hash_set::HashType hash);
     int get_bins_per_state() const;
 public:
-    explicit StateRegistry(const TaskProxy &task_proxy);
+    /*
+      With max_delta_depth > 0, states are stored as deltas to their parents
+      if this saves memory and the task has no axioms (see DeltaStatePool).
+      The registry then keeps the decoded data of up to decoded_cache_size
+      states in memory.
+    */
+    explicit StateRegistry(
+        const TaskProxy &task_proxy, int max_delta_depth = 0,
+        int decoded_cache_size = 0);
 
     const TaskProxy &get_task_proxy() const {
         return task_proxy;
@@ -203,6 +255,16 @@ public:
     */
     State get_successor_state(const State &predecessor, const OperatorProxy &op);
 
+    /*
+      Returns the state with the given packed data and registers it if this
+      was not done before. The buffer must have the layout of the buffers of
+      this registry (with unused bits set to zero), for example because it was
+      copied from a state of another registry for the same task and modified
+      with the state packer. This allows searches that use several registries
+      (e.g., one per thread) to move states between them.
+    */
+    State insert_state(const PackedStateBin *buffer);
+
     /*
       Returns the number of states registered so far.
     */
@@ -212,6 +274,10 @@ public:
 
     int get_state_size_in_bytes() const;
 
+    bool stores_deltas() const {
+        return delta_pool != nullptr;
+    }
+
     void print_statistics(utils::LogProxy &log) const;
 
     class const_iterator {
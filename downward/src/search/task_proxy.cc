@@ -28,6 +28,15 @@ State::State(const AbstractTask &task, const StateRegistry &registry,
     this->values = make_shared<vector<int>>(move(values));
 }
 
+State::State(const AbstractTask &task, const StateRegistry &registry,
+             StateID id,
+             const shared_ptr<const vector<PackedStateBin>> &buffer)
+    : State(task, registry, id, buffer->data()) {
+    assert(static_cast<int>(buffer->size()) ==
+           registry.get_state_packer().get_num_bins());
+    owned_buffer = buffer;
+}
+
 State::State(const AbstractTask &task, vector<int> &&values)
     : task(&task), registry(nullptr), id(StateID::no_state), buffer(nullptr),
       values(make_shared<vector<int>>(move(values))),
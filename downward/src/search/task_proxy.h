@@ -568,6 +568,12 @@ class State {
     const StateRegistry *registry;
     StateID id;
     const PackedStateBin *buffer;
+    /*
+      Registries that store states in compressed form (see DeltaStatePool)
+      decode them on demand. Such states keep their decoded data alive
+      through owned_buffer, and buffer points into it.
+    */
+    std::shared_ptr<const std::vector<PackedStateBin>> owned_buffer;
     /*
       values is mutable because we think of it as a redundant representation
       of the state's contents, a kind of cache. One could argue for doing this
@@ -590,6 +596,9 @@ public:
     // Construct a registered state with packed and unpacked data.
     State(const AbstractTask &task, const StateRegistry &registry, StateID id,
           const PackedStateBin *buffer, std::vector<int> &&values);
+    // Construct a registered state that shares ownership of its packed data.
+    State(const AbstractTask &task, const StateRegistry &registry, StateID id,
+          const std::shared_ptr<const std::vector<PackedStateBin>> &buffer);
     // Construct a state with only unpacked data.
     State(const AbstractTask &task, std::vector<int> &&values);
 
@@ -699,6 +708,13 @@ public:
         return State(*task, registry, id, buffer, std::move(state_values));
     }
 
+    // This method is meant to be called only by the state registry.
+    State create_state(
+        const StateRegistry &registry, StateID id,
+        const std::shared_ptr<const std::vector<PackedStateBin>> &buffer) const {
+        return State(*task, registry, id, buffer);
+    }
+
     State get_initial_state() const {
         return create_state(task->get_initial_state_values());
     }
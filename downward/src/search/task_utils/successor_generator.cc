@@ -1,21 +1,52 @@
 #include "successor_generator.h"
 
+#include "successor_generator_bitmask.h"
 #include "successor_generator_factory.h"
 #include "successor_generator_internals.h"
+#include "task_properties.h"
 
 #include "../abstract_task.h"
+#include "../state_registry.h"
+
+#include "../utils/memory.h"
 
 using namespace std;
 
 namespace successor_generator {
+/*
+  The decision tree needs the unpacked state, and unpacking costs about as
+  much as a few word operations per variable. The bit-parallel test is
+  faster if it needs at most this many word operations per variable.
+*/
+static const int MAX_BITMASK_COST_PER_VARIABLE = 4;
+
+static bool use_bitmask_generator(const TaskProxy &task_proxy) {
+    int num_variables = task_proxy.get_variables().size();
+    return GeneratorBitmask::estimate_cost(task_proxy) <=
+           static_cast<long long>(MAX_BITMASK_COST_PER_VARIABLE) * num_variables;
+}
+
 SuccessorGenerator::SuccessorGenerator(const TaskProxy &task_proxy)
-    : root(SuccessorGeneratorFactory(task_proxy).create()) {
+    : state_packer(task_properties::g_state_packers[task_proxy]) {
+    SuccessorGeneratorFactory factory(task_proxy);
+    root = factory.create();
+    if (use_bitmask_generator(task_proxy)) {
+        bitmask_generator = utils::make_unique_ptr<GeneratorBitmask>(
+            task_proxy, state_packer, factory.get_operator_order());
+    }
 }
 
 SuccessorGenerator::~SuccessorGenerator() = default;
 
 void SuccessorGenerator::generate_applicable_ops(
     const State &state, vector<OperatorID> &applicable_ops) const {
+    const StateRegistry *registry = state.get_registry();
+    if (bitmask_generator && registry &&
+        &registry->get_state_packer() == &state_packer) {
+        bitmask_generator->generate_applicable_ops(
+            state.get_buffer(), applicable_ops);
+        return;
+    }
     state.unpack();
     root->generate_applicable_ops(state.get_unpacked_values(), applicable_ops);
 }
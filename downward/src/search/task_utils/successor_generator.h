@@ -10,11 +10,26 @@ class OperatorID;
 class State;
 class TaskProxy;
 
+namespace int_packer {
+class IntPacker;
+}
+
 namespace successor_generator {
 class GeneratorBase;
-
+class GeneratorBitmask;
+
+/*
+  The successor generator uses a decision tree over the unpacked state
+  values (see successor_generator_factory.cc). For registered states, it
+  can alternatively test the operators on the packed state with bit masks
+  (see GeneratorBitmask). We use the bit masks if the task statistics
+  suggest that this is faster. Both report applicable operators in the
+  same order, so the choice does not affect the search.
+*/
 class SuccessorGenerator {
     std::unique_ptr<GeneratorBase> root;
+    const int_packer::IntPacker &state_packer;
+    std::unique_ptr<GeneratorBitmask> bitmask_generator;
 
 public:
     explicit SuccessorGenerator(const TaskProxy &task_proxy);
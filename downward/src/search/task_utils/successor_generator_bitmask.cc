@@ -0,0 +1,131 @@
+#include "successor_generator_bitmask.h"
+
+#include "../task_proxy.h"
+
+#include <algorithm>
+#include <bit>
+
+using namespace std;
+
+namespace successor_generator {
+static const int BITS_PER_WORD = 64;
+static const int MAX_LOCAL_WORDS = 16;
+
+static int get_num_words(int num_operators) {
+    return (num_operators + BITS_PER_WORD - 1) / BITS_PER_WORD;
+}
+
+long long GeneratorBitmask::estimate_cost(const TaskProxy &task_proxy) {
+    OperatorsProxy operators = task_proxy.get_operators();
+    vector<bool> is_precondition_var(task_proxy.get_variables().size(), false);
+    for (OperatorProxy op : operators) {
+        for (FactProxy pre : op.get_preconditions()) {
+            is_precondition_var[pre.get_variable().get_id()] = true;
+        }
+    }
+    long long num_precondition_vars =
+        count(is_precondition_var.begin(), is_precondition_var.end(), true);
+    return num_precondition_vars * get_num_words(operators.size());
+}
+
+GeneratorBitmask::GeneratorBitmask(
+    const TaskProxy &task_proxy, const int_packer::IntPacker &state_packer,
+    const vector<OperatorID> &operator_order)
+    : operators(operator_order),
+      num_words(get_num_words(operators.size())) {
+    VariablesProxy variables = task_proxy.get_variables();
+    OperatorsProxy task_operators = task_proxy.get_operators();
+
+    // Collect the precondition value of each operator (in the given order).
+    int num_variables = variables.size();
+    vector<vector<pair<int, int>>> preconditions_by_var(num_variables);
+    for (size_t op_index = 0; op_index < operators.size(); ++op_index) {
+        for (FactProxy pre : task_operators[operators[op_index]].get_preconditions()) {
+            FactPair fact = pre.get_pair();
+            preconditions_by_var[fact.var].emplace_back(op_index, fact.value);
+        }
+    }
+
+    Word all_operators = ~Word(0);
+    int num_values = 0;
+    for (int var = 0; var < num_variables; ++var) {
+        if (preconditions_by_var[var].empty())
+            continue;
+        PreconditionVariable precondition_var;
+        precondition_var.bin = state_packer.get_bin_index(var);
+        vector<Bin> buffer(state_packer.get_num_bins(), ~Bin(0));
+        state_packer.set(buffer.data(), var, 0);
+        precondition_var.read_mask = ~buffer[precondition_var.bin];
+        precondition_var.shift = countr_zero(precondition_var.read_mask);
+        precondition_var.first_value_index = num_values;
+        precondition_vars.push_back(precondition_var);
+
+        int domain_size = variables[var].get_domain_size();
+        num_values += domain_size;
+        // Initially, all operators are compatible with all values.
+        compatible_operators.resize(num_values * num_words, all_operators);
+        Word *var_sets =
+            &compatible_operators[precondition_var.first_value_index * num_words];
+        for (const pair<int, int> &precondition : preconditions_by_var[var]) {
+            int op_index = precondition.first;
+            Word bit = Word(1) << (op_index % BITS_PER_WORD);
+            for (int value = 0; value < domain_size; ++value) {
+                if (value != precondition.second) {
+                    var_sets[value * num_words + op_index / BITS_PER_WORD] &= ~bit;
+                }
+            }
+        }
+    }
+}
+
+void GeneratorBitmask::generate_applicable_ops(
+    const Bin *buffer, vector<OperatorID> &applicable_ops) const {
+    int num_operators = operators.size();
+    // Most tasks for which we use this class have at most 64 operators.
+    if (num_words == 1) {
+        Word bits = ~Word(0);
+        for (const PreconditionVariable &var : precondition_vars) {
+            bits &= compatible_operators[
+                var.first_value_index + var.get_value(buffer)];
+        }
+        while (bits) {
+            int op_index = countr_zero(bits);
+            if (op_index >= num_operators)
+                break;
+            applicable_ops.push_back(operators[op_index]);
+            bits &= bits - 1;
+        }
+        return;
+    }
+    /*
+      Avoid allocating memory for the intersection if the task has few
+      operators. The object is shared between threads, so we cannot reuse a
+      member for this.
+    */
+    Word local_words[MAX_LOCAL_WORDS];
+    vector<Word> heap_words;
+    Word *applicable = local_words;
+    if (num_words > MAX_LOCAL_WORDS) {
+        heap_words.resize(num_words);
+        applicable = heap_words.data();
+    }
+    fill(applicable, applicable + num_words, ~Word(0));
+    for (const PreconditionVariable &var : precondition_vars) {
+        const Word *compatible = &compatible_operators[
+            (var.first_value_index + var.get_value(buffer)) * num_words];
+        for (int word = 0; word < num_words; ++word) {
+            applicable[word] &= compatible[word];
+        }
+    }
+    for (int word = 0; word < num_words; ++word) {
+        Word bits = applicable[word];
+        while (bits) {
+            int op_index = word * BITS_PER_WORD + countr_zero(bits);
+            if (op_index >= num_operators)
+                break;
+            applicable_ops.push_back(operators[op_index]);
+            bits &= bits - 1;
+        }
+    }
+}
+}
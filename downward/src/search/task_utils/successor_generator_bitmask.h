@@ -0,0 +1,77 @@
+#ifndef TASK_UTILS_SUCCESSOR_GENERATOR_BITMASK_H
+#define TASK_UTILS_SUCCESSOR_GENERATOR_BITMASK_H
+
+#include "../operator_id.h"
+
+#include "../algorithms/int_packer.h"
+
+#include <cstdint>
+#include <vector>
+
+class TaskProxy;
+
+namespace successor_generator {
+/*
+  Bit-parallel applicability test that works directly on packed states.
+
+  Operators are numbered in the order in which the decision tree of the
+  SuccessorGenerator reports them, and sets of operators are represented
+  as bitsets of 64-bit words in this numbering. For each value d of each
+  variable v that occurs in a precondition, we precompute the set of
+  operators that are compatible with v = d, i.e., that have no precondition
+  on v or the precondition v = d. The applicable operators in a state are
+  the intersection of the compatible sets for the values of all these
+  variables. Computing it reads each value directly from the packed state
+  and intersects the sets word by word, which the compiler vectorizes. We
+  then report the operators in the intersection in increasing order, so the
+  result is the same as for the decision tree.
+
+  This needs num_precondition_vars * num_words word operations per state,
+  independently of the number of applicable operators, so it is only faster
+  than the decision tree for tasks with few operators or few precondition
+  variables (see estimate_cost()).
+*/
+class GeneratorBitmask {
+    using Bin = int_packer::IntPacker::Bin;
+    using Word = std::uint64_t;
+
+    /*
+      Variable that occurs in a precondition. We read its value from the
+      packed state without calling the IntPacker. The compatible set for
+      value d starts at compatible_operators[(first_value_index + d) *
+      num_words].
+    */
+    struct PreconditionVariable {
+        int bin;
+        Bin read_mask;
+        int shift;
+        int first_value_index;
+
+        int get_value(const Bin *buffer) const {
+            return (buffer[bin] & read_mask) >> shift;
+        }
+    };
+
+    std::vector<OperatorID> operators;
+    int num_words;
+    std::vector<PreconditionVariable> precondition_vars;
+    std::vector<Word> compatible_operators;
+
+public:
+    /*
+      Operators must be given in the order in which the decision tree
+      generates them.
+    */
+    GeneratorBitmask(
+        const TaskProxy &task_proxy, const int_packer::IntPacker &state_packer,
+        const std::vector<OperatorID> &operator_order);
+
+    void generate_applicable_ops(
+        const Bin *buffer, std::vector<OperatorID> &applicable_ops) const;
+
+    // Return the number of word operations needed per state for the task.
+    static long long estimate_cost(const TaskProxy &task_proxy);
+};
+}
+
+#endif
@@ -290,6 +290,14 @@ GeneratorPtr SuccessorGeneratorFactory::create() {
     /* Use stable_sort rather than sort for reproducibility.
        This amounts to breaking ties by operator ID. */
     stable_sort(operator_infos.begin(), operator_infos.end());
+    /*
+      The generator visits its children in the order of their operator
+      ranges, so it reports applicable operators in the sorted order.
+    */
+    operator_order.clear();
+    for (const OperatorInfo &op_info : operator_infos) {
+        operator_order.push_back(op_info.get_op());
+    }
 
     OperatorRange full_range(0, operator_infos.size());
     GeneratorPtr root = construct_recursive(0, full_range);
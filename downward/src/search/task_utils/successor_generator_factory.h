@@ -1,6 +1,8 @@
 #ifndef TASK_UTILS_SUCCESSOR_GENERATOR_FACTORY_H
 #define TASK_UTILS_SUCCESSOR_GENERATOR_FACTORY_H
 
+#include "../operator_id.h"
+
 #include <memory>
 #include <vector>
 
@@ -20,6 +22,7 @@ class SuccessorGeneratorFactory {
 
     const TaskProxy &task_proxy;
     std::vector<OperatorInfo> operator_infos;
+    std::vector<OperatorID> operator_order;
 
     GeneratorPtr construct_fork(std::vector<GeneratorPtr> nodes) const;
     GeneratorPtr construct_leaf(OperatorRange range) const;
@@ -31,6 +34,13 @@ public:
     // Destructor cannot be implicit because OperatorInfo is forward-declared.
     ~SuccessorGeneratorFactory();
     GeneratorPtr create();
+    /*
+      Return the operators in the order in which the generator built by
+      create() reports them if they are applicable.
+    */
+    const std::vector<OperatorID> &get_operator_order() const {
+        return operator_order;
+    }
 };
 }
 
@@ -4,15 +4,25 @@
 
 #include "../plugins/plugin.h"
 #include "../utils/collections.h"
+#include "../utils/system.h"
 #include "../utils/timer.h"
 
 #include <algorithm>
 #include <cassert>
+#include <cstdint>
+#include <cstring>
 #include <memory>
 #include <set>
 #include <unordered_set>
 #include <vector>
 
+#if OPERATING_SYSTEM == LINUX || OPERATING_SYSTEM == OSX
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
 
 using namespace std;
 using utils::ExitCode;
@@ -21,6 +31,42 @@ namespace tasks {
 static const int PRE_FILE_VERSION = 3;
 shared_ptr<AbstractTask> g_root_task = nullptr;
 
+/*
+  Header of a translator output file in the binary format (see
+  SASTask.output_binary in the translator). The body that follows the header
+  is a sequence of 32-bit integers in the byte order of the machine that wrote
+  it; strings are stored as their length in bytes followed by the characters,
+  padded to a multiple of four bytes.
+*/
+static const char BINARY_MAGIC[8] = {'F', 'D', 'S', 'A', 'S', 'B', 'I', 'N'};
+static const uint32_t BINARY_BYTE_ORDER_MARK = 0x01020304;
+
+struct BinaryHeader {
+    char magic[8];
+    uint32_t byte_order_mark;
+    int32_t version;
+    int64_t body_size;
+};
+static_assert(sizeof(BinaryHeader) == 24, "unexpected padding in BinaryHeader");
+
+class BinaryTaskReader {
+    const int32_t *pos;
+    const int32_t *end;
+
+    void check_available(size_t num_words) const;
+public:
+    BinaryTaskReader(const int32_t *body, size_t num_words);
+
+    int read_int();
+    int read_count();
+    vector<int> read_ints(int count);
+    vector<FactPair> read_facts();
+    string read_string();
+    bool at_end() const {
+        return pos == end;
+    }
+};
+
 struct ExplicitVariable {
     int domain_size;
     string name;
@@ -29,6 +75,7 @@ struct ExplicitVariable {
     int axiom_default_value;
 
     explicit ExplicitVariable(istream &in);
+    explicit ExplicitVariable(BinaryTaskReader &in);
 };
 
 
@@ -48,7 +95,9 @@ struct ExplicitOperator {
     bool is_an_axiom;
 
     void read_pre_post(istream &in);
+    void read_pre_post(BinaryTaskReader &in);
     ExplicitOperator(istream &in, bool is_an_axiom, bool use_metric);
+    ExplicitOperator(BinaryTaskReader &in, bool is_an_axiom, bool use_metric);
 };
 
 
@@ -64,9 +113,11 @@ class RootTask : public AbstractTask {
     const ExplicitVariable &get_variable(int var) const;
     const ExplicitEffect &get_effect(int op_id, int effect_id, bool is_axiom) const;
     const ExplicitOperator &get_operator_or_axiom(int index, bool is_axiom) const;
+    void initialize_axiom_values();
 
 public:
     explicit RootTask(istream &in);
+    explicit RootTask(BinaryTaskReader &in);
 
     virtual int get_num_variables() const override;
     virtual string get_variable_name(int var) const override;
@@ -102,6 +153,7 @@ public:
     virtual FactPair get_goal_fact(int index) const override;
 
     virtual vector<int> get_initial_state_values() const override;
+    void set_initial_state_values(const vector<int> &values);
     virtual void convert_ancestor_state_values(
         vector<int> &values,
         const AbstractTask *ancestor_task) const override;
@@ -133,6 +185,59 @@ static void check_facts(const ExplicitOperator &action, const vector<ExplicitVar
     }
 }
 
+BinaryTaskReader::BinaryTaskReader(const int32_t *body, size_t num_words)
+    : pos(body), end(body + num_words) {
+}
+
+void BinaryTaskReader::check_available(size_t num_words) const {
+    if (static_cast<size_t>(end - pos) < num_words) {
+        cerr << "Unexpected end of the binary translator output file." << endl;
+        utils::exit_with(ExitCode::SEARCH_INPUT_ERROR);
+    }
+}
+
+int BinaryTaskReader::read_int() {
+    check_available(1);
+    return *pos++;
+}
+
+int BinaryTaskReader::read_count() {
+    int count = read_int();
+    if (count < 0) {
+        cerr << "Invalid count in the binary translator output file: "
+             << count << endl;
+        utils::exit_with(ExitCode::SEARCH_INPUT_ERROR);
+    }
+    return count;
+}
+
+vector<int> BinaryTaskReader::read_ints(int count) {
+    check_available(count);
+    vector<int> values(pos, pos + count);
+    pos += count;
+    return values;
+}
+
+vector<FactPair> BinaryTaskReader::read_facts() {
+    int count = read_count();
+    check_available(2 * static_cast<size_t>(count));
+    vector<FactPair> facts;
+    facts.reserve(count);
+    for (int i = 0; i < count; ++i, pos += 2) {
+        facts.emplace_back(pos[0], pos[1]);
+    }
+    return facts;
+}
+
+string BinaryTaskReader::read_string() {
+    int length = read_count();
+    size_t num_words = (length + sizeof(int32_t) - 1) / sizeof(int32_t);
+    check_available(num_words);
+    string result(reinterpret_cast<const char *>(pos), length);
+    pos += num_words;
+    return result;
+}
+
 void check_magic(istream &in, const string &magic) {
     string word;
     in >> word;
@@ -173,6 +278,15 @@ ExplicitVariable::ExplicitVariable(istream &in) {
     check_magic(in, "end_variable");
 }
 
+ExplicitVariable::ExplicitVariable(BinaryTaskReader &in) {
+    name = in.read_string();
+    axiom_layer = in.read_int();
+    domain_size = in.read_count();
+    fact_names.reserve(domain_size);
+    for (int i = 0; i < domain_size; ++i)
+        fact_names.push_back(in.read_string());
+}
+
 
 ExplicitEffect::ExplicitEffect(
     int var, int value, vector<FactPair> &&conditions)
@@ -190,6 +304,17 @@ void ExplicitOperator::read_pre_post(istream &in) {
     effects.emplace_back(var, value_post, move(conditions));
 }
 
+void ExplicitOperator::read_pre_post(BinaryTaskReader &in) {
+    vector<FactPair> conditions = in.read_facts();
+    int var = in.read_int();
+    int value_pre = in.read_int();
+    int value_post = in.read_int();
+    if (value_pre != -1) {
+        preconditions.emplace_back(var, value_pre);
+    }
+    effects.emplace_back(var, value_post, move(conditions));
+}
+
 ExplicitOperator::ExplicitOperator(istream &in, bool is_an_axiom, bool use_metric)
     : is_an_axiom(is_an_axiom) {
     if (!is_an_axiom) {
@@ -218,17 +343,62 @@ ExplicitOperator::ExplicitOperator(istream &in, bool is_an_axiom, bool use_metri
     assert(cost >= 0);
 }
 
+ExplicitOperator::ExplicitOperator(
+    BinaryTaskReader &in, bool is_an_axiom, bool use_metric)
+    : is_an_axiom(is_an_axiom) {
+    if (!is_an_axiom) {
+        name = in.read_string();
+        preconditions = in.read_facts();
+        int count = in.read_count();
+        effects.reserve(count);
+        for (int i = 0; i < count; ++i) {
+            read_pre_post(in);
+        }
+        int op_cost = in.read_int();
+        cost = use_metric ? op_cost : 1;
+    } else {
+        name = "<axiom>";
+        cost = 0;
+        read_pre_post(in);
+    }
+    assert(cost >= 0);
+}
+
+static void verify_version(int version) {
+    if (version != PRE_FILE_VERSION) {
+        cerr << "Expected translator output file version " << PRE_FILE_VERSION
+             << ", got " << version << "." << endl
+             << "Exiting." << endl;
+        utils::exit_with(ExitCode::SEARCH_INPUT_ERROR);
+    }
+}
+
 void read_and_verify_version(istream &in) {
     int version;
     check_magic(in, "begin_version");
     in >> version;
     check_magic(in, "end_version");
-    if (version != PRE_FILE_VERSION) {
-        cerr << "Expected translator output file version " << PRE_FILE_VERSION
-             << ", got " << version << "." << endl
-             << "Exiting." << endl;
+    verify_version(version);
+}
+
+/*
+  Checks the header of a file in the binary format and returns the size of
+  its body in bytes.
+*/
+static size_t verify_binary_header(const BinaryHeader &header) {
+    assert(memcmp(header.magic, BINARY_MAGIC, sizeof(BINARY_MAGIC)) == 0);
+    if (header.byte_order_mark != BINARY_BYTE_ORDER_MARK) {
+        cerr << "The binary translator output file was written on a machine "
+             << "with a different byte order." << endl;
+        utils::exit_with(ExitCode::SEARCH_INPUT_ERROR);
+    }
+    verify_version(header.version);
+    if (header.body_size < 0 || header.body_size % sizeof(int32_t) != 0) {
+        cerr << "Invalid body size in the binary translator output file: "
+             << header.body_size << endl;
         utils::exit_with(ExitCode::SEARCH_INPUT_ERROR);
     }
+    return header.body_size;
 }
 
 bool read_metric(istream &in) {
@@ -250,21 +420,60 @@ vector<ExplicitVariable> read_variables(istream &in) {
     return variables;
 }
 
-vector<vector<set<FactPair>>> read_mutexes(istream &in, const vector<ExplicitVariable> &variables) {
+vector<ExplicitVariable> read_variables(BinaryTaskReader &in) {
+    int count = in.read_count();
+    vector<ExplicitVariable> variables;
+    variables.reserve(count);
+    for (int i = 0; i < count; ++i) {
+        variables.emplace_back(in);
+    }
+    return variables;
+}
+
+static vector<vector<set<FactPair>>> create_empty_mutexes(
+    const vector<ExplicitVariable> &variables) {
     vector<vector<set<FactPair>>> inconsistent_facts(variables.size());
     for (size_t i = 0; i < variables.size(); ++i)
         inconsistent_facts[i].resize(variables[i].domain_size);
+    return inconsistent_facts;
+}
+
+/*
+  NOTE: Mutex groups can overlap, in which case the same mutex
+  should not be represented multiple times. The current
+  representation takes care of that automatically by using sets.
+  If we ever change this representation, this is something to be
+  aware of.
+*/
+static void add_mutex_group(
+    const vector<FactPair> &invariant_group,
+    vector<vector<set<FactPair>>> &inconsistent_facts) {
+    for (const FactPair &fact1 : invariant_group) {
+        for (const FactPair &fact2 : invariant_group) {
+            if (fact1.var != fact2.var) {
+                /* The "different variable" test makes sure we
+                   don't mark a fact as mutex with itself
+                   (important for correctness) and don't include
+                   redundant mutexes (important to conserve
+                   memory). Note that the translator (at least
+                   with default settings) removes mutex groups
+                   that contain *only* redundant mutexes, but it
+                   can of course generate mutex groups which lead
+                   to *some* redundant mutexes, where some but not
+                   all facts talk about the same variable. */
+                inconsistent_facts[fact1.var][fact1.value].insert(fact2);
+            }
+        }
+    }
+}
+
+vector<vector<set<FactPair>>> read_mutexes(istream &in, const vector<ExplicitVariable> &variables) {
+    vector<vector<set<FactPair>>> inconsistent_facts =
+        create_empty_mutexes(variables);
 
     int num_mutex_groups;
     in >> num_mutex_groups;
 
-    /*
-      NOTE: Mutex groups can overlap, in which case the same mutex
-      should not be represented multiple times. The current
-      representation takes care of that automatically by using sets.
-      If we ever change this representation, this is something to be
-      aware of.
-    */
     for (int i = 0; i < num_mutex_groups; ++i) {
         check_magic(in, "begin_mutex_group");
         int num_facts;
@@ -278,23 +487,20 @@ vector<vector<set<FactPair>>> read_mutexes(istream &in, const vector<ExplicitVar
             invariant_group.emplace_back(var, value);
         }
         check_magic(in, "end_mutex_group");
-        for (const FactPair &fact1 : invariant_group) {
-            for (const FactPair &fact2 : invariant_group) {
-                if (fact1.var != fact2.var) {
-                    /* The "different variable" test makes sure we
-                       don't mark a fact as mutex with itself
-                       (important for correctness) and don't include
-                       redundant mutexes (important to conserve
-                       memory). Note that the translator (at least
-                       with default settings) removes mutex groups
-                       that contain *only* redundant mutexes, but it
-                       can of course generate mutex groups which lead
-                       to *some* redundant mutexes, where some but not
-                       all facts talk about the same variable. */
-                    inconsistent_facts[fact1.var][fact1.value].insert(fact2);
-                }
-            }
-        }
+        add_mutex_group(invariant_group, inconsistent_facts);
+    }
+    return inconsistent_facts;
+}
+
+vector<vector<set<FactPair>>> read_mutexes(
+    BinaryTaskReader &in, const vector<ExplicitVariable> &variables) {
+    vector<vector<set<FactPair>>> inconsistent_facts =
+        create_empty_mutexes(variables);
+    int num_mutex_groups = in.read_count();
+    for (int i = 0; i < num_mutex_groups; ++i) {
+        vector<FactPair> invariant_group = in.read_facts();
+        check_facts(invariant_group, variables);
+        add_mutex_group(invariant_group, inconsistent_facts);
     }
     return inconsistent_facts;
 }
@@ -310,6 +516,15 @@ vector<FactPair> read_goal(istream &in) {
     return goals;
 }
 
+vector<FactPair> read_goal(BinaryTaskReader &in) {
+    vector<FactPair> goals = in.read_facts();
+    if (goals.empty()) {
+        cerr << "Task has no goal condition!" << endl;
+        utils::exit_with(ExitCode::SEARCH_INPUT_ERROR);
+    }
+    return goals;
+}
+
 vector<ExplicitOperator> read_actions(
     istream &in, bool is_axiom, bool use_metric,
     const vector<ExplicitVariable> &variables) {
@@ -324,6 +539,19 @@ vector<ExplicitOperator> read_actions(
     return actions;
 }
 
+vector<ExplicitOperator> read_actions(
+    BinaryTaskReader &in, bool is_axiom, bool use_metric,
+    const vector<ExplicitVariable> &variables) {
+    int count = in.read_count();
+    vector<ExplicitOperator> actions;
+    actions.reserve(count);
+    for (int i = 0; i < count; ++i) {
+        actions.emplace_back(in, is_axiom, use_metric);
+        check_facts(actions.back(), variables);
+    }
+    return actions;
+}
+
 RootTask::RootTask(istream &in) {
     read_and_verify_version(in);
     bool use_metric = read_metric(in);
@@ -339,16 +567,36 @@ RootTask::RootTask(istream &in) {
     }
     check_magic(in, "end_state");
 
-    for (int i = 0; i < num_variables; ++i) {
-        variables[i].axiom_default_value = initial_state_values[i];
-    }
-
     goals = read_goal(in);
     check_facts(goals, variables);
     operators = read_actions(in, false, use_metric, variables);
     axioms = read_actions(in, true, use_metric, variables);
     /* TODO: We should be stricter here and verify that we
        have reached the end of "in". */
+    initialize_axiom_values();
+}
+
+RootTask::RootTask(BinaryTaskReader &in) {
+    bool use_metric = in.read_int();
+    variables = read_variables(in);
+    mutexes = read_mutexes(in, variables);
+    initial_state_values = in.read_ints(variables.size());
+    goals = read_goal(in);
+    check_facts(goals, variables);
+    operators = read_actions(in, false, use_metric, variables);
+    axioms = read_actions(in, true, use_metric, variables);
+    if (!in.at_end()) {
+        cerr << "Unexpected data after the end of the task in the binary "
+             << "translator output file." << endl;
+        utils::exit_with(ExitCode::SEARCH_INPUT_ERROR);
+    }
+    initialize_axiom_values();
+}
+
+void RootTask::initialize_axiom_values() {
+    for (size_t i = 0; i < variables.size(); ++i) {
+        variables[i].axiom_default_value = initial_state_values[i];
+    }
 
     /*
       HACK: We use a TaskProxy to access g_axiom_evaluators here which assumes
@@ -485,6 +733,25 @@ vector<int> RootTask::get_initial_state_values() const {
     return initial_state_values;
 }
 
+void RootTask::set_initial_state_values(const vector<int> &values) {
+    if (values.size() != variables.size()) {
+        cerr << "Initial state has " << values.size() << " values, but the "
+             << "task has " << variables.size() << " variables" << endl;
+        utils::exit_with(ExitCode::SEARCH_INPUT_ERROR);
+    }
+    vector<int> new_values(values);
+    for (size_t var = 0; var < variables.size(); ++var) {
+        const ExplicitVariable &variable = variables[var];
+        if (variable.axiom_layer != -1)
+            new_values[var] = variable.axiom_default_value;
+        else
+            check_fact(FactPair(var, new_values[var]), variables);
+    }
+    AxiomEvaluator &axiom_evaluator = g_axiom_evaluators[TaskProxy(*this)];
+    axiom_evaluator.evaluate(new_values);
+    initial_state_values = move(new_values);
+}
+
 void RootTask::convert_ancestor_state_values(
     vector<int> &, const AbstractTask *ancestor_task) const {
     if (this != ancestor_task) {
@@ -494,7 +761,82 @@ void RootTask::convert_ancestor_state_values(
 
 void read_root_task(istream &in) {
     assert(!g_root_task);
-    g_root_task = make_shared<RootTask>(in);
+    if (in.peek() == BINARY_MAGIC[0]) {
+        BinaryHeader header;
+        if (!in.read(reinterpret_cast<char *>(&header), sizeof(header)) ||
+            memcmp(header.magic, BINARY_MAGIC, sizeof(BINARY_MAGIC)) != 0) {
+            cerr << "Failed to read the header of the binary translator "
+                 << "output file." << endl;
+            utils::exit_with(ExitCode::SEARCH_INPUT_ERROR);
+        }
+        size_t body_size = verify_binary_header(header);
+        vector<int32_t> body(body_size / sizeof(int32_t));
+        if (!in.read(reinterpret_cast<char *>(body.data()), body_size)) {
+            cerr << "Unexpected end of the binary translator output file."
+                 << endl;
+            utils::exit_with(ExitCode::SEARCH_INPUT_ERROR);
+        }
+        BinaryTaskReader reader(body.data(), body.size());
+        g_root_task = make_shared<RootTask>(reader);
+    } else {
+        g_root_task = make_shared<RootTask>(in);
+    }
+}
+
+#if OPERATING_SYSTEM == LINUX || OPERATING_SYSTEM == OSX
+/*
+  Maps the file open as fd into memory and reads the task from the mapping
+  if the file is a regular file in the binary format that has not been read
+  from yet. This saves copying the file into a stream buffer and parsing the
+  text format. Returns false without reading anything otherwise.
+*/
+static bool read_mapped_root_task(int fd) {
+    struct stat st;
+    if (fstat(fd, &st) != 0 || !S_ISREG(st.st_mode) ||
+        static_cast<size_t>(st.st_size) < sizeof(BinaryHeader) ||
+        lseek(fd, 0, SEEK_CUR) != 0) {
+        return false;
+    }
+    size_t length = st.st_size;
+    void *data = mmap(nullptr, length, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (data == MAP_FAILED) {
+        return false;
+    }
+    const BinaryHeader &header = *static_cast<const BinaryHeader *>(data);
+    if (memcmp(header.magic, BINARY_MAGIC, sizeof(BINARY_MAGIC)) != 0) {
+        munmap(data, length);
+        return false;
+    }
+    size_t body_size = verify_binary_header(header);
+    if (body_size > length - sizeof(BinaryHeader)) {
+        cerr << "Unexpected end of the binary translator output file." << endl;
+        utils::exit_with(ExitCode::SEARCH_INPUT_ERROR);
+    }
+    // The task is read front to back, so the kernel can read ahead.
+    madvise(data, length, MADV_SEQUENTIAL);
+    BinaryTaskReader reader(
+        reinterpret_cast<const int32_t *>(
+            static_cast<const char *>(data) + sizeof(BinaryHeader)),
+        body_size / sizeof(int32_t));
+    g_root_task = make_shared<RootTask>(reader);
+    munmap(data, length);
+    return true;
+}
+#endif
+
+void read_root_task_from_stdin() {
+    assert(!g_root_task);
+#if OPERATING_SYSTEM == LINUX || OPERATING_SYSTEM == OSX
+    if (read_mapped_root_task(STDIN_FILENO))
+        return;
+#endif
+    read_root_task(cin);
+}
+
+void set_root_task_initial_state(const vector<int> &values) {
+    RootTask *root_task = dynamic_cast<RootTask *>(g_root_task.get());
+    assert(root_task);
+    root_task->set_initial_state_values(values);
 }
 
 class RootTaskFeature : public plugins::TypedFeature<AbstractTask, AbstractTask> {
@@ -3,8 +3,26 @@
 
 #include "../abstract_task.h"
 
+#include <vector>
+
 namespace tasks {
 extern std::shared_ptr<AbstractTask> g_root_task;
+/*
+  Reads the translator output in the text or the binary format (written by
+  the translator with --binary-sas) and sets g_root_task.
+*/
 extern void read_root_task(std::istream &in);
+/*
+  Same as read_root_task(std::cin), but if stdin is a regular file in the
+  binary format, it is mapped into memory instead of read through std::cin.
+*/
+extern void read_root_task_from_stdin();
+/*
+  Replaces the initial state of g_root_task. values must have a value for each
+  variable; the values of derived variables are ignored and recomputed from
+  the axioms. Used by the planner server to search from several states
+  without reading the task again.
+*/
+extern void set_root_task_initial_state(const std::vector<int> &values);
 }
 #endif
@@ -286,6 +286,74 @@ std::size_t get_hash(const T &value) {
 }
 
 
+/*
+  Hash function for fixed-length arrays of 32-bit words such as packed
+  states.
+
+  Feeding the words to a HashState one by one creates a long dependency
+  chain through the mixing steps. Instead, we split the array into 64-bit
+  chunks (pairs of words), mix each chunk together with its position
+  independently by multiply-xorshift, and sum the results. This processes
+  two words per mixing step, the mixing steps of different chunks can run
+  in parallel (and be vectorized by the compiler), and the sum can be
+  updated incrementally: if some words change, subtract the contributions
+  of their old chunks and add those of the new ones (see
+  get_word_chunk_hash()).
+
+  Use get_word_array_hash_sum() to compute the sum and
+  finalize_word_array_hash() to turn it into the final hash value.
+*/
+inline std::uint64_t mix_word_chunk(std::uint64_t chunk, int chunk_index) {
+    std::uint64_t x = chunk + (static_cast<std::uint64_t>(chunk_index) + 1) *
+        0x9e3779b97f4a7c15ULL;
+    x ^= x >> 32;
+    x *= 0xd6e8feb86659fd93ULL;
+    x ^= x >> 32;
+    x *= 0xd6e8feb86659fd93ULL;
+    x ^= x >> 32;
+    return x;
+}
+
+inline int get_num_word_chunks(int num_words) {
+    return (num_words + 1) / 2;
+}
+
+// Return the contribution of the given chunk to the hash sum.
+inline std::uint64_t get_word_chunk_hash(
+    const std::uint32_t *words, int num_words, int chunk_index) {
+    int first = 2 * chunk_index;
+    std::uint64_t chunk = words[first];
+    if (first + 1 < num_words) {
+        chunk |= static_cast<std::uint64_t>(words[first + 1]) << 32;
+    }
+    return mix_word_chunk(chunk, chunk_index);
+}
+
+inline std::uint64_t get_word_array_hash_sum(
+    const std::uint32_t *words, int num_words) {
+    std::uint64_t sum = 0;
+    int num_full_chunks = num_words / 2;
+    for (int i = 0; i < num_full_chunks; ++i) {
+        std::uint64_t chunk = words[2 * i] |
+            (static_cast<std::uint64_t>(words[2 * i + 1]) << 32);
+        sum += mix_word_chunk(chunk, i);
+    }
+    if (num_words % 2) {
+        sum += mix_word_chunk(words[num_words - 1], num_full_chunks);
+    }
+    return sum;
+}
+
+inline std::uint32_t finalize_word_array_hash(std::uint64_t sum) {
+    sum ^= sum >> 33;
+    sum *= 0xff51afd7ed558ccdULL;
+    sum ^= sum >> 33;
+    sum *= 0xc4ceb9fe1a85ec53ULL;
+    sum ^= sum >> 33;
+    return static_cast<std::uint32_t>(sum);
+}
+
+
 // This struct should only be used by HashMap and HashSet below.
 template<typename T>
 struct Hash {
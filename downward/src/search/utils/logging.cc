@@ -18,6 +18,15 @@ namespace utils {
   global_log here. Also add the options to dump_options().
 */
 
+thread_local Log::LineBuffer Log::line_buffer;
+mutex Log::stream_mutex;
+
+void Log::write_line_buffer() {
+    lock_guard<mutex> lock(stream_mutex);
+    stream << line_buffer.text.str() << flush;
+    line_buffer.text.str("");
+}
+
 static shared_ptr<Log> global_log = make_shared<Log>(Verbosity::NORMAL);
 
 LogProxy g_log(global_log);
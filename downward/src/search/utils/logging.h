@@ -6,7 +6,9 @@
 #include "timer.h"
 
 #include <memory>
+#include <mutex>
 #include <ostream>
+#include <sstream>
 #include <string>
 #include <vector>
 
@@ -30,36 +32,53 @@ enum class Verbosity {
   stdout.
 
   Internal class encapsulated by LogProxy.
+
+  Searches that run concurrently on several threads (see parallel_portfolio)
+  share logs. Therefore, each thread collects its current line in a buffer
+  and writes it to the stream when the line ends or is flushed, so that the
+  lines of different threads are not mixed.
 */
 class Log {
+    struct LineBuffer {
+        std::ostringstream text;
+        bool line_has_started = false;
+    };
+    static thread_local LineBuffer line_buffer;
+    static std::mutex stream_mutex;
+
     std::ostream &stream;
     const Verbosity verbosity;
-    bool line_has_started;
+
+    void write_line_buffer();
 
 public:
     explicit Log(Verbosity verbosity)
-        : stream(std::cout), verbosity(verbosity), line_has_started(false) {
+        : stream(std::cout), verbosity(verbosity) {
     }
 
     template<typename T>
     Log &operator<<(const T &elem) {
-        if (!line_has_started) {
-            line_has_started = true;
-            stream << "[t=" << g_timer << ", "
-                   << get_peak_memory_in_kb() << " KB] ";
+        if (!line_buffer.line_has_started) {
+            line_buffer.line_has_started = true;
+            line_buffer.text << "[t=" << g_timer << ", "
+                             << get_peak_memory_in_kb() << " KB] ";
         }
 
-        stream << elem;
+        line_buffer.text << elem;
         return *this;
     }
 
     using manip_function = std::ostream &(*)(std::ostream &);
     Log &operator<<(manip_function f) {
         if (f == static_cast<manip_function>(&std::endl)) {
-            line_has_started = false;
+            line_buffer.line_has_started = false;
+            line_buffer.text << '\n';
+            write_line_buffer();
+        } else if (f == static_cast<manip_function>(&std::flush)) {
+            write_line_buffer();
+        } else {
+            line_buffer.text << f;
         }
-
-        stream << f;
         return *this;
     }
 
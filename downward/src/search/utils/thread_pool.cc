@@ -0,0 +1,85 @@
+#include "thread_pool.h"
+
+#include <cassert>
+
+using namespace std;
+
+namespace utils {
+ThreadPool::ThreadPool(int num_threads)
+    : num_threads(num_threads),
+      loop_body(nullptr),
+      num_iterations(0),
+      next_iteration(0),
+      num_busy_helpers(0),
+      loop_id(0),
+      shutting_down(false) {
+    assert(num_threads >= 1);
+    helpers.reserve(num_threads - 1);
+    for (int thread_id = 1; thread_id < num_threads; ++thread_id) {
+        helpers.emplace_back(&ThreadPool::run_helper, this, thread_id);
+    }
+}
+
+ThreadPool::~ThreadPool() {
+    {
+        lock_guard<std::mutex> lock(mutex);
+        shutting_down = true;
+    }
+    loop_started.notify_all();
+    for (thread &helper : helpers) {
+        helper.join();
+    }
+}
+
+void ThreadPool::run_iterations(int thread_id) {
+    while (true) {
+        int iteration = next_iteration.fetch_add(1, memory_order_relaxed);
+        if (iteration >= num_iterations)
+            break;
+        (*loop_body)(iteration, thread_id);
+    }
+}
+
+void ThreadPool::run_helper(int thread_id) {
+    int last_loop_id = 0;
+    while (true) {
+        {
+            unique_lock<std::mutex> lock(mutex);
+            loop_started.wait(lock, [&]() {
+                                  return shutting_down || loop_id != last_loop_id;
+                              });
+            if (shutting_down)
+                return;
+            last_loop_id = loop_id;
+        }
+        run_iterations(thread_id);
+        {
+            lock_guard<std::mutex> lock(mutex);
+            if (--num_busy_helpers == 0)
+                loop_finished.notify_one();
+        }
+    }
+}
+
+void ThreadPool::run(int num_iterations, const function<void(int, int)> &body) {
+    if (helpers.empty() || num_iterations <= 1) {
+        for (int i = 0; i < num_iterations; ++i) {
+            body(i, 0);
+        }
+        return;
+    }
+    {
+        lock_guard<std::mutex> lock(mutex);
+        loop_body = &body;
+        this->num_iterations = num_iterations;
+        next_iteration.store(0, memory_order_relaxed);
+        num_busy_helpers = helpers.size();
+        ++loop_id;
+    }
+    loop_started.notify_all();
+    run_iterations(0);
+    unique_lock<std::mutex> lock(mutex);
+    loop_finished.wait(lock, [&]() {return num_busy_helpers == 0;});
+    loop_body = nullptr;
+}
+}
@@ -0,0 +1,55 @@
+#ifndef UTILS_THREAD_POOL_H
+#define UTILS_THREAD_POOL_H
+
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace utils {
+/*
+  A fixed set of threads for running parallel loops. The thread that calls
+  run() takes part in the loop, so a pool with n threads starts n - 1 helper
+  threads. The helper threads sleep while no loop is running.
+*/
+class ThreadPool {
+    const int num_threads;
+    std::vector<std::thread> helpers;
+
+    std::mutex mutex;
+    std::condition_variable loop_started;
+    std::condition_variable loop_finished;
+    const std::function<void(int, int)> *loop_body;
+    int num_iterations;
+    std::atomic<int> next_iteration;
+    int num_busy_helpers;
+    int loop_id;
+    bool shutting_down;
+
+    void run_iterations(int thread_id);
+    void run_helper(int thread_id);
+public:
+    explicit ThreadPool(int num_threads);
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool &) = delete;
+    ThreadPool &operator=(const ThreadPool &) = delete;
+
+    int get_num_threads() const {
+        return num_threads;
+    }
+
+    /*
+      Call body(i, thread_id) for all i in [0, num_iterations) and return
+      when all calls are done. The iterations are distributed dynamically,
+      thread_id is in [0, get_num_threads()) and identifies the thread that
+      executes the call. Calls with the same thread_id never run
+      concurrently.
+    */
+    void run(int num_iterations, const std::function<void(int, int)> &body);
+};
+}
+
+#endif
@@ -28,6 +28,10 @@ def parse_args():
     argparser.add_argument(
         "--sas-file", default="output.sas",
         help="path to the SAS output file (default: %(default)s)")
+    argparser.add_argument(
+        "--binary-sas", action="store_true",
+        help="write the SAS output file in the binary format, which the "
+        "search component reads faster than the text format")
     argparser.add_argument(
         "--invariant-generation-max-time", default=300, type=int,
         help="max time for invariant generation (default: %(default)ds)")
@@ -1,7 +1,16 @@
+import array
+import struct
 from typing import List, Tuple
 
 SAS_FILE_VERSION = 3
 
+# Header of the binary format: magic word, byte order mark, file version
+# and the size of the body in bytes. The search component rejects files
+# whose byte order mark does not match its own byte order.
+BINARY_SAS_MAGIC = b"FDSASBIN"
+BINARY_SAS_BYTE_ORDER_MARK = 0x01020304
+BINARY_SAS_HEADER = struct.Struct("=8sIiq")
+
 DEBUG = False
 
 VarValPair = Tuple[int, int]
@@ -104,6 +113,30 @@ class SASTask:
         for axiom in self.axioms:
             axiom.output(stream)
 
+    def output_binary(self, stream):
+        """Write the task in the binary format.
+
+        The binary format contains the same sections in the same order
+        as the text format, without the magic words. It is a sequence
+        of 32-bit integers; strings are written as their length in
+        bytes followed by their UTF-8 encoding, padded to a multiple of
+        four bytes."""
+        writer = SASBinaryWriter()
+        writer.write_int(int(self.metric))
+        self.variables.output_binary(writer)
+        writer.write_int(len(self.mutexes))
+        for mutex in self.mutexes:
+            mutex.output_binary(writer)
+        self.init.output_binary(writer)
+        self.goal.output_binary(writer)
+        writer.write_int(len(self.operators))
+        for op in self.operators:
+            op.output_binary(writer)
+        writer.write_int(len(self.axioms))
+        for axiom in self.axioms:
+            axiom.output_binary(writer)
+        writer.save(stream)
+
     def get_encoding_size(self):
         task_size = 0
         task_size += self.variables.get_encoding_size()
@@ -178,6 +211,17 @@ class SASVariables:
                 print(value, file=stream)
             print("end_variable", file=stream)
 
+    def output_binary(self, writer):
+        writer.write_int(len(self.ranges))
+        for var, (rang, axiom_layer, values) in enumerate(zip(
+                self.ranges, self.axiom_layers, self.value_names)):
+            writer.write_string("var%d" % var)
+            writer.write_int(axiom_layer)
+            writer.write_int(rang)
+            assert rang == len(values), (rang, values)
+            for value in values:
+                writer.write_string(value)
+
     def get_encoding_size(self):
         # A variable with range k has encoding size k + 1 to also give the
         # variable itself some weight.
@@ -206,6 +250,9 @@ class SASMutexGroup:
             print(var, val, file=stream)
         print("end_mutex_group", file=stream)
 
+    def output_binary(self, writer):
+        writer.write_facts(self.facts)
+
     def get_encoding_size(self):
         return len(self.facts)
 
@@ -235,6 +282,9 @@ class SASInit:
             print(val, file=stream)
         print("end_state", file=stream)
 
+    def output_binary(self, writer):
+        writer.write_ints(self.values)
+
 
 class SASGoal:
     def __init__(self, pairs: List[Tuple[int, int]]) -> None:
@@ -256,6 +306,9 @@ class SASGoal:
             print(var, val, file=stream)
         print("end_goal", file=stream)
 
+    def output_binary(self, writer):
+        writer.write_facts(self.pairs)
+
     def get_encoding_size(self):
         return len(self.pairs)
 
@@ -382,6 +435,15 @@ class SASOperator:
         print(self.cost, file=stream)
         print("end_operator", file=stream)
 
+    def output_binary(self, writer):
+        writer.write_string(self.name[1:-1])
+        writer.write_facts(self.prevail)
+        writer.write_int(len(self.pre_post))
+        for var, pre, post, cond in self.pre_post:
+            writer.write_facts(cond)
+            writer.write_ints((var, pre, post))
+        writer.write_int(self.cost)
+
     def get_encoding_size(self):
         size = 1 + len(self.prevail)
         for var, pre, post, cond in self.pre_post:
@@ -484,5 +546,42 @@ class SASAxiom:
         print(var, 1 - val, val, file=stream)
         print("end_rule", file=stream)
 
+    def output_binary(self, writer):
+        writer.write_facts(self.condition)
+        var, val = self.effect
+        writer.write_ints((var, 1 - val, val))
+
     def get_encoding_size(self):
         return 1 + len(self.condition)
+
+
+class SASBinaryWriter:
+    """Collects the body of a binary SAS file (see SASTask.output_binary)."""
+    def __init__(self):
+        self.words = array.array("i")
+        assert self.words.itemsize == 4
+
+    def write_int(self, value):
+        self.words.append(value)
+
+    def write_ints(self, values):
+        self.words.extend(values)
+
+    def write_facts(self, facts):
+        self.write_int(len(facts))
+        for var, val in facts:
+            self.words.append(var)
+            self.words.append(val)
+
+    def write_string(self, string):
+        data = string.encode("utf-8")
+        self.write_int(len(data))
+        padding = -len(data) % 4
+        self.words.frombytes(data + b"\0" * padding)
+
+    def save(self, stream):
+        body = self.words.tobytes()
+        stream.write(BINARY_SAS_HEADER.pack(
+            BINARY_SAS_MAGIC, BINARY_SAS_BYTE_ORDER_MARK,
+            SAS_FILE_VERSION, len(body)))
+        stream.write(body)
@@ -0,0 +1,113 @@
+#!/usr/bin/env python3
+"""Compares the LM-cut heuristic of two git revisions of ssipp-solver.
+
+For each revision, a git worktree is created, lm_cut_bench (see
+lm_cut_bench.cc) is built in it and run on every given problem. The benchmark
+source and build.py of the current tree are copied into the worktrees, so any
+revision whose LMCutHeuristic has valueAndCuts can be measured. Example, using
+the training problems of an ASNets experiment:
+
+    ./bench_lm_cut.py --old HEAD~1 --new HEAD \\
+        --problem <train-dir>/domain.pddl <train-dir>/prob01.pddl prob01 \\
+        --problem <train-dir>/domain.pddl <train-dir>/prob02.pddl prob02
+
+Each --problem is a list of PDDL files followed by the problem name. Both
+revisions evaluate the same states (same seed). LM-cut values depend on how
+ties between h_max supporters are broken, so different checksums do not
+necessarily mean that one of the versions is wrong."""
+
+import argparse
+import os
+import os.path
+import re
+import shutil
+import subprocess
+import sys
+import tempfile
+
+THIS_DIR = os.path.dirname(os.path.abspath(__file__))
+BENCH_FILES = ['lm_cut_bench.cc', 'build.py']
+RESULT_RE = re.compile(r'^\[lm_cut_bench\] (.+?): (.+)$')
+
+
+def run(cmd, cwd=None):
+    print('$ %s' % ' '.join(cmd), file=sys.stderr)
+    return subprocess.run(cmd, cwd=cwd, check=True, stdout=subprocess.PIPE,
+                          universal_newlines=True).stdout
+
+
+def build_revision(rev, tmp_dir):
+    """Creates a worktree for rev and builds lm_cut_bench in it. Returns the
+    worktree and the path of the binary."""
+    top = run(['git', 'rev-parse', '--show-toplevel'], cwd=THIS_DIR).strip()
+    worktree = os.path.join(tmp_dir, rev.replace('/', '_'))
+    run(['git', 'worktree', 'add', '--detach', worktree, rev], cwd=top)
+    solver_dir = os.path.join(worktree, os.path.relpath(THIS_DIR, top))
+    for f in BENCH_FILES:
+        shutil.copy(os.path.join(THIS_DIR, f), solver_dir)
+    # build.py caches objects in a fixed tmp dir, so it must be cleaned
+    # between revisions
+    run(['./build.py', 'clean'], cwd=solver_dir)
+    run(['./build.py', 'lm_cut_bench'], cwd=solver_dir)
+    return worktree, os.path.join(solver_dir, 'lm_cut_bench')
+
+
+def bench(binary, problem, args):
+    pddl_files = [os.path.abspath(p) for p in problem[:-1]]
+    out = run([binary] + pddl_files + [
+        problem[-1],
+        str(args.states),
+        str(args.walk_length),
+        str(args.repetitions)
+    ])
+    rv = {}
+    for line in out.splitlines():
+        m = RESULT_RE.match(line)
+        if m:
+            rv[m.group(1)] = m.group(2)
+    return rv
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__)
+    parser.add_argument('--old', required=True, help='baseline revision')
+    parser.add_argument('--new', default='HEAD', help='revision to compare')
+    parser.add_argument('--problem',
+                        nargs='+',
+                        action='append',
+                        required=True,
+                        help='PDDL files followed by the problem name')
+    parser.add_argument('--states', type=int, default=1000)
+    parser.add_argument('--walk-length', type=int, default=50)
+    parser.add_argument('--repetitions', type=int, default=10)
+    args = parser.parse_args()
+
+    tmp_dir = tempfile.mkdtemp(prefix='bench_lm_cut_')
+    worktrees = []
+    try:
+        binaries = {}
+        for rev in (args.old, args.new):
+            worktree, binaries[rev] = build_revision(rev, tmp_dir)
+            worktrees.append(worktree)
+
+        print('%-30s %15s %15s %8s  %s' %
+              ('problem', args.old + ' us', args.new + ' us', 'speedup',
+               'checksums'))
+        for problem in args.problem:
+            res = {rev: bench(binaries[rev], problem, args)
+                   for rev in binaries}
+            old_t = float(res[args.old]['cputime per call (in usecs)'])
+            new_t = float(res[args.new]['cputime per call (in usecs)'])
+            same = res[args.old]['checksum'] == res[args.new]['checksum']
+            print('%-30s %15.2f %15.2f %8.2f  %s' %
+                  (problem[-1], old_t, new_t, old_t / max(new_t, 1e-9),
+                   'equal' if same else 'DIFFERENT'))
+    finally:
+        for worktree in worktrees:
+            subprocess.run(['git', 'worktree', 'remove', '--force', worktree],
+                           cwd=THIS_DIR)
+        shutil.rmtree(tmp_dir, ignore_errors=True)
+
+
+if __name__ == '__main__':
+    main()
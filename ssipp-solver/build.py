@@ -803,8 +803,8 @@ def main():
     def clean_target():
         rv = clean(tmpdir)
         artefact_globs = [
-            'solver_ssp', 'heur_eval', 'ssipp*.so', 'build', 'ssipp.egg-info',
-            tmpdir
+            'solver_ssp', 'heur_eval', 'lm_cut_bench', 'ssipp*.so', 'build',
+            'ssipp.egg-info', tmpdir
         ]
         for artefact_glob in artefact_globs:
             # should follow EAFP in theory, but this is easier than looking at
@@ -834,6 +834,11 @@ def main():
         apply(compileAndLinkWithAutoDependencies, 'heur_eval.o', 'heur_eval',
               solver_rules, deps_file, CPP_COMPILER, solver_cflags,
               linker_flags, objdir, n_threads, allowed_to_recompile_parser),
+        'lm_cut_bench':
+        apply(compileAndLinkWithAutoDependencies, 'lm_cut_bench.o',
+              'lm_cut_bench', solver_rules, deps_file, CPP_COMPILER,
+              solver_cflags, linker_flags, objdir, n_threads,
+              allowed_to_recompile_parser),
         'clean':
         clean_target,
     }
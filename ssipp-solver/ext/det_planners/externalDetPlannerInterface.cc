@@ -1,3 +1,4 @@
+#include <algorithm>
 #include <cstring>
 #include <fstream>
 #include <iostream>
@@ -10,6 +11,7 @@
 #include "../../utils/exceptions.h"
 #include "externalFFInterface.h"
 #include "externalLamaInterface.h"
+#include "internalGBFSInterface.h"
 #include "../mgpt/global.h"
 #include "../mgpt/hash.h"
 
@@ -25,6 +27,14 @@ ExternalDetPlannerInterface* ExternalDetPlannerInterface::createInterface(
   else if (det_planner == "lama" || det_planner == "LAMA") {
     return new ExternalLamaInterface(problem, timeout_in_secs, det_type);
   }
+  else if (det_planner == "gbfs-ff" || det_planner == "GBFS-FF") {
+    return new InternalGBFSInterface(problem, timeout_in_secs, det_type,
+                                     InternalGBFSInterface::H_FF);
+  }
+  else if (det_planner == "gbfs-add" || det_planner == "GBFS-ADD") {
+    return new InternalGBFSInterface(problem, timeout_in_secs, det_type,
+                                     InternalGBFSInterface::H_ADD);
+  }
   else {
     std::cerr << "Deterministic planner '" << det_planner << "' is unknown..."
               << std::endl;
@@ -38,10 +48,18 @@ ExternalDetPlannerInterface* ExternalDetPlannerInterface::createInterface(
  * Constructor
  */
 ExternalDetPlannerInterface::ExternalDetPlannerInterface(problem_t const& problem,
-    size_t timeout_in_secs, DeterminizationType det_type)
-  : problem_(problem), delete_files_(true), total_calls_(0),
-    timeout_in_secs_(timeout_in_secs)
+    size_t timeout_in_secs, DeterminizationType det_type,
+    bool print_determinization)
+  : problem_(problem), det_type_(det_type), delete_files_(true),
+    total_calls_(0), timeout_in_secs_(timeout_in_secs),
+    use_plan_cache_(true), max_cached_states_(1000000), cache_hits_(0),
+    cache_repairs_(0)
 {
+  if (!print_determinization) {
+    delete_files_ = false;
+    return;
+  }
+
   std::string template_str1 = std::string(gpt::tmp_dir) +
                               "/externalDetPlannerInterface_XXXXXX";
   char* template_str2 = strdup(template_str1.c_str());
@@ -602,9 +620,9 @@ void ExternalDetPlannerInterface::executionTrace(state_t const& initial_state,
 
 
 /*
- * planFrom
+ * _planFrom
  */
-DetPlannerReturnType ExternalDetPlannerInterface::planFrom(state_t const& s,
+DetPlannerReturnType ExternalDetPlannerInterface::_planFrom(state_t const& s,
     std::vector<std::pair<double, state_t> > & state_trace,
     std::vector<action_t const*>* action_trace,
     double likelihood_cutoff)
@@ -619,6 +637,188 @@ DetPlannerReturnType ExternalDetPlannerInterface::planFrom(state_t const& s,
 }
 
 
+/*
+ * planFrom
+ */
+DetPlannerReturnType ExternalDetPlannerInterface::planFrom(state_t const& s,
+    std::vector<std::pair<double, state_t> > & state_trace,
+    std::vector<action_t const*>* action_trace,
+    double likelihood_cutoff)
+{
+  if (!use_plan_cache_)
+    return _planFrom(s, state_trace, action_trace, likelihood_cutoff);
+
+  CachedSuffix suffix;
+  if (planCacheLookup(s, suffix)) {
+    cache_hits_++;
+  } else if (planCacheRepair(s, suffix)) {
+    cache_repairs_++;
+  } else {
+    // The whole trace is needed for the cache, so no likelihood cutoff here
+    std::vector<std::pair<double, state_t> > full_state_trace;
+    CachedTrace trace;
+    DetPlannerReturnType retcode = _planFrom(s, full_state_trace,
+                                             &trace.actions);
+    if (retcode != SUCCESS)
+      return retcode;
+    double prev_likelihood = 1.0;
+    for (auto const& lik_and_state : full_state_trace) {
+      trace.states.push_back(lik_and_state.second);
+      trace.probs.push_back(prev_likelihood > 0 ?
+                              lik_and_state.first / prev_likelihood : 0.0);
+      prev_likelihood = lik_and_state.first;
+    }
+    planCacheInsert(s, std::move(trace));
+    if (!planCacheLookup(s, suffix)) {
+      std::cerr << "Plan just found is not in the plan cache" << std::endl;
+      exit(174);
+    }
+  }
+  fillTraceFromCache(suffix, state_trace, action_trace, likelihood_cutoff);
+  return SUCCESS;
+}
+
+
+/*
+ * lengthAndLikelihood
+ */
+DetPlannerReturnType ExternalDetPlannerInterface::lengthAndLikelihood(
+    state_t const& s, size_t& length, double* likelihood)
+{
+  if (!use_plan_cache_)
+    return _lengthAndLikelihoodPlanFrom(s, length, likelihood);
+
+  std::vector<std::pair<double, state_t> > state_trace;
+  DetPlannerReturnType retcode = planFrom(s, state_trace, NULL);
+  if (retcode == SUCCESS) {
+    length = state_trace.size();
+    if (likelihood)
+      (*likelihood) = (state_trace.empty() ? 1.0 : state_trace.back().first);
+  }
+  return retcode;
+}
+
+
+/******************************************************************************
+ *
+ * Plan cache
+ *
+ ******************************************************************************/
+void ExternalDetPlannerInterface::clearPlanCache() {
+  traces_.clear();
+  cached_suffix_.clear();
+}
+
+
+void ExternalDetPlannerInterface::planCacheInsert(state_t const& s,
+    CachedTrace&& trace)
+{
+  if (cached_suffix_.size() + trace.states.size() + 1 > max_cached_states_)
+    clearPlanCache();
+
+  size_t trace_id = traces_.size();
+  // States already in the cache keep their suffix, i.e., they are only
+  // replaced by clearPlanCache
+  cached_suffix_.emplace(s, CachedSuffix{trace_id, 0});
+  for (size_t i = 0; i < trace.states.size(); ++i)
+    cached_suffix_.emplace(trace.states[i], CachedSuffix{trace_id, i + 1});
+  traces_.push_back(std::move(trace));
+}
+
+
+bool ExternalDetPlannerInterface::planCacheLookup(state_t const& s,
+    CachedSuffix& suffix) const
+{
+  auto it = cached_suffix_.find(s);
+  if (it == cached_suffix_.end())
+    return false;
+  suffix = it->second;
+  return true;
+}
+
+
+bool ExternalDetPlannerInterface::planCacheRepair(state_t const& s,
+    CachedSuffix& suffix)
+{
+  if (cached_suffix_.empty() || problem_.goal().holds(s))
+    return false;
+
+  // Picking the action and outcome that maximize the likelihood of the
+  // repaired plan
+  std::vector<action_t const*> applicable;
+  problem_.applicable_actions(s, applicable);
+  ProbDistStateVector expansion;
+  action_t const* best_action = nullptr;
+  double best_prob = 0;
+  double best_likelihood = 0;
+  CachedSuffix best_suffix{0, 0};
+  state_t best_succ(s);
+  for (action_t const* a : applicable) {
+    expansion.clear();
+    a->expand(s, expansion);
+    double max_p = 0;
+    if (det_type_ == MOST_LIKELY_OUTCOMES) {
+      for (auto const& it : expansion)
+        max_p = std::max(max_p, it.prob());
+    }
+    for (auto const& it : expansion) {
+      if (it.event() == s ||
+          (det_type_ == MOST_LIKELY_OUTCOMES && it.prob() < max_p))
+        continue;
+      CachedSuffix succ_suffix;
+      if (!planCacheLookup(it.event(), succ_suffix))
+        continue;
+      CachedTrace const& trace = traces_[succ_suffix.trace];
+      double likelihood = it.prob();
+      for (size_t i = succ_suffix.pos; i < trace.probs.size(); ++i)
+        likelihood *= trace.probs[i];
+      if (likelihood > best_likelihood) {
+        best_action = a;
+        best_prob = it.prob();
+        best_likelihood = likelihood;
+        best_suffix = succ_suffix;
+        best_succ = it.event();
+      }
+    }
+  }
+  if (!best_action)
+    return false;
+
+  CachedTrace repaired;
+  CachedTrace const& trace = traces_[best_suffix.trace];
+  repaired.actions.push_back(best_action);
+  repaired.probs.push_back(best_prob);
+  repaired.actions.insert(repaired.actions.end(),
+      trace.actions.begin() + best_suffix.pos, trace.actions.end());
+  repaired.probs.insert(repaired.probs.end(),
+      trace.probs.begin() + best_suffix.pos, trace.probs.end());
+  repaired.states.push_back(best_succ);
+  repaired.states.insert(repaired.states.end(),
+      trace.states.begin() + best_suffix.pos, trace.states.end());
+  planCacheInsert(s, std::move(repaired));
+  return planCacheLookup(s, suffix);
+}
+
+
+void ExternalDetPlannerInterface::fillTraceFromCache(
+    CachedSuffix const& suffix,
+    std::vector<std::pair<double, state_t> >& state_trace,
+    std::vector<action_t const*>* action_trace,
+    double likelihood_cutoff) const
+{
+  CachedTrace const& trace = traces_[suffix.trace];
+  double cur_likelihood = 1.0;
+  for (size_t i = suffix.pos; i < trace.actions.size(); ++i) {
+    cur_likelihood *= trace.probs[i];
+    if (cur_likelihood < likelihood_cutoff)
+      break;
+    state_trace.push_back(std::make_pair(cur_likelihood, trace.states[i]));
+    if (action_trace)
+      action_trace->push_back(trace.actions[i]);
+  }
+}
+
+
 /*
  * partialPolicyFrom
  */
@@ -88,8 +88,11 @@ enum DetPlannerReturnType {SUCCESS = 0, NO_PLAN, TIMEOUT};
 
 class ExternalDetPlannerInterface {
  public:
+  // If print_determinization is false, then no determinization is written to
+  // disk and no tmp dir is created, i.e., the planner works directly on the
+  // grounded problem
   ExternalDetPlannerInterface(problem_t const& problem, size_t timeout_in_secs,
-      DeterminizationType det_type);
+      DeterminizationType det_type, bool print_determinization = true);
   virtual ~ExternalDetPlannerInterface();
 
   static ExternalDetPlannerInterface* createInterface(problem_t const& problem,
@@ -97,11 +100,11 @@ class ExternalDetPlannerInterface {
       std::string det_planner);
 
   DetPlannerReturnType lengthPlanFrom(state_t const& s, size_t& length)
-   { return _lengthAndLikelihoodPlanFrom(s, length); }
+   { return lengthAndLikelihood(s, length, NULL); }
 
   DetPlannerReturnType lengthAndLikelihoodPlanFrom(state_t const& s, size_t& length,
      double& likelihood)
-   { return _lengthAndLikelihoodPlanFrom(s, length, &likelihood); }
+   { return lengthAndLikelihood(s, length, &likelihood); }
 
   /*
    * Fills state_trace and action_trace with the execution trace that FF
@@ -116,6 +119,9 @@ class ExternalDetPlannerInterface {
    *      -> ... -> action_trace[end] -> state_trace[end].second = goal
    * If likelihood_cutoff is greater than 0, then the trace is stopped when the
    * plan likelihood is less than likelihood_cutoff
+   *
+   * If the plan cache is in use, the trace is obtained from a previous plan
+   * whenever possible (see planCacheLookup and planCacheRepair).
    */
   DetPlannerReturnType planFrom(state_t const& s,
      std::vector<std::pair<double, state_t> >& state_trace,
@@ -127,6 +133,22 @@ class ExternalDetPlannerInterface {
   DetPlannerReturnType partialPolicyFrom(state_t const& s, DetPolicyIface& pi,
      double likelihood_cutoff = 0.0);
 
+  /*
+   * Plan cache: every state visited by a plan returned by the deterministic
+   * planner is mapped to the suffix of that plan that reaches the goal from
+   * it. Since the determinization is fixed, the suffix is still a valid plan
+   * when the state is visited again, so the planner is not called. The cache
+   * is cleared when it has more than max_states states.
+   */
+  void usePlanCache(bool use, size_t max_states = 1000000) {
+    use_plan_cache_ = use;
+    max_cached_states_ = max_states;
+    clearPlanCache();
+  }
+  void clearPlanCache();
+  size_t planCacheHits() const { return cache_hits_; }
+  size_t planCacheRepairs() const { return cache_repairs_; }
+
  protected:
   /*
    * Domain Determinization Methods
@@ -172,9 +194,15 @@ class ExternalDetPlannerInterface {
   /*** Methods to process the unparsed plan from FF into something meaningful*/
   double planProbability(std::vector<DetPlannerUnparsedAction>& plan) const;
 
-  DetPlannerReturnType _lengthAndLikelihoodPlanFrom(state_t const& s,
+  virtual DetPlannerReturnType _lengthAndLikelihoodPlanFrom(state_t const& s,
       size_t& length, double* likelihood = NULL);
 
+  /* Calls the deterministic planner, i.e., planFrom without the plan cache */
+  virtual DetPlannerReturnType _planFrom(state_t const& s,
+     std::vector<std::pair<double, state_t> >& state_trace,
+     std::vector<action_t const*>* action_trace,
+     double likelihood_cutoff = 0.0);
+
   void executionTrace(state_t const& initial_state,
       std::vector<DetPlannerUnparsedAction> const& plan,
       std::vector<std::pair<double, state_t> >& state_trace,
@@ -183,21 +211,60 @@ class ExternalDetPlannerInterface {
       double likelihood_cutoff = 0.0) const;
 
   void keepTmpFiles() { delete_files_ = false; }
+  void countCall() { total_calls_++; }
 
-//  problem_t const& problem() const { return problem_; }
+  problem_t const& problem() const { return problem_; }
   size_t timeoutInSecs() const { return timeout_in_secs_; }
   std::string tmpDir() const { return tmp_dir_; }
   std::string domainFile() const { return domain_file_; }
 //  ActionNameToInfo& nameToEffect() { return name_to_effect_; }
 
  private:
+  // Trace of a plan found by the deterministic planner: actions[i] is applied
+  // in states[i-1] (or in the initial state if i = 0) resulting in states[i]
+  // with probability probs[i].
+  struct CachedTrace {
+    std::vector<action_t const*> actions;
+    std::vector<state_t> states;
+    std::vector<double> probs;
+  };
+  // Suffix of the trace traces_[trace] that starts at actions[pos]
+  struct CachedSuffix {
+    size_t trace;
+    size_t pos;
+  };
+
+  DetPlannerReturnType lengthAndLikelihood(state_t const& s, size_t& length,
+     double* likelihood);
+
+  // Adds the trace and all its suffixes to the cache
+  void planCacheInsert(state_t const& s, CachedTrace&& trace);
+  // Returns true if there is a plan suffix for s in the cache
+  bool planCacheLookup(state_t const& s, CachedSuffix& suffix) const;
+  // Looks for an action a and outcome s' of a in the determinization such
+  // that s' is in the cache. If found, the plan a followed by the suffix of
+  // s' is added to the cache and true is returned.
+  bool planCacheRepair(state_t const& s, CachedSuffix& suffix);
+  void fillTraceFromCache(CachedSuffix const& suffix,
+     std::vector<std::pair<double, state_t> >& state_trace,
+     std::vector<action_t const*>* action_trace,
+     double likelihood_cutoff) const;
+
   problem_t const& problem_;
+  DeterminizationType det_type_;
   bool delete_files_;
   size_t total_calls_;
   size_t timeout_in_secs_;
   std::string tmp_dir_;
   std::string domain_file_;
   ActionNameToInfo name_to_effect_;
+
+  bool use_plan_cache_;
+  size_t max_cached_states_;
+  std::vector<CachedTrace> traces_;
+  std::unordered_map<state_t, CachedSuffix, hashState> cached_suffix_;
+  size_t cache_hits_;
+  size_t cache_repairs_;
 };
 
 #endif // EXTERNAL_DET_PLANNER_INTERFACE_H
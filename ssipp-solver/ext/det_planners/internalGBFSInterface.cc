@@ -0,0 +1,196 @@
+#include <algorithm>
+#include <iostream>
+
+#include "internalGBFSInterface.h"
+
+#include "../mgpt/actions.h"
+#include "../mgpt/global.h"
+#include "../mgpt/problems.h"
+#include "../../heuristics/h_add.h"
+#include "../../heuristics/h_ff.h"
+#include "../../utils/die.h"
+#include "../../utils/utils.h"
+
+
+InternalGBFSInterface::InternalGBFSInterface(problem_t const& problem,
+    size_t timeout_in_secs, DeterminizationType det_type,
+    HeuristicType heuristic_type)
+  : ExternalDetPlannerInterface(problem, timeout_in_secs, det_type, false),
+    det_type_(det_type), goal_node_(NO_PARENT), total_expansions_(0)
+{
+  if (heuristic_type == H_ADD)
+    heuristic_.reset(new HAddAllOutcomesDet(problem, ACTION_COST));
+  else
+    heuristic_.reset(new HFFAllOutcomesDet(problem, ACTION_COST));
+}
+
+
+/*
+ * _run: the plan is returned as the names of the actions of problem_t, e.g.,
+ * (pick-up b1 b2), and not as the names of the determinized actions.
+ */
+DetPlannerReturnType InternalGBFSInterface::_run(state_t const& s,
+    std::vector<DetPlannerUnparsedAction>& plan)
+{
+  DetPlannerReturnType retcode = search(s);
+  if (retcode != SUCCESS)
+    return retcode;
+
+  size_t first = plan.size();
+  for (int n = goal_node_; nodes_[n].parent != NO_PARENT; n = nodes_[n].parent)
+    plan.push_back(DetPlannerUnparsedAction(nodes_[n].action->name()));
+  std::reverse(plan.begin() + first, plan.end());
+  return SUCCESS;
+}
+
+
+int InternalGBFSInterface::addNode(state_t const& s, int parent,
+    action_t const* a, double prob, size_t g)
+{
+  int id = nodes_.size();
+  nodes_.push_back(SearchNode{s, parent, a, prob, g});
+  closed_.emplace(s, id);
+  return id;
+}
+
+
+void InternalGBFSInterface::determinizedSuccessors(state_t const& s,
+    action_t const& a)
+{
+  successors_.clear();
+  expansion_.clear();
+  a.expand(s, expansion_);
+
+  double max_p = 0;
+  if (det_type_ == MOST_LIKELY_OUTCOMES) {
+    for (auto const& it : expansion_)
+      max_p = std::max(max_p, it.prob());
+  }
+
+  for (auto const& it : expansion_) {
+    if (det_type_ == MOST_LIKELY_OUTCOMES && it.prob() < max_p)
+      continue;
+    // Self-loops are useless for a deterministic planner. For the
+    // most-likely determinization, this also ignores the action when doing
+    // nothing is (one of) its most likely outcome
+    if (it.event() == s)
+      continue;
+    successors_.emplace_back(it.event(), it.prob());
+  }
+}
+
+
+DetPlannerReturnType InternalGBFSInterface::search(state_t const& s) {
+  nodes_.clear();
+  open_.clear();
+  closed_.clear();
+  goal_node_ = NO_PARENT;
+
+  problem_t const& p = problem();
+  double dead_end = gpt::dead_end_value.double_value();
+  uint64_t deadline = 0;
+  if (timeoutInSecs() > 0)
+    deadline = get_cputime_usec() + timeoutInSecs() * 1000000;
+
+  int root = addNode(s, NO_PARENT, nullptr, 1.0, 0);
+  if (p.goal().holds(s)) {
+    goal_node_ = root;
+    return SUCCESS;
+  }
+  double h_root = heuristic_->value(s);
+  if (h_root >= dead_end)
+    return NO_PLAN;
+  open_.push_back(OpenEntry{h_root, 0, root});
+
+  size_t expansions = 0;
+  while (!open_.empty()) {
+    std::pop_heap(open_.begin(), open_.end());
+    int cur = open_.back().node;
+    open_.pop_back();
+
+    ++expansions;
+    ++total_expansions_;
+    if (deadline && expansions % 1024 == 0 && get_cputime_usec() > deadline)
+      return TIMEOUT;
+
+    // nodes_ can be reallocated by addNode, so copying what is needed
+    state_t cur_state = nodes_[cur].state;
+    size_t succ_g = nodes_[cur].g + 1;
+
+    p.applicable_actions(cur_state, applicable_);
+    for (action_t const* a : applicable_) {
+      determinizedSuccessors(cur_state, *a);
+      for (auto const& succ : successors_) {
+        if (closed_.find(succ.first) != closed_.end())
+          continue;
+        int id = addNode(succ.first, cur, a, succ.second, succ_g);
+        // Goal test on generation, as in FF's enforced hill-climbing and
+        // LAMA's lazy search
+        if (p.goal().holds(succ.first)) {
+          goal_node_ = id;
+          return SUCCESS;
+        }
+        double h = heuristic_->value(succ.first);
+        if (h >= dead_end)
+          continue;
+        open_.push_back(OpenEntry{h, succ_g, id});
+        std::push_heap(open_.begin(), open_.end());
+      }
+    }
+  }
+  return NO_PLAN;
+}
+
+
+/*
+ * _planFrom
+ */
+DetPlannerReturnType InternalGBFSInterface::_planFrom(state_t const& s,
+    std::vector<std::pair<double, state_t> >& state_trace,
+    std::vector<action_t const*>* action_trace,
+    double likelihood_cutoff)
+{
+  countCall();
+  DetPlannerReturnType retcode = search(s);
+  if (retcode != SUCCESS)
+    return retcode;
+
+  // Collecting the nodes from the goal back to s (excluded)
+  std::vector<int> path;
+  for (int n = goal_node_; nodes_[n].parent != NO_PARENT; n = nodes_[n].parent)
+    path.push_back(n);
+
+  double cur_likelihood = 1.0;
+  for (auto it = path.rbegin(); it != path.rend(); ++it) {
+    SearchNode const& node = nodes_[*it];
+    cur_likelihood *= node.prob;
+    if (cur_likelihood < likelihood_cutoff)
+      break;
+    state_trace.push_back(std::make_pair(cur_likelihood, node.state));
+    if (action_trace)
+      action_trace->push_back(node.action);
+  }
+  return SUCCESS;
+}
+
+
+/*
+ * _lengthAndLikelihoodPlanFrom
+ */
+DetPlannerReturnType InternalGBFSInterface::_lengthAndLikelihoodPlanFrom(
+    state_t const& s, size_t& length, double* likelihood)
+{
+  countCall();
+  DetPlannerReturnType retcode = search(s);
+  if (retcode != SUCCESS)
+    return retcode;
+
+  length = nodes_[goal_node_].g;
+  if (likelihood) {
+    (*likelihood) = 1.0;
+    for (int n = goal_node_; nodes_[n].parent != NO_PARENT;
+         n = nodes_[n].parent)
+      (*likelihood) *= nodes_[n].prob;
+  }
+  return SUCCESS;
+}
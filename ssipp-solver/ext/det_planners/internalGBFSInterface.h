@@ -0,0 +1,109 @@
+#ifndef INTERNAL_GBFS_INTERFACE_H
+#define INTERNAL_GBFS_INTERFACE_H
+
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+#include "externalDetPlannerInterface.h"
+#include "../mgpt/states.h"
+#include "../../heuristics/heuristic_iface.h"
+#include "../../ssps/prob_dist_state.h"
+
+
+/*******************************************************************************
+ *
+ * InternalGBFSInterface
+ *
+ * Deterministic planner that runs in the same process as the probabilistic
+ * planner: greedy best-first search over the grounded problem_t (i.e., over
+ * problem_t::actionsT()) using either h_add or h_FF on the all-outcomes
+ * determinization as heuristic. Each outcome of an action is a deterministic
+ * action of the determinization; if MOST_LIKELY_OUTCOMES is used, then only
+ * the most likely outcomes of each action are considered.
+ *
+ * Differently from ExternalFFInterface and ExternalLamaInterface, no PDDL is
+ * written and no process is created per call. Moreover, since the plan found
+ * is already a sequence of action_t, executionTrace is not needed and the
+ * trace is obtained directly from the search nodes. The search memory (nodes,
+ * open list and closed list) is kept between calls and only cleared, so
+ * consecutive calls do not need to reallocate it.
+ *
+ ******************************************************************************/
+class InternalGBFSInterface : public ExternalDetPlannerInterface {
+ public:
+  enum HeuristicType {H_ADD = 0, H_FF};
+
+  InternalGBFSInterface(problem_t const& problem, size_t timeout_in_secs,
+                        DeterminizationType det_type,
+                        HeuristicType heuristic_type = H_FF);
+  ~InternalGBFSInterface() { }
+
+  size_t totalExpansions() const { return total_expansions_; }
+
+ protected:
+  DetPlannerReturnType _planFrom(state_t const& s,
+     std::vector<std::pair<double, state_t> >& state_trace,
+     std::vector<action_t const*>* action_trace,
+     double likelihood_cutoff = 0.0) override;
+
+  /* Only used through run(): planFrom and the length and likelihood queries
+   * take the plan directly from the search nodes */
+  DetPlannerReturnType _run(state_t const& s,
+                            std::vector<DetPlannerUnparsedAction>& plan)
+                                                                      override;
+
+  DetPlannerReturnType _lengthAndLikelihoodPlanFrom(state_t const& s,
+      size_t& length, double* likelihood = NULL) override;
+
+ private:
+  static int const NO_PARENT = -1;
+
+  struct SearchNode {
+    state_t state;
+    int parent;
+    // Action applied to the parent to reach this node and probability of the
+    // outcome of action that generates state
+    action_t const* action;
+    double prob;
+    size_t g;
+  };
+
+  struct OpenEntry {
+    double h;
+    size_t g;
+    int node;
+    // Min-heap by h and, for ties, by g (FIFO on the node id otherwise)
+    bool operator<(OpenEntry const& rhs) const {
+      if (h != rhs.h) return h > rhs.h;
+      if (g != rhs.g) return g > rhs.g;
+      return node > rhs.node;
+    }
+  };
+
+  // Runs the search from s. If SUCCESS is returned, goal_node_ is the node id
+  // of the goal state found
+  DetPlannerReturnType search(state_t const& s);
+
+  // Populates successors_ with the successors of s in the determinization
+  void determinizedSuccessors(state_t const& s, action_t const& a);
+
+  int addNode(state_t const& s, int parent, action_t const* a, double prob,
+              size_t g);
+
+  DeterminizationType det_type_;
+  std::unique_ptr<heuristic_t> heuristic_;
+
+  /*** Search memory: cleared (but not freed) at the beginning of search ***/
+  std::vector<SearchNode> nodes_;
+  std::vector<OpenEntry> open_;
+  std::unordered_map<state_t, int, hashState> closed_;
+  std::vector<action_t const*> applicable_;
+  ProbDistStateVector expansion_;
+  std::vector<std::pair<state_t, double> > successors_;
+  int goal_node_;
+
+  size_t total_expansions_;
+};
+
+#endif  // INTERNAL_GBFS_INTERFACE_H
@@ -1,5 +1,6 @@
 #include "actions.h"
 #include "../../utils/exceptions.h"
+#include "../../utils/rand48.h"
 #include "problems.h"
 #include "domains.h"
 #include "formulas.h"
@@ -496,7 +497,7 @@ bool
 probabilisticEffectList_t::affect(state_t const& state, state_t& s_prime,
     bool nprec ) const
 {
-  double r = drand48();
+  double r = rand48Double();
   double sum = 0;
   for( size_t i = 0; i < size(); ++i )
   {
@@ -906,7 +907,9 @@ bool probabilisticEffect_t::is_reward_consistent_with(
  *
  ******************************************************************************/
 
-action_t::action_t(const std::string &name, const std::string &nameXML) : ref_count_(0)
+action_t::action_t(const std::string &name, const std::string &nameXML)
+  : ref_count_(0), hot_values_cached_(false),
+    hot_cost_is_state_independent_(false)
 {
   action_t::register_use(this);
   name_ = strdup(name.c_str());
@@ -924,6 +927,13 @@ action_t::~action_t()
   free( (void*)nameXML_ );
 }
 
+void action_t::precompute_hot_values() {
+  hot_cost_is_state_independent_ = !has_state_dependent_cost();
+  if (hot_cost_is_state_independent_)
+    hot_cost_ = HotRational(cost(ACTION_COST));
+  hot_values_cached_ = true;
+}
+
   void
 action_t::insert_precondition( const atomList_t &alist )
 {
@@ -1045,6 +1055,24 @@ bool deterministicAction_t::simplify_confiditonal() {
 }
 
 
+// Returns true if any of the conditional effects in c_list changes the cost
+static bool conditionalEffectListChangesCost(
+    conditionalEffectList_t const& c_list)
+{
+  for (size_t i = 0; i < c_list.size(); ++i) {
+    if (c_list.effect(i).s_effect().cost(ACTION_COST) != Rational(0))
+      return true;
+  }
+  return false;
+}
+
+
+bool deterministicAction_t::has_state_dependent_cost() const {
+  return gpt::use_action_cost
+          && conditionalEffectListChangesCost(effect_.c_effect());
+}
+
+
 Rational deterministicAction_t::cost(size_t cost_idx) const {
   if (gpt::use_action_cost) {
     if (cost_idx == ACTION_COST) {
@@ -1176,7 +1204,9 @@ void probabilisticAction_t::expand_hash_based(state_t const& s,
       << std::endl;
   }
 
-  static ProbDistStateHash pr_hash;
+  // thread_local so actions can be expanded concurrently (e.g., by the batch
+  // feature extraction of pyssipp)
+  static thread_local ProbDistStateHash pr_hash;
   pr_hash.clear();
   expand_directly(s, pr_hash, nprec);
 
@@ -1194,14 +1224,41 @@ void probabilisticAction_t::expand_hash_based(state_t const& s,
 void probabilisticAction_t::expand_directly(state_t const& s,
     ProbDistStateIface& pr, bool nprec) const
 {
+  if (outcome_table_ && !nprec) {
+    outcome_table_->expand(s, pr);
+    return;
+  }
+
   pr.clear();
   for (size_t i = 0; i < effect().size(); ++i) {
-    // TODO(fwt): make this more efficient
     state_t s_prime = s;
     effect(i).affect(s, s_prime, nprec);
     s_prime.make_digest();
-    pr.insert(s_prime, probability(i).double_value());
+    pr.insert(s_prime, hot_values_cached_ ? hot_probabilities_[i]
+                                          : probability(i).double_value());
+  }
+}
+
+
+bool probabilisticAction_t::has_state_dependent_cost() const {
+  if (!gpt::use_action_cost)
+    return false;
+  for (size_t i = 0; i < size(); ++i) {
+    if (conditionalEffectListChangesCost(effect(i).c_effect()))
+      return true;
   }
+  return false;
+}
+
+
+void probabilisticAction_t::precompute_hot_values() {
+  hot_probabilities_.resize(size());
+  for (size_t i = 0; i < size(); ++i)
+    hot_probabilities_[i] = probability(i).double_value();
+  // Same width used by state_t::initialize
+  size_t width = (problem_t::number_atoms() + 31) / 32;
+  outcome_table_.reset(new OutcomeTable(*this, width));
+  action_t::precompute_hot_values();
 }
 
 
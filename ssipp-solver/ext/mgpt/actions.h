@@ -9,11 +9,13 @@
 #include "terms.h"
 #include "../../utils/utils.h"
 #include "atom_list.h"
+#include "outcome_table.h"
 
 #include <assert.h>
 #include <iostream>
 #include <list>
 #include <map>
+#include <memory>
 #include <string>
 #include <unordered_map>
 
@@ -472,8 +474,16 @@ class action_t
  protected:
   action_t( const std::string &name, const std::string &nameXML );
 
+  // Values precomputed by precompute_hot_values() for the planners' hot path.
+  // hot_cost_ is only meaningful if the cost of this action does not depend on
+  // the state (i.e., no conditional effect changes the cost).
+  bool hot_values_cached_;
+  bool hot_cost_is_state_independent_;
+  HotRational hot_cost_;
+
  public:
-  action_t() : ref_count_(0) { }
+  action_t() : ref_count_(0), hot_values_cached_(false),
+               hot_cost_is_state_independent_(false) { }
   virtual ~action_t();
 
   static void register_use( const action_t *a )
@@ -538,6 +548,27 @@ class action_t
   virtual Rational cost_upperbound() const = 0;
   virtual void shift_cost_by(Rational c) = 0;
 
+  // Returns true if at least one conditional effect changes the cost of this
+  // action, i.e., cost(s) depends on s.
+  virtual bool has_state_dependent_cost() const = 0;
+
+  /*
+   * Caches the cost (if state independent) and the outcome probabilities of
+   * this action as HotRational/doubles. This is called once by
+   * problem_t::flatten after all the costs are final; any later change of cost
+   * (e.g., shift_cost_by) invalidates the cache and the slow path is used until
+   * this method is called again.
+   */
+  virtual void precompute_hot_values();
+
+  // C(s,a) as used by the planners. Equivalent to cost(s) but it avoids the
+  // virtual calls and the Rational arithmetic if the cached value is valid.
+  HotRational hot_cost(state_t const& s) const {
+    if (hot_values_cached_ && hot_cost_is_state_independent_)
+      return hot_cost_;
+    return HotRational(cost(s));
+  }
+
   virtual void probability_of_adding_atoms(state_t const& s,
       HashAtomtToRational& prob) const = 0;
 
@@ -604,7 +635,12 @@ class deterministicAction_t : public action_t
       return Rational(1);
     }
   }
-  virtual void shift_cost_by(Rational c) { effect_.shift_cost_by(c); }
+  virtual void shift_cost_by(Rational c) {
+    effect_.shift_cost_by(c);
+    hot_values_cached_ = false;
+  }
+
+  virtual bool has_state_dependent_cost() const;
 
   virtual bool simplify_confiditonal();
 
@@ -656,6 +692,11 @@ class deterministicAction_t : public action_t
 class probabilisticAction_t : public action_t
 {
   probabilisticEffectList_t effect_list_;
+  // probability(i).double_value() cached by precompute_hot_values()
+  std::vector<double> hot_probabilities_;
+  // Compiled version of effect_list_ built by precompute_hot_values() and
+  // used by expand_directly (see outcome_table.h)
+  std::unique_ptr<OutcomeTable const> outcome_table_;
 
   public:
   probabilisticAction_t( const std::string &name, const std::string &nameXML );
@@ -699,7 +740,13 @@ class probabilisticAction_t : public action_t
 
   virtual bool simplify_confiditonal() { return false; }
 
-  virtual void shift_cost_by(Rational c) { effect_list_.shift_cost_by(c); }
+  virtual void shift_cost_by(Rational c) {
+    effect_list_.shift_cost_by(c);
+    hot_values_cached_ = false;
+  }
+
+  virtual bool has_state_dependent_cost() const;
+  virtual void precompute_hot_values();
 
   virtual bool empty( void ) const;
   virtual bool affect( state_t& state, bool nprec = false ) const;
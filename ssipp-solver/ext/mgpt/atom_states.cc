@@ -1,5 +1,6 @@
 #include <assert.h>
 #include <math.h>
+#include <mutex>
 #include <sstream>
 #include <stdlib.h>
 
@@ -23,6 +24,7 @@
 enum { CLEAR = 0x0, OPEN = 0x1, CLOSED = 0x2 };
 std::unique_ptr<stateHash_t> state_t::state_hash_ = nullptr;
 bool state_t::state_space_generated_ = false;
+bool state_t::concurrent_access_ = false;
 size_t state_t::size_ = 0;
 
 bool state_t::holds(Atom const& atom) const {
@@ -57,6 +59,13 @@ void state_t::statistics( std::ostream &os )
   const state_t*
 state_t::get_state( const state_t &state )
 {
+  // Different threads might insert states in different hash_t (e.g., one
+  // planner per thread in ParallelLocalSimulator), so the interning table is
+  // shared and needs a lock
+  static std::mutex state_hash_mutex;
+  if (!concurrent_access_)
+    return( state_hash_->get( state )->state() );
+  std::lock_guard<std::mutex> lock(state_hash_mutex);
   return( state_hash_->get( state )->state() );
 }
 
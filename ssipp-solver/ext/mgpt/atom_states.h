@@ -1,6 +1,7 @@
 #ifndef ATOM_STATES_H
 #define ATOM_STATES_H
 
+#include <cstdint>
 #include <cstring>
 #include <deque>
 #include <list>
@@ -44,6 +45,7 @@ class state_t
   static size_t size_;
   static std::unique_ptr<stateHash_t> state_hash_;
   static bool state_space_generated_;
+  static bool concurrent_access_;
 
  public:
   explicit state_t() : data_(new unsigned[size_]()) {
@@ -131,6 +133,11 @@ class state_t
   static void finalize( void );
   static void statistics( std::ostream &os );
   static const state_t* get_state( const state_t &state );
+  // get_state locks the interning table only while concurrent access is on,
+  // i.e., while several threads can insert states (see
+  // ParallelLocalSimulator). It must be changed while no other thread runs.
+  static void set_concurrent_access( bool concurrent )
+    { concurrent_access_ = concurrent; }
   static void generate_state_space(const problem_t &problem,
       hash_t &hash_table, std::deque<hashEntry_t*> &space);
   // Use max_depth equals 0 to expand the space completely
@@ -144,6 +151,14 @@ class state_t
   void make_digest( void ) { }
   bool make_check( void ) const { return( true ); }
   const unsigned* data( void ) const { return( data_ ); }
+  // Raw access to the size() words of the state. Used by the compiled
+  // expansion of actions (see OutcomeTable)
+  unsigned* mutable_data() {
+#ifdef CACHE_ISGOAL_CALLS
+    clearGoalFlag();
+#endif
+    return data_;
+  }
   unsigned hash_value( void ) const
   {
 #if 1
@@ -168,6 +183,20 @@ class state_t
 #endif
   }
   unsigned digest( void ) const { return( hash_value() ); }
+  // 64-bit multiplicative hash of the state words. Much cheaper than
+  // hash_value (no MD4) and wide enough to be used as the key of
+  // fingerprint-based tables (see HeuristicCache)
+  uint64_t hash64() const {
+    uint64_t h = 0x9e3779b97f4a7c15ULL ^ size_;
+    for (size_t i = 0; i < size_; ++i) {
+      h = (h ^ data_[i]) * 0xff51afd7ed558ccdULL;
+      h ^= h >> 32;
+    }
+    h ^= h >> 33;
+    h *= 0xc4ceb9fe1a85ec53ULL;
+    h ^= h >> 33;
+    return h;
+  }
 
   bool operator==(state_t const& state) const {
     return (
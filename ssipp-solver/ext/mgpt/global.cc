@@ -82,6 +82,19 @@ namespace gpt
   bool hash_all = true;
   std::string heuristic = "smartZero";
   size_t initial_hash_size = 204800;
+  // Number of entries of the HeuristicCache of the heuristics created by
+  // createHeuristic (0 disables it)
+  size_t heuristic_cache_size = 0;
+  // Number of threads used to generate the depth-based and trajectory-based
+  // short-sighted SSPs (see ShortSightedSSP)
+  size_t s4p_threads = 1;
+  // Number of threads used by the local simulator to run the rounds (see
+  // ParallelLocalSimulator)
+  size_t simulator_threads = 1;
+  // Value tables (see ssps/value_table_io.h) used to warm start the planner
+  // and to save its value function after the execution ("" for none)
+  std::string load_values_file = "";
+  std::string save_values_file = "";
   unsigned max_database_size = 32;
   bool noise = false;
   double noise_level = 0;
@@ -133,6 +133,11 @@ namespace gpt
   extern bool hash_all;
   extern std::string heuristic;
   extern size_t initial_hash_size;
+  extern size_t heuristic_cache_size;
+  extern size_t s4p_threads;
+  extern size_t simulator_threads;
+  extern std::string load_values_file;
+  extern std::string save_values_file;
   extern unsigned max_database_size;
   extern bool noise;
   extern double noise_level;
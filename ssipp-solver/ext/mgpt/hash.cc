@@ -80,6 +80,8 @@ hash_t::hash_t( unsigned dimension, heuristic_t &heuristic )
 {
   ext_ = false;
   size_ = 0;
+  update_counter_ = 0;
+  total_q_calls_ = 0;
   heuristic_ = &heuristic;
   dimension_ = prime( dimension );
   table_ = (hashEntry_t**)calloc( dimension_, sizeof(hashEntry_t*) );
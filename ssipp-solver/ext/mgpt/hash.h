@@ -1,6 +1,8 @@
 #ifndef HASH_H
 #define HASH_H
 
+#include <atomic>
+
 #include "global.h"
 #include "../../heuristics/heuristic_iface.h"
 #include "states.h"
@@ -93,7 +95,8 @@ class hash_t
   unsigned *number_;
   mutable heuristic_t *heuristic_;
   hashEntry_t **table_;
-  size_t update_counter_;
+  // Atomic because different entries can be updated concurrently
+  std::atomic<size_t> update_counter_;
   uint64_t total_q_calls_;
 
   void rehash( void );
@@ -116,7 +119,9 @@ class hash_t
 
   size_t get_update_counter() const { return update_counter_; }
   void reset_update_counter() { } //update_counter_ = 0;
-  void increment_counter() { update_counter_++; }
+  void increment_counter() {
+    update_counter_.fetch_add(1, std::memory_order_relaxed);
+  }
 
   void set_extended( void ) { ext_ = true; }
   unsigned hash_value(state_t const& s) const {
@@ -0,0 +1,154 @@
+#include "outcome_table.h"
+
+#include <cstring>
+
+#include "actions.h"
+#include "atom_states.h"
+
+
+OutcomeTable::OutcomeTable(probabilisticAction_t const& action, size_t width)
+  : width_(width)
+{
+  for (size_t i = 0; i < action.size(); ++i) {
+    probabilisticEffect_t const& p_eff = action.effect(i);
+    Outcome outcome;
+    outcome.probability = action.probability(i).double_value();
+    outcome.effect = compileEffect(p_eff.s_effect());
+    outcome.cond_begin = cond_effects_.size();
+
+    conditionalEffectList_t const& c_list = p_eff.c_effect();
+    for (size_t j = 0; j < c_list.size(); ++j) {
+      conditionalEffect_t const& c_eff = c_list.effect(j);
+      ConditionalEffect ce;
+      ce.conj_begin = conj_ranges_.size();
+      for (size_t k = 0; k < c_eff.precondition().size(); ++k)
+        compileConjunction(c_eff.precondition().atom_list(k));
+      ce.conj_end = conj_ranges_.size();
+      if (ce.conj_begin == ce.conj_end) {
+        // The condition never holds, so this effect is never applied
+        continue;
+      }
+      ce.effect = compileEffect(c_eff.s_effect());
+      cond_effects_.push_back(ce);
+    }
+    outcome.cond_end = cond_effects_.size();
+    outcomes_.push_back(outcome);
+  }
+}
+
+
+OutcomeTable::Effect OutcomeTable::compileEffect(stripsEffect_t const& s_eff) {
+  // Collecting the add and delete bits of each word touched by the effect
+  std::vector<unsigned> add(width_, 0), del(width_, 0);
+  size_t touched = 0;
+  auto mark = [&](std::vector<unsigned>& masks, atom_t atom) {
+    size_t w = atom >> 5;
+    DIE(w < width_, "Atom outside of the state width", 171);
+    if (!add[w] && !del[w])
+      touched++;
+    masks[w] |= (1u << (atom % 32));
+  };
+  for (size_t i = 0; i < s_eff.add_list().size(); ++i)
+    mark(add, s_eff.add_list().atom(i));
+  for (size_t i = 0; i < s_eff.del_list().size(); ++i)
+    mark(del, s_eff.del_list().atom(i));
+
+  Effect eff;
+  eff.dense = (touched > DENSE_THRESHOLD);
+  if (eff.dense) {
+    eff.ops_begin = dense_add_.size();
+    for (size_t w = 0; w < width_; ++w) {
+      dense_add_.push_back(add[w]);
+      dense_keep_.push_back(~del[w]);
+    }
+    eff.ops_end = dense_add_.size();
+  }
+  else {
+    eff.ops_begin = ops_.size();
+    for (size_t w = 0; w < width_; ++w) {
+      if (add[w] || del[w])
+        ops_.push_back(WordOp{(unsigned) w, add[w], ~del[w]});
+    }
+    eff.ops_end = ops_.size();
+  }
+  return eff;
+}
+
+
+bool OutcomeTable::compileConjunction(atomList_t const& conj) {
+  if (conj.contradiction())
+    return false;
+
+  std::vector<unsigned> pos(width_, 0), neg(width_, 0);
+  for (size_t i = 0; i < conj.size(); ++i) {
+    atom_t atm = conj.atom(i);
+    // Same semantics as atomList_t::holds(state, nprec = false)
+    atom_t positive = atm & ~atom_t(1);
+    size_t w = positive >> 5;
+    DIE(w < width_, "Atom outside of the state width", 171);
+    if (atm % 2)
+      neg[w] |= (1u << (positive % 32));
+    else
+      pos[w] |= (1u << (positive % 32));
+  }
+
+  size_t begin = cond_words_.size();
+  for (size_t w = 0; w < width_; ++w) {
+    if (pos[w] || neg[w])
+      cond_words_.push_back(CondWord{(unsigned) w, pos[w], neg[w]});
+  }
+  conj_ranges_.push_back(std::make_pair(begin, cond_words_.size()));
+  return true;
+}
+
+
+bool OutcomeTable::conditionHolds(ConditionalEffect const& ce,
+                                  unsigned const* s) const
+{
+  for (size_t c = ce.conj_begin; c < ce.conj_end; ++c) {
+    bool holds = true;
+    for (size_t i = conj_ranges_[c].first;
+         holds && i < conj_ranges_[c].second; ++i)
+    {
+      CondWord const& cw = cond_words_[i];
+      holds = ((s[cw.word] & cw.pos) == cw.pos) && !(s[cw.word] & cw.neg);
+    }
+    if (holds)
+      return true;
+  }
+  return false;
+}
+
+
+void OutcomeTable::applyEffect(Effect const& eff, unsigned* s) const {
+  if (eff.dense) {
+    unsigned const* add = &dense_add_[eff.ops_begin];
+    unsigned const* keep = &dense_keep_[eff.ops_begin];
+    for (size_t w = 0; w < width_; ++w)
+      s[w] = (s[w] | add[w]) & keep[w];
+  }
+  else {
+    for (size_t i = eff.ops_begin; i < eff.ops_end; ++i)
+      s[ops_[i].word] = (s[ops_[i].word] | ops_[i].add) & ops_[i].keep;
+  }
+}
+
+
+void OutcomeTable::expand(state_t const& s, ProbDistStateIface& pr) const {
+  assert(width_ <= state_t::size());
+  pr.clear();
+  unsigned const* s_data = s.data();
+  state_t s_prime(s);
+  for (Outcome const& outcome : outcomes_) {
+    s_prime = s;
+    unsigned* sp_data = s_prime.mutable_data();
+    applyEffect(outcome.effect, sp_data);
+    // Conditions are tested over s and not s_prime (see
+    // deterministicEffect_t::affect)
+    for (size_t c = outcome.cond_begin; c < outcome.cond_end; ++c) {
+      if (conditionHolds(cond_effects_[c], s_data))
+        applyEffect(cond_effects_[c].effect, sp_data);
+    }
+    pr.insert(s_prime, outcome.probability);
+  }
+}
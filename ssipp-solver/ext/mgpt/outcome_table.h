@@ -0,0 +1,110 @@
+#ifndef OUTCOME_TABLE_H
+#define OUTCOME_TABLE_H
+
+#include <vector>
+
+#include "global.h"
+#include "../../ssps/prob_dist_state.h"
+
+class atomList_t;
+class atomListList_t;
+class stripsEffect_t;
+class probabilisticAction_t;
+class state_t;
+
+
+/*******************************************************************************
+ *
+ * outcome table
+ *
+ * Flat representation of the outcomes of a ground probabilistic action used by
+ * probabilisticAction_t::expand. Instead of walking the effect tree of the
+ * action (probabilisticEffect_t -> stripsEffect_t + conditionalEffectList_t)
+ * for every expansion, each effect is compiled into masks over the words of
+ * state_t::data():
+ *
+ *  - An effect is a list of WordOps. Applying a WordOp to a word x results in
+ *    (x | add) & keep, i.e., adds are applied before deletes as in
+ *    stripsEffect_t::affect.
+ *  - The condition of a conditional effect is a disjunction of conjunctions
+ *    and each conjunction is a list of CondWords. A CondWord holds for a word x
+ *    iff (x & pos) == pos and (x & neg) == 0.
+ *
+ * The ops of an effect are sparse (only the words touched by the effect are
+ * stored). Effects touching more words than fit in a cache line are stored
+ * densely (one add and one keep word for every word of the state) and applied
+ * with a straight loop over the whole state that the compiler vectorises.
+ *
+ * Only the nprec = false semantics is compiled, i.e., odd atoms in conditions
+ * mean that the corresponding even atom does not hold.
+ *
+ ******************************************************************************/
+class OutcomeTable {
+ public:
+  // width is the number of words of state_t::data() for the states that will
+  // be expanded. States with more words can also be expanded since the extra
+  // words are not touched by the action.
+  OutcomeTable(probabilisticAction_t const& action, size_t width);
+  ~OutcomeTable() { }
+
+  // Populates pr with the successors of s (pr is cleared before). The outcomes
+  // are inserted in the same order as probabilisticAction_t::expand_directly.
+  void expand(state_t const& s, ProbDistStateIface& pr) const;
+
+  size_t size() const { return outcomes_.size(); }
+
+ private:
+  // Number of words of state_t::data() in a 64-byte cache line
+  static size_t const DENSE_THRESHOLD = 64 / sizeof(unsigned);
+
+  struct WordOp {
+    unsigned word;
+    unsigned add;
+    unsigned keep;
+  };
+
+  struct CondWord {
+    unsigned word;
+    unsigned pos;
+    unsigned neg;
+  };
+
+  // Ranges are [begin, end) over the corresponding vector
+  struct Effect {
+    bool dense;
+    // Over ops_ if sparse or over dense_add_/dense_keep_ otherwise
+    size_t ops_begin, ops_end;
+  };
+
+  struct ConditionalEffect {
+    // Over conj_ranges_
+    size_t conj_begin, conj_end;
+    Effect effect;
+  };
+
+  struct Outcome {
+    double probability;
+    Effect effect;
+    // Over cond_effects_
+    size_t cond_begin, cond_end;
+  };
+
+  Effect compileEffect(stripsEffect_t const& s_eff);
+  // Returns false if the conjunction is a contradiction (never holds)
+  bool compileConjunction(atomList_t const& conj);
+
+  bool conditionHolds(ConditionalEffect const& ce, unsigned const* s) const;
+  void applyEffect(Effect const& eff, unsigned* s) const;
+
+  size_t width_;
+  std::vector<Outcome> outcomes_;
+  std::vector<ConditionalEffect> cond_effects_;
+  // Each conjunction is a range over cond_words_
+  std::vector<std::pair<size_t, size_t>> conj_ranges_;
+  std::vector<CondWord> cond_words_;
+  std::vector<WordOp> ops_;
+  std::vector<unsigned> dense_add_;
+  std::vector<unsigned> dense_keep_;
+};
+
+#endif  // OUTCOME_TABLE_H
@@ -554,9 +554,19 @@ void problem_t::flatten() {
     );
   }
 
+  // All the costs are final now, so the values used by the planners' hot path
+  // can be computed once (see action_t::precompute_hot_values)
+  for (actionList_t::iterator it = actionsT().begin();
+        it != actionsT().end(); ++it)
+  {
+    const_cast<action_t*>(*it)->precompute_hot_values();
+  }
+
   // builds up an action name -> action pointer map
   restring_actions();
 
+  build_successor_generator();
+
   std::cout << "Action parsing/translating/flattening summary:" << std::endl
             << "  Total possible actions  : " << t_actions << std::endl
             << "  Total ignored (empty) a.: " << t_ignored << std::endl
@@ -713,6 +723,7 @@ void problem_t::compute_weak_relaxation(problem_t &problem, bool verb,
   problem.actionsT().clear();
   problem.actionsT().insert(problem.actionsT().begin(), tmp_list.begin(),
       tmp_list.end());
+  problem.build_successor_generator();
   std::cout << "[weak relaxation] number of actions: "
             << problem.actionsT().size() << std::endl;
 }
@@ -902,6 +913,7 @@ void problem_t::compute_medium_relaxation(problem_t& problem, bool verb,
       std::cout << std::endl;
     }
   }
+  problem.build_successor_generator();
   std::cout << "[medium relaxation] number of actions: "
             << problem.actionsT().size() << std::endl;
 }
@@ -1010,6 +1022,7 @@ void problem_t::compute_strong_relaxation(problem_t &problem, bool verb,
   problem.actionsT().clear();
   problem.actionsT().insert(problem.actionsT().begin(), tmp_list.begin(),
                             tmp_list.end());
+  problem.build_successor_generator();
   std::cout << "[strong relaxation] number of actions: "
             << problem.actionsT().size() << std::endl;
 }
@@ -1098,11 +1111,49 @@ problem_t::print_full( std::ostream& os, const Action &action ) const
 }
 
 
+void problem_t::build_successor_generator() {
+  successor_generator_.reset(new SuccessorGenerator(actionsT()));
+  if (gpt::verbosity > 0)
+    successor_generator_->printStatistics(std::cout);
+}
+
+
+void problem_t::applicable_actions(state_t const& s,
+    std::vector<action_t const*>& result) const
+{
+  result.clear();
+  if (successor_generator_) {
+    static thread_local std::vector<size_t> indices;
+    successor_generator_->applicableActions(s, indices);
+    for (size_t i : indices)
+      result.push_back(actionsT()[i]);
+  }
+  else {
+    for (action_t const* a : actionsT()) {
+      if (a->enabled(s))
+        result.push_back(a);
+    }
+  }
+}
+
+
+bool problem_t::has_applicable_actions(state_t const& s) const {
+  if (successor_generator_)
+    return successor_generator_->hasApplicableActions(s);
+  for (action_t const* a : actionsT()) {
+    if (a->enabled(s))
+      return true;
+  }
+  return false;
+}
+
+
 void problem_t::expand(action_t const& a, state_t const& s,
     ProbDistStateIface& pr) const
 {
-
-  static ProbDistState non_completed_state_pr;
+  // thread_local so states can be expanded concurrently (e.g., by the
+  // parallel generation of short-sighted SSPs)
+  static thread_local ProbDistState non_completed_state_pr;
   non_completed_state_pr.clear();
   a.expand(s, non_completed_state_pr);  // FWT: maybe pass the problem nprec?
 
@@ -8,6 +8,7 @@
 #include "formulas.h"
 #include "expressions.h"
 #include "../../ssps/prob_dist_state.h"
+#include "successor_generator.h"
 #include "terms.h"
 #include "types.h"
 
@@ -49,6 +50,9 @@ class state_t;
 class problem_t {
   public:
     typedef enum { MINIMIZE_EXPECTED_COST, MAXIMIZE_GOAL_PROBABILITY } metric_t;
+    // FWT: The successor generator built by flatten() refers to actionsT_ by
+    // index. Call build_successor_generator() or
+    // invalidate_successor_generator() after changing actionsT_ afterwards.
     actionList_t actionsT_;
 
     static void clean_all_the_static_data() {
@@ -103,6 +107,11 @@ class problem_t {
     atomListList_t goalT_;
     std::map<const StateFormula*,const Atom*> instantiated_hash_;
 
+    // Built over actionsT_ by flatten() and the relaxations. If nullptr (e.g.,
+    // problems that are not flattened), then every action in actionsT_ is
+    // tested.
+    std::unique_ptr<SuccessorGenerator const> successor_generator_;
+
     static problem_t* allocate( const std::string &name, const problem_t &problem );
 
     static void compute_weak_relaxation(problem_t &problem, bool verb,
@@ -193,11 +202,22 @@ class problem_t {
     const StateFormula& original_goal() const { return( *original_goal_ ); }
 
     bool isDeadend(state_t const& s) const {
-      for (actionList_t::const_iterator ai = actionsT().begin();
-           ai != actionsT().end(); ++ai)
-        { if ((*ai)->enabled(s)) { return false; } }
-      return true;
+      return !has_applicable_actions(s);
     }
+
+    // Populates result with the actions in actionsT() enabled in s (in the
+    // same order as actionsT()). result is cleared before being populated.
+    void applicable_actions(state_t const& s,
+                            std::vector<action_t const*>& result) const;
+    bool has_applicable_actions(state_t const& s) const;
+
+    // (Re)builds the successor generator. Must be called (or
+    // invalidate_successor_generator) if actionsT() is changed after
+    // flatten().
+    void build_successor_generator();
+    // Discards the successor generator, so applicable_actions tests every
+    // action in actionsT().
+    void invalidate_successor_generator() { successor_generator_.reset(); }
     Rational goal_reward() const { return goal_reward_; }
 
     const metric_t metric( void ) const { return( metric_ ); }
@@ -236,13 +256,13 @@ class problem_t {
 
     void expand(action_t const& a, state_t const& s, ProbDistStateIface& pr) const;
 
-    Rational terminalCost(state_t const& s) const {
+    HotRational terminalCost(state_t const& s) const {
       assert(isGoal(s));
-      Rational c(0);
+      HotRational c(0);
       if (gpt::use_action_cost && gpt::use_state_cost) {
         c = goal_reward();
       }
-      assert(c >= Rational(0));
+      assert(c >= HotRational(0));
       return c;
     }
 };
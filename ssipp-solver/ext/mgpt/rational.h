@@ -70,12 +70,21 @@ class Rational_mGPT {
 };
 
 
+/*******************************************************************************
+ *
+ * Rational represented as a double. This is the representation used by the
+ * planners' hot path (see HotRational below).
+ *
+ ******************************************************************************/
 class Rational_Float {
  public:
   Rational_Float(int n = 0) : val_(n) { }
   Rational_Float(size_t n) : val_(n) { }
 
-  Rational_Float(int n, int m) : val_(n/(float) m) { }
+  Rational_Float(int n, int m) : val_(n/(double) m) { }
+  // Conversion from the exact representation. Used to move parsed values into
+  // the hot path (see HotRational).
+  Rational_Float(Rational_mGPT const& r) : val_(r.double_value()) { }
   Rational_Float(char const* s) : val_(0) {
     if (strstr(s, "/")) {
       // Number given as a Rational
@@ -108,7 +117,7 @@ class Rational_Float {
     { (*this) = operator/(*this, p); return *this; }
 
  private:
-  float val_;
+  double val_;
 
   friend bool operator<  (Rational_Float const& p, Rational_Float const& q);
   friend bool operator<= (Rational_Float const& p, Rational_Float const& q);
@@ -158,4 +167,17 @@ using Rational = Rational_Float;
 
 using VecRationals = std::vector<Rational>;
 
+/*
+ * HotRational is the numeric type of the planners' hot path, i.e., the values
+ * returned by SSPIface::cost and SSPIface::terminalCost and used in the
+ * Bellman backups. Exact rationals (-DRATIONAL) are only meant for parsing and
+ * validation of the problem, thus the hot path always uses Rational_Float
+ * unless EXACT_HOT_PATH is also defined.
+ */
+#ifdef EXACT_HOT_PATH
+using HotRational = Rational;
+#else
+using HotRational = Rational_Float;
+#endif
+
 #endif // RATIONAL_H
@@ -0,0 +1,148 @@
+#include "successor_generator.h"
+
+#include <algorithm>
+
+#include "atom_states.h"
+
+
+SuccessorGenerator::SuccessorGenerator(actionList_t const& actions)
+  : n_entries_(0), has_disjunctive_prec_(false)
+{
+  std::vector<Entry> entries;
+  for (size_t a = 0; a < actions.size(); ++a) {
+    atomListList_t const& prec = actions[a]->precondition();
+    if (prec.size() > 1)
+      has_disjunctive_prec_ = true;
+
+    for (size_t d = 0; d < prec.size(); ++d) {
+      atomList_t const& conj = prec.atom_list(d);
+      // atomList_t is sorted, so atom 2k+1 (i.e., not 2k) is always right
+      // after 2k and the literals of the entry are also sorted
+      if (conj.contradiction())
+        continue;
+      Entry e;
+      e.action_idx = a;
+      for (size_t i = 0; i < conj.size(); ++i) {
+        atom_t atm = conj.atom(i);
+        e.literals.push_back(std::make_pair(atm & ~atom_t(1), !(atm % 2)));
+      }
+      entries.push_back(std::move(e));
+    }
+  }
+  n_entries_ = entries.size();
+
+  std::sort(entries.begin(), entries.end(),
+      [](Entry const& lhs, Entry const& rhs) {
+        return lhs.literals < rhs.literals;
+      });
+  build(entries, 0, entries.size(), 0);
+}
+
+
+int SuccessorGenerator::build(std::vector<Entry> const& entries,
+                              size_t begin, size_t end, size_t pos)
+{
+  if (begin == end)
+    return NO_CHILD;
+
+  int node_idx = nodes_.size();
+  nodes_.push_back(Node());
+
+  // Entries with no more literals come first in the lexicographical order
+  std::vector<size_t> immediate;
+  size_t i = begin;
+  for (; i < end && entries[i].literals.size() == pos; ++i)
+    immediate.push_back(entries[i].action_idx);
+
+  // The next atom to be tested is the smallest one, i.e., the one of the first
+  // entry left. Entries requiring it to be false come before the ones
+  // requiring it to be true and the remaining entries do not test it.
+  atom_t test_atom = 0;
+  size_t false_begin = i, true_begin = i, dont_care_begin = i;
+  if (i < end) {
+    test_atom = entries[i].literals[pos].first;
+    while (i < end && entries[i].literals[pos] ==
+                                          std::make_pair(test_atom, false))
+      ++i;
+    true_begin = i;
+    while (i < end && entries[i].literals[pos] ==
+                                          std::make_pair(test_atom, true))
+      ++i;
+    dont_care_begin = i;
+  }
+
+  // nodes_ might be reallocated by the recursive calls, so no references to
+  // nodes_[node_idx] are kept while building the children
+  int if_false_idx = build(entries, false_begin, true_begin, pos + 1);
+  int if_true_idx = build(entries, true_begin, dont_care_begin, pos + 1);
+  int dont_care_idx = build(entries, dont_care_begin, end, pos);
+
+  Node& node = nodes_[node_idx];
+  node.atom = test_atom;
+  node.if_true = if_true_idx;
+  node.if_false = if_false_idx;
+  node.dont_care = dont_care_idx;
+  node.immediate = std::move(immediate);
+  return node_idx;
+}
+
+
+void SuccessorGenerator::applicableActions(state_t const& s,
+                                           std::vector<size_t>& result) const
+{
+  result.clear();
+  if (nodes_.empty())
+    return;
+
+  // Explicit stack to avoid recursive calls. Its max size is bounded by the
+  // depth of the tree
+  static thread_local std::vector<int> stack;
+  stack.clear();
+  stack.push_back(0);
+  while (!stack.empty()) {
+    Node const& node = nodes_[stack.back()];
+    stack.pop_back();
+    result.insert(result.end(), node.immediate.begin(), node.immediate.end());
+    if (node.dont_care != NO_CHILD)
+      stack.push_back(node.dont_care);
+    int child = (s.holds(node.atom) ? node.if_true : node.if_false);
+    if (child != NO_CHILD)
+      stack.push_back(child);
+  }
+
+  // Sorting to preserve the order of the actionList_t (tie breaking of the
+  // greedy action depends on it)
+  std::sort(result.begin(), result.end());
+  if (has_disjunctive_prec_)
+    result.erase(std::unique(result.begin(), result.end()), result.end());
+}
+
+
+bool SuccessorGenerator::hasApplicableActions(state_t const& s) const {
+  if (nodes_.empty())
+    return false;
+
+  static thread_local std::vector<int> stack;
+  stack.clear();
+  stack.push_back(0);
+  while (!stack.empty()) {
+    Node const& node = nodes_[stack.back()];
+    stack.pop_back();
+    if (!node.immediate.empty())
+      return true;
+    if (node.dont_care != NO_CHILD)
+      stack.push_back(node.dont_care);
+    int child = (s.holds(node.atom) ? node.if_true : node.if_false);
+    if (child != NO_CHILD)
+      stack.push_back(child);
+  }
+  return false;
+}
+
+
+void SuccessorGenerator::printStatistics(std::ostream& os) const {
+  os << "[SuccessorGenerator] entries: " << n_entries_
+     << " nodes: " << nodes_.size()
+     << " disjunctive preconditions: "
+     << (has_disjunctive_prec_ ? "yes" : "no") << std::endl;
+}
@@ -0,0 +1,85 @@
+#ifndef SUCCESSOR_GENERATOR_H
+#define SUCCESSOR_GENERATOR_H
+
+#include <vector>
+
+#include "global.h"
+#include "actions.h"
+
+class state_t;
+
+
+/*******************************************************************************
+ *
+ * successor generator
+ *
+ * Decision tree over the atoms of the problem used to enumerate A(s) without
+ * testing the precondition of every ground action (similar to Fast Downward's
+ * successor_generator). Each precondition literal is a pair (atom, value)
+ * where atom is a positive (even) atom and value is true if the atom must hold
+ * and false if it must not hold (odd atoms in the atomList_t representation).
+ *
+ * Every node tests one atom and has 3 children: the subtree of entries that
+ * require the atom to be true, the subtree of entries that require it to be
+ * false and the subtree of entries that do not mention it. Entries whose
+ * literals were all tested by the path from the root are stored in the node
+ * itself. Since the literals of every entry are sorted by atom, each atom is
+ * tested at most once in any path and, by sorting the entries, the subtrees
+ * are built over contiguous ranges of entries.
+ *
+ * Disjunctive preconditions (atomListList_t with more than one atomList_t)
+ * generate one entry per disjunct; duplicates are removed when generating the
+ * applicable actions.
+ *
+ * The actions are referenced by their index in the actionList_t given to the
+ * ctor, and the generated indices are always in increasing order. Therefore
+ * iterating over them is equivalent to iterating over the actionList_t and
+ * testing action_t::enabled for each action.
+ *
+ ******************************************************************************/
+class SuccessorGenerator {
+ public:
+  explicit SuccessorGenerator(actionList_t const& actions);
+  ~SuccessorGenerator() { }
+
+  // Populates result with the indices of all the actions enabled in s (in
+  // increasing order). result is cleared before being populated.
+  void applicableActions(state_t const& s, std::vector<size_t>& result) const;
+
+  // Returns true if at least one action is enabled in s
+  bool hasApplicableActions(state_t const& s) const;
+
+  size_t numberOfNodes() const { return nodes_.size(); }
+  void printStatistics(std::ostream& os) const;
+
+ private:
+  static int const NO_CHILD = -1;
+
+  struct Node {
+    atom_t atom;
+    int if_true;
+    int if_false;
+    int dont_care;
+    // Entries that have no more literals to be tested
+    std::vector<size_t> immediate;
+  };
+
+  struct Entry {
+    size_t action_idx;
+    // Pairs (positive atom, required value) sorted by atom
+    std::vector<std::pair<atom_t, bool>> literals;
+  };
+
+  // Builds the subtree for entries[begin, end) and returns the index of its
+  // root or NO_CHILD if the range is empty. Assumes that the entries are
+  // lexicographically sorted by their literals and that the first pos
+  // literals of every entry in the range were already tested.
+  int build(std::vector<Entry> const& entries, size_t begin, size_t end,
+            size_t pos);
+
+  std::vector<Node> nodes_;
+  size_t n_entries_;
+  bool has_disjunctive_prec_;
+};
+
+#endif  // SUCCESSOR_GENERATOR_H
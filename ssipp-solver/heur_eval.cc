@@ -123,7 +123,7 @@ int main(int argc, char** argv) {
     CutResult cut_res = lm_cut_p->valueAndCuts(state);
     std::cout << "lm-cut value: " << cut_res.value << std::endl;
     std::cout << "lm-cut disjunctive landmarks:" << std::endl;
-    for (const std::set<const action_t*> &cut_set : cut_res.cuts) {
+    for (auto const& cut_set : cut_res.cuts) {
       if (!cut_set.size()) {
         std::cout << "\t(empty)" << std::endl;
       } else {
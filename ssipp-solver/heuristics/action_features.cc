@@ -0,0 +1,207 @@
+#include <algorithm>
+#include <atomic>
+#include <cctype>
+#include <cstring>
+#include <exception>
+#include <limits>
+#include <stdexcept>
+#include <thread>
+
+#include "action_features.h"
+#include "heuristic_factory.h"
+
+
+namespace {
+// Determinized actions are named after the original action followed by
+// suffixes such as "-prob-1", "-prec-0" and "-c-2" (the same names handled
+// by Cutter.act_re in asnets/interfaces/ssipp_interface.py). Returns the name
+// of the original action without the suffixes and the surrounding parens.
+std::string asnetsActionName(std::string name) {
+  static char const* const SUFFIXES[] = {"-prob-", "-prec-", "-c-"};
+  bool stripped = true;
+  while (stripped) {
+    stripped = false;
+    size_t end = name.size();
+    size_t digits = end;
+    while (digits > 0 && isdigit(name[digits - 1])) --digits;
+    if (digits == end)
+      break;
+    for (char const* suffix : SUFFIXES) {
+      size_t len = strlen(suffix);
+      if (digits >= len && name.compare(digits - len, len, suffix) == 0) {
+        name.erase(digits - len);
+        stripped = true;
+        break;
+      }
+    }
+  }
+  if (name.size() >= 2 && name.front() == '(' && name.back() == ')')
+    return name.substr(1, name.size() - 2);
+  return name;
+}
+}  // namespace
+
+
+ActionFeatureExtractor::ActionFeatureExtractor(problem_t const& problem,
+    std::vector<std::string> const& action_names, FeatureType type,
+    std::string const& heuristic_name, size_t n_threads)
+  : problem_(problem), ssp_(problem), type_(type),
+    action_names_(action_names)
+{
+  if (n_threads == 0) {
+    throw std::invalid_argument("ActionFeatureExtractor needs at least one "
+                                "thread");
+  }
+  for (size_t i = 0; i < action_names_.size(); ++i) {
+    name_to_idx_[action_names_[i]] = i;
+    actions_.push_back(problem_.find_action("(" + action_names_[i] + ")"));
+  }
+
+  // The heuristics are created here, i.e., sequentially, because their
+  // constructors might modify the problem (e.g., the strong relaxation is
+  // computed and cached by the first call to problem_t::strong_relaxation)
+  workers_.resize(n_threads);
+  for (Worker& w : workers_) {
+    if (type_ == CUT_FEATURES) {
+      w.lm_cut = std::make_shared<LMCutHeuristic>(problem_);
+    } else {
+      w.heuristic = createHeuristic(ssp_, heuristic_name);
+      // The successors of a state are mostly shared with its siblings in
+      // the batch, so memoise the values even if the global cache is off
+      if (!w.heuristic->cache())
+        w.heuristic->enableCache(WORKER_CACHE_SIZE);
+    }
+  }
+}
+
+
+void ActionFeatureExtractor::extract(std::vector<state_t> const& states,
+    float* features, double* values)
+{
+  size_t const stride = numActions() * extraDim();
+  std::fill(features, features + states.size() * stride, 0.0f);
+
+  if (workers_.size() == 1 || states.size() <= 1) {
+    for (size_t i = 0; i < states.size(); ++i) {
+      extractOne(workers_[0], states[i], features + i * stride,
+                 values ? values + i : NULL);
+    }
+    return;
+  }
+
+  // States are handed out one at a time, so an expensive state does not
+  // stall the other threads. Each state only writes its own rows of features
+  // and values, so the output does not depend on the number of threads.
+  std::atomic<size_t> next(0);
+  std::vector<std::exception_ptr> errors(workers_.size());
+  auto run = [&](size_t t) {
+    try {
+      for (size_t i = next++; i < states.size(); i = next++) {
+        extractOne(workers_[t], states[i], features + i * stride,
+                   values ? values + i : NULL);
+      }
+    } catch (...) {
+      errors[t] = std::current_exception();
+      next = states.size();
+    }
+  };
+  size_t n_threads = std::min(workers_.size(), states.size());
+  std::vector<std::thread> threads;
+  for (size_t t = 1; t < n_threads; ++t) {
+    threads.emplace_back(run, t);
+  }
+  run(0);
+  for (std::thread& th : threads) {
+    th.join();
+  }
+  for (std::exception_ptr const& e : errors) {
+    if (e) std::rethrow_exception(e);
+  }
+}
+
+
+void ActionFeatureExtractor::extractOne(Worker& w, state_t const& s,
+    float* features, double* value)
+{
+  double v = (type_ == CUT_FEATURES ? cutFeatures(w, s, features)
+                                    : heuristicFeatures(w, s, features));
+  if (value) *value = v;
+}
+
+
+int ActionFeatureExtractor::actionIndex(Worker& w, action_t const* a) const {
+  auto it = w.cut_action_idx.find(a);
+  if (it != w.cut_action_idx.end())
+    return it->second;
+  std::string name = asnetsActionName(a->name());
+  auto name_it = name_to_idx_.find(name);
+  int idx;
+  if (name_it != name_to_idx_.end()) {
+    idx = name_it->second;
+  } else {
+    auto unknown_it = w.unknown_name_idx.emplace(name,
+        numActions() + w.unknown_name_idx.size()).first;
+    idx = unknown_it->second;
+  }
+  w.cut_action_idx[a] = idx;
+  return idx;
+}
+
+
+double ActionFeatureExtractor::cutFeatures(Worker& w, state_t const& s,
+    float* features)
+{
+  CutResult res = w.lm_cut->valueAndCuts(s);
+  std::vector<int> cut_idx;
+  for (size_t c = 0; c < res.cuts.size(); ++c) {
+    // Different actions of SSiPP might have the same ASNets name (e.g.,
+    // different outcomes of the same action), so the size of the cut is the
+    // number of distinct names in it, including the names of unknown actions
+    // (as in LMCutDataGenerator.get_extra_data_no_memory)
+    cut_idx.clear();
+    for (action_t const* a : res.cuts[c]) {
+      cut_idx.push_back(actionIndex(w, a));
+    }
+    std::sort(cut_idx.begin(), cut_idx.end());
+    cut_idx.erase(std::unique(cut_idx.begin(), cut_idx.end()), cut_idx.end());
+    bool singleton = (cut_idx.size() == 1);
+    bool last = (c + 1 == res.cuts.size());
+    for (int idx : cut_idx) {
+      if (static_cast<size_t>(idx) >= numActions())
+        continue;
+      float* row = features + idx * extraDim();
+      row[IN_ANY_CUT] = 1;
+      if (singleton) row[IN_SINGLETON_CUT] = 1;
+      if (last) row[IN_LAST_CUT] = 1;
+    }
+  }
+  return res.value;
+}
+
+
+double ActionFeatureExtractor::heuristicFeatures(Worker& w, state_t const& s,
+    float* features)
+{
+  double state_value = w.heuristic->value(s);
+  for (size_t i = 0; i < actions_.size(); ++i) {
+    float* row = features + i * extraDim();
+    action_t const* a = actions_[i];
+    if (!a || !a->enabled(s)) {
+      row[DISABLED] = 1;
+      continue;
+    }
+    ssp_.expand(*a, s, w.successors);
+    double best_outcome = std::numeric_limits<double>::max();
+    for (auto const& succ : w.successors) {
+      best_outcome = std::min(best_outcome, w.heuristic->value(succ.event()));
+    }
+    if (best_outcome < state_value) {
+      row[DECREASE] = 1;
+    } else if (best_outcome == state_value) {
+      row[SAME] = 1;
+    } else {
+      row[INCREASE] = 1;
+    }
+  }
+  return state_value;
+}
@@ -0,0 +1,97 @@
+#ifndef HEURISTICS_ACTION_FEATURES_H
+#define HEURISTICS_ACTION_FEATURES_H
+
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "heuristic_iface.h"
+#include "lm_cut.h"
+#include "../ext/mgpt/problems.h"
+#include "../ssps/ppddl_adaptors.h"
+#include "../ssps/prob_dist_state.h"
+
+/* Batched computation of the per-action features used by ASNets (see
+LMCutDataGenerator and HeuristicDataGenerator in asnets/heur_inputs.py). The
+features of a batch of states are computed by n_threads threads, each one with
+its own heuristic instance, and written into a caller provided array in the
+order of the action names given to the constructor (i.e., the ASNets action
+order). Nothing in this class touches Python objects, so the caller can
+release the GIL while extract runs. */
+
+class ActionFeatureExtractor {
+ public:
+  enum FeatureType {
+    // (|A|, 3) features: in-any-cut, in-singleton-cut, in-last-cut for the
+    // LM-cut landmarks of the state
+    CUT_FEATURES = 0,
+    // (|A|, 4) features: disabled, decrease, increase, same comparing the
+    // heuristic value of the best outcome of each action with the value of
+    // the state
+    HEURISTIC_FEATURES
+  };
+  enum CutFeature {IN_ANY_CUT = 0, IN_SINGLETON_CUT, IN_LAST_CUT};
+  enum HeuristicFeature {DISABLED = 0, DECREASE, INCREASE, SAME};
+
+  // action_names are the ASNets unique identifiers of the actions, i.e., the
+  // name of the action without the surrounding parens ("move a b"). Actions
+  // unknown to SSiPP (e.g., pruned because they are never applicable) are
+  // allowed and are treated as always disabled. heuristic_name is only used
+  // for HEURISTIC_FEATURES (see createHeuristic).
+  ActionFeatureExtractor(problem_t const& problem,
+                         std::vector<std::string> const& action_names,
+                         FeatureType type,
+                         std::string const& heuristic_name = "",
+                         size_t n_threads = 1);
+  ~ActionFeatureExtractor() { }
+
+  size_t numActions() const { return action_names_.size(); }
+  size_t extraDim() const { return type_ == CUT_FEATURES ? 3 : 4; }
+  size_t numThreads() const { return workers_.size(); }
+
+  // Computes the features of each state in states. features must have room
+  // for states.size() * numActions() * extraDim() floats and is written in
+  // row-major order (state, action, feature). If values is not NULL, then
+  // values[i] is the heuristic value of states[i] (LM-cut for CUT_FEATURES).
+  void extract(std::vector<state_t> const& states, float* features,
+               double* values = NULL);
+
+ private:
+  // Per thread data. The heuristic of each worker memoises its values (see
+  // HeuristicCache), so the values of successors shared by different states
+  // are usually computed once per worker.
+  struct Worker {
+    std::shared_ptr<LMCutHeuristic> lm_cut;
+    std::shared_ptr<heuristic_t> heuristic;
+    ProbDistStateVector successors;
+    // Action of the cut to its index (see actionIndex)
+    std::unordered_map<action_t const*, int> cut_action_idx;
+    // Names of cut actions that are not in action_names_ to their index
+    std::unordered_map<std::string, int> unknown_name_idx;
+  };
+
+  // Entries of the HeuristicCache of each worker if createHeuristic did not
+  // enable one (see gpt::heuristic_cache_size)
+  static size_t const WORKER_CACHE_SIZE = 262144;
+
+  void extractOne(Worker& w, state_t const& s, float* features,
+                  double* value);
+  double cutFeatures(Worker& w, state_t const& s, float* features);
+  double heuristicFeatures(Worker& w, state_t const& s, float* features);
+  // Index in action_names_ of an action (or a relaxed operator) of SSiPP.
+  // Actions whose name is not in action_names_ get an index >= numActions()
+  // that identifies their name, so they are deduplicated by name as well.
+  int actionIndex(Worker& w, action_t const* a) const;
+
+  problem_t const& problem_;
+  SSPfromPPDDL ssp_;
+  FeatureType type_;
+  std::vector<std::string> action_names_;
+  std::unordered_map<std::string, int> name_to_idx_;
+  // actions_[i] is the action_t of action_names_[i] (or NULL)
+  std::vector<action_t const*> actions_;
+  std::vector<Worker> workers_;
+};
+
+#endif  // HEURISTICS_ACTION_FEATURES_H
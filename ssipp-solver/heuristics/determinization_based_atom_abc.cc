@@ -1,5 +1,6 @@
 #include <algorithm>  // sort
 #include <cassert>
+#include <cmath>
 #include <iostream>
 #include <limits>
 
@@ -8,6 +9,11 @@
 #include "../utils/die.h"
 #include "../ext/mgpt/atom_list.h"
 
+// Bucket queues are only used by computeCostOfAtoms if the largest possible
+// key (dead_end_value_ plus the largest operator cost) has at most this many
+// buckets
+#define H_DET_MAX_BUCKETS 10000000
+
 
 /*******************************************************************************
  *
@@ -16,9 +22,11 @@
  *
  ******************************************************************************/
 determinizationBasedAtomHeuristic::determinizationBasedAtomHeuristic(
-    problem_t const& problem, size_t cost_idx, bool use_self_loop_relaxation)
+    problem_t const& problem, size_t cost_idx, bool use_self_loop_relaxation,
+    CostAggregation aggregation, bool index_operators)
   : FactoredHeuristic("det-based-atom-H", problem),
-    cost_idx_(cost_idx), dead_end_value_(gpt::dead_end_value.double_value())
+    cost_idx_(cost_idx), dead_end_value_(gpt::dead_end_value.double_value()),
+    aggregation_(aggregation), uniform_cost_(false)
 {
   relaxation_ = &problem.strong_relaxation(use_self_loop_relaxation);
 
@@ -52,35 +60,70 @@ determinizationBasedAtomHeuristic::determinizationBasedAtomHeuristic(
   std::sort(operator_ptr_.begin(), operator_ptr_.end(),
             ActionCostIncreasing(cost_idx_));
 
-  has_prec_.resize(problem.number_atoms());
-//  std::cout << "[" << name_ << "] List of operators ordered by increasing "
-//            << "value of ";
-//  if (cost_idx_ == ACTION_COST) {
-//    std::cout << "COST";
-//  }
-//  else {
-//    std::cout << problem.domain().functions().name(cost_idx_);
-//  }
-//  std::cout << " (" << cost_idx_ << "-th cost function)" << std::endl;
-
-  // For each action o in the strong relaxation
+  if (index_operators)
+    indexOperators();
+  assert(relaxation_->goalT().size() == 1);
+}
+
+
+
+/*
+ * CSR representation of the operators and of the operators that have each
+ * atom in their precondition, used by computeCostOfAtoms
+ */
+void determinizationBasedAtomHeuristic::indexOperators() {
+  size_t n_atoms = problem_t::number_atoms();
+  op_prec_begin_.reserve(operator_ptr_.size() + 1);
+  op_add_begin_.reserve(operator_ptr_.size() + 1);
+  op_cost_.reserve(operator_ptr_.size());
+  has_prec_begin_.assign(n_atoms + 1, 0);
+  bool integer_costs = true;
+  double max_cost = 0;
+  uniform_cost_ = true;
   for (size_t o = 0; o < operator_ptr_.size(); ++o) {
-//    std::cout << "operator_ptr[" << o << "] = " << operator_ptr_[o]->name()
-//              << " -- cost = " << operator_ptr_[o]->cost(cost_idx_) << std::endl;
-    // For each atom i in the precondition of o
     FANCY_DIE_IF(operator_ptr_[o]->precondition().size() != 1, 171,
         "Action %s has a (disjuntive) precondition of size %d",
         operator_ptr_[o]->name(),
         operator_ptr_[o]->precondition().atom_list(0).size());
 
-    for (size_t i = 0;
-         i < operator_ptr_[o]->precondition().atom_list(0).size(); ++i)
-    {
-      ushort_t atom = operator_ptr_[o]->precondition().atom_list(0).atom(i);
-      has_prec_[atom].push_back(o);
+    op_prec_begin_.push_back(op_prec_.size());
+    atomList_t const& prec = operator_ptr_[o]->precondition().atom_list(0);
+    for (size_t i = 0; i < prec.size(); ++i) {
+      op_prec_.push_back(prec.atom(i));
+      ++has_prec_begin_[prec.atom(i) + 1];
     }
+
+    op_add_begin_.push_back(op_add_.size());
+    atomList_t const& adds = operator_ptr_[o]->effect().s_effect().add_list();
+    for (size_t i = 0; i < adds.size(); ++i)
+      op_add_.push_back(adds.atom(i));
+
+    double c = operator_ptr_[o]->cost(cost_idx_).double_value();
+    op_cost_.push_back(c);
+    integer_costs &= (c == std::floor(c));
+    max_cost = std::max(max_cost, c);
+    uniform_cost_ &= (c == op_cost_[0]);
   }
-  assert(relaxation_->goalT().size() == 1);
+  op_prec_begin_.push_back(op_prec_.size());
+  op_add_begin_.push_back(op_add_.size());
+
+  for (size_t i = 0; i < n_atoms; ++i)
+    has_prec_begin_[i+1] += has_prec_begin_[i];
+  has_prec_.resize(op_prec_.size());
+  std::vector<size_t> pos(has_prec_begin_.begin(), has_prec_begin_.end() - 1);
+  // Since o is increasing, each range of has_prec_ is sorted by cost too
+  for (size_t o = 0; o < operator_ptr_.size(); ++o) {
+    for (size_t j = op_prec_begin_[o]; j < op_prec_begin_[o+1]; ++j)
+      has_prec_[pos[op_prec_[j]]++] = o;
+  }
+
+  op_unsat_.resize(operator_ptr_.size());
+  op_prec_cost_.resize(operator_ptr_.size());
+  // Operators whose preconditions cost at least dead_end_value_ are not
+  // applied (see computeCostOfAtoms), so no key is larger than
+  // dead_end_value_ + max_cost
+  queue_.useBuckets(integer_costs &&
+                    dead_end_value_ + max_cost <= H_DET_MAX_BUCKETS);
 }
 
 
@@ -92,42 +135,124 @@ determinizationBasedAtomHeuristic::~determinizationBasedAtomHeuristic() {
     std::cout << "<hadd>: deleted" << std::endl;
 }
 
-void determinizationBasedAtomHeuristic::computeCostOfAtoms(state_t const& s,
-    deterministicAction_t const** supporter)
+/*******************************************************************************
+ *
+ * AtomCostQueue
+ *
+ ******************************************************************************/
+void determinizationBasedAtomHeuristic::AtomCostQueue::push(double key,
+                                                            int atom)
 {
+  ++size_;
+  if (use_buckets_) {
+    size_t b = static_cast<size_t>(key);
+    assert(b >= current_);
+    if (b >= buckets_.size())
+      buckets_.resize(b + 1);
+    buckets_[b].push_back(atom);
+  } else {
+    heap_.push(std::make_pair(key, atom));
+  }
+}
 
-  assert(!relaxation_->goalT().holds(s, relaxation_->nprec()));
 
-  // Offset. If negative atoms are represented, then positive atoms are the
-  // even values of i.
-  ushort_t inc = relaxation_->nprec() ? 1 : 2;
-  _D(DEBUG_H_DET, std::cout << "inc == " << inc << std::endl;)
+std::pair<double, int> determinizationBasedAtomHeuristic::AtomCostQueue::pop()
+{
+  assert(size_ > 0);
+  --size_;
+  if (use_buckets_) {
+    while (buckets_[current_].empty())
+      ++current_;
+    int atom = buckets_[current_].back();
+    buckets_[current_].pop_back();
+    return std::make_pair(static_cast<double>(current_), atom);
+  }
+  Entry top = heap_.top();
+  heap_.pop();
+  return top;
+}
+
 
-  // Position i: true if the cost of any atom in the precondition of
-  //             operator_ptr_[i] has decreased.
-  static std::vector<bool> aa(operator_ptr_.size(), false);
-
-  for (size_t i = 0; i < operator_ptr_.size(); i++) {
-    action_rp_cost[i] = std::numeric_limits<double>::max();
-    aa[i] = false;
-    if (operator_ptr_[i]->precondition().atom_list(0).size() == 0) {
-      // This operator has no precondition, so it is already applicable and
-      // needs to be considered
-      _D(DEBUG_H_DET, std::cout << "operator_ptr[" << i << "] = "
-                  << operator_ptr_[i]->name() << " has no precondition\n";)
-      aa[i] = true;
+void determinizationBasedAtomHeuristic::AtomCostQueue::clear() {
+  if (use_buckets_) {
+    for (size_t b = current_; b < buckets_.size() && size_ > 0; ++b) {
+      size_ -= buckets_[b].size();
+      buckets_[b].clear();
     }
+  } else {
+    heap_ = decltype(heap_)();
   }
+  current_ = 0;
+  size_ = 0;
+}
+
+
+
+void determinizationBasedAtomHeuristic::computeCostOfAtoms(state_t const& s,
+    deterministicAction_t const** supporter)
+{
+
+  assert(!relaxation_->goalT().holds(s, relaxation_->nprec()));
+  // Built by the ctor unless index_operators is false
+  assert(op_prec_begin_.size() == operator_ptr_.size() + 1);
 
   _D(DEBUG_H_DET, std::cout << "Computing " << name_ << "_"
       << gpt::problem->domain().functions().name(cost_idx_)
                             << "(s) for s = "
                             << s.toStringFull(relaxation_, true)
                             << std::endl;)
-  for (ushort_t i = 0; i < problem_t::number_atoms(); i += inc) {
-    if (supporter) {
-      supporter[i] = NULL;
+
+  /*
+   * Generalized Dijkstra (Knuth, 1977): atoms are popped in increasing order
+   * of cost and an operator is applied once all the atoms in its
+   * precondition were popped. At this point, its cost (sum or max of the
+   * costs of its precondition) is final. For h_max with uniform costs, the
+   * atoms are reached in order of cost by a breadth-first search, so a FIFO
+   * queue is used instead of queue_.
+   */
+  size_t n_ops = operator_ptr_.size();
+  bool bfs = (uniform_cost_ && aggregation_ == MAX_AGGREGATION);
+  queue_.clear();
+  fifo_.clear();
+  std::fill(atom_rp_cost, atom_rp_cost + problem_t::number_atoms(),
+            std::numeric_limits<double>::max());
+  if (supporter) {
+    std::fill(supporter, supporter + problem_t::number_atoms(), nullptr);
+  }
+  for (size_t o = 0; o < n_ops; ++o) {
+    action_rp_cost[o] = std::numeric_limits<double>::max();
+    op_unsat_[o] = op_prec_begin_[o+1] - op_prec_begin_[o];
+    op_prec_cost_[o] = 0.0;
+  }
+
+  // Applies operator_ptr_[o] whose precondition costs cost
+  auto apply = [&](size_t o, double cost) {
+    action_rp_cost[o] = std::min(cost, dead_end_value_);
+    if (cost >= dead_end_value_) {
+      // The atoms added by o would cost more than dead_end_value_
+      return;
+    }
+    double cost_after_exec_o = cost + op_cost_[o];
+    for (size_t j = op_add_begin_[o]; j < op_add_begin_[o+1]; ++j) {
+      ushort_t a = op_add_[j];
+      if (cost_after_exec_o < atom_rp_cost[a]) {
+        _D(DEBUG_H_DET, std::cout << "  Cost to make atom " << a
+                    << " true decreased to " << cost_after_exec_o << "\n";)
+        atom_rp_cost[a] = cost_after_exec_o;
+        if (supporter) {
+          supporter[a] = operator_ptr_[o];
+        }
+        if (bfs) fifo_.push_back(a);
+        else     queue_.push(cost_after_exec_o, a);
+      }
     }
+  };
+
+  // Offset. If negative atoms are represented, then positive atoms are the
+  // even values of i.
+  ushort_t inc = relaxation_->nprec() ? 1 : 2;
+  _D(DEBUG_H_DET, std::cout << "inc == " << inc << std::endl;)
+  for (ushort_t i = 0; i < problem_t::number_atoms(); i += inc) {
     // For some reason s.holds(i) is not returning true for the negation of
     // an atom. Probably it is related to the fact that the s is a state of
     // the original problem, not the relaxation.
@@ -137,132 +262,52 @@ void determinizationBasedAtomHeuristic::computeCostOfAtoms(state_t const& s,
     //  - !s.holds(i-1)
     // then
     //  - i-1 should hold in s.
-    if (s.holds(i) || (inc == 1 && i % 2 == 1 && !s.holds(i-1)))
-    {
+    if (s.holds(i) || (inc == 1 && i % 2 == 1 && !s.holds(i-1))) {
       atom_rp_cost[i] = 0.0;
-      _D(DEBUG_H_DET, std::cout << "  atom i=" << i
-                                << " holds in s, so atom_rp_cost[i] = 0\n";
-      )
-      for(std::list<size_t>::iterator it = has_prec_[i].begin();
-          it != has_prec_[i].end(); it++)
-      {
-        _D(DEBUG_H_DET, std::cout << "    make aa true for operator "
-                                   << *it << std::endl;)
-        aa[*it] = true;
-      }
+      if (bfs) fifo_.push_back(i);
+      else     queue_.push(0.0, i);
     }
-    else {
-      atom_rp_cost[i] = std::numeric_limits<double>::max();
+  }
+  // Operators without precondition are applicable in any state
+  for (size_t o = 0; o < n_ops; ++o) {
+    if (op_unsat_[o] == 0) {
+      apply(o, 0.0);
     }
   }
 
-  /*
-   * Computing atom_rp_cost and action_rp_cost for the given state
-   */
-  bool done = false;
-  while (!done) {
-    done = true;  // Assuming we already converged
-
-    for (size_t i = 0; i < operator_ptr_.size(); i++) {
-      if (aa[i]) {
-        _D(DEBUG_H_DET, std::cout << "Processing operator_ptr[" << i << "] = "
-                    << operator_ptr_[i]->name()
-                    << " (its aa was true)" << std::endl;)
-        aa[i] = false;  // i needed to be updated and we're doing it now
-        size_t j = 0;  // idx of a positive atom
-
-        // Searching for an atom in prec(i) that has infinity cost, i.e.,
-        // double::max
-        for (j=0; j < operator_ptr_[i]->precondition().atom_list(0).size(); j++)
-        {
-          if (atom_rp_cost[
-                    operator_ptr_[i]->precondition().atom_list(0).atom(j)]
-              == std::numeric_limits<double>::max())
-          {
-            _D(DEBUG_H_DET, std::cout << "  One of its preconditions still "
-                                      << "cost infinity, so giving up\n";)
-            break;
-          }
-        }
-
-        if (j == operator_ptr_[i]->precondition().atom_list(0).size())
-        // Every atom in the precondition of operator_ptr_[i] costs less than
-        // infinity (double::max), so we can derive a plan in which the the
-        // action is applicable
-        {
-          _D(DEBUG_H_DET, std::cout << "  Operator_ptr[" << i << "] = "
-                                    << operator_ptr_[i]->name()
-                                    << " is applicable!" << std::endl;
-            operator_ptr_[i]->print_full();
-            std::cout << std::endl;
-          )
-
-          const atomList_t& add_list =
-              operator_ptr_[i]->effect().s_effect().add_list();
-
-          // cost: combination cost of making the preconditions of action
-          //       operator_ptr_[i] true. Formally:
-          //    cost = COMBO_(k in prec[i]) cost_to_make_atom_true(k)
-          // where COMBO can be summation (for the additive h) or maximization
-          // (for maximal h)
-          double cost =
-              costSetOfAtoms(operator_ptr_[i]->precondition().atom_list(0));
-
-          if (e_less((cost), (action_rp_cost[i]))) {
-            done = false;  // The cost of action operator_ptr_[i] decreased
-                           // by more than epsilon, so we didn't converge.
-            _D(DEBUG_H_DET, std::cout << "  Cost to make action applicable "
-                        << "decreased by " << action_rp_cost[i] - cost
-                        << " to " << cost << std::endl;)
-            /* set new cost for applying action */
-            action_rp_cost[i] = cost;
-            /* cost of reaching each atom in the add list, i.e., cost of the
-             * preconditions of the current operator plus the cost of the
-             * operator itself */
-            double cost_after_exec_i = cost
-                            + operator_ptr_[i]->cost(cost_idx_).double_value();
-
-
-            // Updating, if necessary, the cost of the atoms added by
-            // operator_ptr_[i], the actions supporting the added atom and the
-            // actions that need to be updated (vector aa)
-            for (size_t k = 0; k < add_list.size(); k++) {
-              ushort_t a = add_list.atom(k);
-              if (e_less((cost_after_exec_i), (atom_rp_cost[a])))
-              // if atom_rp_cost[a] - (cost_after_exec_i) > epsilon
-              {
-                _D(DEBUG_H_DET, std::cout << "  Cost to make atom " << a
-                            << " true decreased by "
-                            << atom_rp_cost[a] - cost_after_exec_i
-                            << " to " << cost_after_exec_i << std::endl;)
-                atom_rp_cost[a] = cost_after_exec_i;
-                if (supporter) {
-                  supporter[a] = operator_ptr_[i];
-                }
-                for(std::list<size_t>::iterator it = has_prec_[a].begin();
-                    it != has_prec_[a].end(); it++) {
-                  aa[*it] = true;
-                }
-              }
-            }  // for each atom a in add list of operator_ptr_[i]
-          }  // if action_rp_cost[i] - cost > epsilon
-        }  // if every atom can be reached from cur_s with cost < double::max
-        else {
-          _D(DEBUG_H_DET, std::cout << "Operator_ptr[" << i << "] = "
-                      << operator_ptr_[i]->name()
-                      << " is NOT applicable :(" << std::endl;)
-        }
-      }  // if aa[i] == true
-      else {
-        _D(DEBUG_H_DET, std::cout << "Operator_ptr[" << i << "] = "
-                                  << operator_ptr_[i]->name()
-                                  << " has aa false :(" << std::endl;)
+  size_t head = 0;
+  while (bfs ? head < fifo_.size() : !queue_.empty()) {
+    ushort_t atom;
+    double cost;
+    if (bfs) {
+      atom = fifo_[head++];
+      cost = atom_rp_cost[atom];
+    } else {
+      std::pair<double, int> top = queue_.pop();
+      atom = top.second;
+      cost = top.first;
+      if (atom_rp_cost[atom] < cost) {
+        // Outdated entry: atom was pushed again with a smaller cost
+        continue;
+      }
+    }
+    for (size_t i = has_prec_begin_[atom]; i < has_prec_begin_[atom+1]; ++i) {
+      size_t o = has_prec_[i];
+      if (aggregation_ == SUM_AGGREGATION) {
+        op_prec_cost_[o] += cost;
+      } else {
+        // Atoms are popped in increasing order of cost, so the last
+        // precondition popped is the most expensive one
+        op_prec_cost_[o] = cost;
+      }
+      if (--op_unsat_[o] == 0) {
+        apply(o, op_prec_cost_[o]);
       }
-    }  // for each action o
-  }  // while !done
+    }
+  }
 
   /*
    * The vectors atom_rp_cost and action_rp_cost have already converged to
-   * their additive cost.
+   * their additive (or maximal) cost.
    */
 }
@@ -1,6 +1,10 @@
 #ifndef HEURISTICS_DETERMINIZATION_BASED_ATOM_ABC_H
 #define HEURISTICS_DETERMINIZATION_BASED_ATOM_ABC_H
 
+#include <queue>
+#include <utility>
+#include <vector>
+
 #include "heuristic_iface.h"
 
 #include "../ext/mgpt/global.h"
@@ -42,9 +46,19 @@ class ActionCostIncreasing {
 class determinizationBasedAtomHeuristic : public FactoredHeuristic
 {
  public:
+  // How the cost of a set of atoms is obtained from the cost of each atom
+  // (see costSetOfAtoms). computeCostOfAtoms relies on it to decide when the
+  // cost of an operator is known.
+  enum CostAggregation {SUM_AGGREGATION = 0, MAX_AGGREGATION};
+
+  // If index_operators is false, then the CSR representation of the operators
+  // is not built and computeCostOfAtoms must not be called (e.g., LM-cut has
+  // its own representation)
   determinizationBasedAtomHeuristic(problem_t const& problem,
       size_t cost_idx = ACTION_COST,
-      bool use_self_loop_relaxation = false);
+      bool use_self_loop_relaxation = false,
+      CostAggregation aggregation = SUM_AGGREGATION,
+      bool index_operators = true);
   virtual ~determinizationBasedAtomHeuristic();
 
   // heuristic_t interface
@@ -52,20 +66,53 @@ class determinizationBasedAtomHeuristic : public FactoredHeuristic
   // heuristic_t interface
 
  protected:
+  /*
+   * Min-priority queue of (cost, atom) used by the generalized Dijkstra of
+   * computeCostOfAtoms and by LMCutHeuristic. If all the costs are integers,
+   * then a bucket queue is used; otherwise, a binary heap. In both cases, the
+   * keys pushed after a pop must not be smaller than the popped key (true for
+   * Dijkstra with non-negative costs).
+   */
+  class AtomCostQueue {
+   public:
+    AtomCostQueue() : use_buckets_(false), current_(0), size_(0) { }
+    void useBuckets(bool b) { use_buckets_ = b; }
+    bool empty() const { return size_ == 0; }
+    void push(double key, int atom);
+    std::pair<double, int> pop();
+    void clear();
+   private:
+    typedef std::pair<double, int> Entry;
+    bool use_buckets_;
+    std::vector<std::vector<int>> buckets_;
+    size_t current_;
+    std::priority_queue<Entry, std::vector<Entry>, std::greater<Entry>> heap_;
+    size_t size_;
+  };
+
   // * Compute the cost of the set of atoms using atom_rp_cost. If this
   //   function returns the:
   //   - sum of all costs, then H_add is obtained
-  //   - max of all costs, then H_add is obtained
+  //   - max of all costs, then H_max is obtained
+  //   It must agree with the aggregation given to the ctor.
   virtual double costSetOfAtoms(atomList_t const& atoms) const = 0;
 
-  // * Compute the cost of each atom from state s using the h_add definition.
-  // * The values are stored in atom_rp_cost and action_rp_cost
-  // * If supporter != NULL, then supporter[i] is the index of operator_ptr_ of
-  //   the action that minimizes the h_add cost to add atom(i).
+  // * Compute the cost of each atom from state s using the aggregation given
+  //   to the ctor (sum for h_add, max for h_max).
+  // * The values are stored in atom_rp_cost and action_rp_cost. Atoms that
+  //   can only be reached through operators whose preconditions cost at least
+  //   dead_end_value_ are left with cost double::max, since any set of atoms
+  //   containing them costs dead_end_value_ anyway.
+  // * If supporter != NULL, then supporter[i] is the action of operator_ptr_
+  //   that minimizes the cost to add atom(i) (NULL if atom(i) holds in s or is
+  //   not reachable).
   // * It is expected that |supporter| >= problem_t::number_atoms()
   void computeCostOfAtoms(state_t const& s,
                           deterministicAction_t const** supporter = NULL);
 
+  // Builds the CSR representation of operator_ptr_ (see below)
+  void indexOperators();
+
   // heuristic_t interface
   virtual double value(state_t const& s) = 0;
 
@@ -85,11 +132,37 @@ class determinizationBasedAtomHeuristic : public FactoredHeuristic
   // the ctor, it will also be sorted according to the cost of the action,
   // from lower costs to higher costs
   std::vector<deterministicAction_t const*> operator_ptr_;
-  // has_prec_[i] is the list of indexes of operator_ptr_ such that, for all
-  // j \in has_prec_[i], atom(i) \in precondition(operator_ptr_[j])
-  // Since operator_ptr_ is sorted according to the actions costs:
-  //        cost(has_prec_[i][j]) <= cost(has_prec_[i][j+1])
-  std::vector<std::list<size_t>> has_prec_;
+  // CSR representation of operator_ptr_:
+  //  - op_prec_[op_prec_begin_[o], op_prec_begin_[o+1]) are the atoms in the
+  //    precondition of operator_ptr_[o]
+  //  - op_add_[op_add_begin_[o], op_add_begin_[o+1]) are the atoms added by
+  //    operator_ptr_[o]
+  //  - has_prec_[has_prec_begin_[i], has_prec_begin_[i+1]) are the indexes of
+  //    operator_ptr_ that have atom(i) in their preconditions. Since
+  //    operator_ptr_ is sorted according to the actions costs, so is each of
+  //    these ranges
+  std::vector<size_t> op_prec_begin_;
+  std::vector<ushort_t> op_prec_;
+  std::vector<size_t> op_add_begin_;
+  std::vector<ushort_t> op_add_;
+  std::vector<size_t> has_prec_begin_;
+  std::vector<size_t> has_prec_;
+  // op_cost_[o] is the cost of operator_ptr_[o]
+  std::vector<double> op_cost_;
+  CostAggregation aggregation_;
+  // True if all the operators have the same cost. In this case, h_max is
+  // computed by a breadth-first search instead of using queue_
+  bool uniform_cost_;
+
+  // Per call data of computeCostOfAtoms, allocated once. Kept per instance,
+  // so different instances can be used concurrently.
+  // Number of atoms in the precondition of each operator not popped yet
+  std::vector<size_t> op_unsat_;
+  // Sum (or max) of the costs of the atoms in the precondition of each
+  // operator popped so far
+  std::vector<double> op_prec_cost_;
+  AtomCostQueue queue_;
+  std::vector<ushort_t> fifo_;
 
   // Size: # of atoms
   // Position i: the cost of making atom(i) true in the current state
@@ -120,7 +193,8 @@ class HDetAtomTemplate : public determinizationBasedAtomHeuristic {
 
  public:
   HDetAtomTemplate(problem_t const& problem, size_t cost_idx = ACTION_COST)
-    : determinizationBasedAtomHeuristic(problem, cost_idx, use_self_loop_relax)
+    : determinizationBasedAtomHeuristic(problem, cost_idx, use_self_loop_relax,
+                                        AggregationFunctor::aggregation)
   {
     name_ = std::string(nameArg);
   }
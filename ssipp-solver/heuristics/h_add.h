@@ -11,6 +11,9 @@
  * Aggregation functor for h-add
  */
 struct SumCostSetOfAtoms {
+  static constexpr determinizationBasedAtomHeuristic::CostAggregation
+    aggregation = determinizationBasedAtomHeuristic::SUM_AGGREGATION;
+
   double operator()(atomList_t const& atoms, double* const& atom_rp_cost) const {
     double cost = 0;
     for (size_t i = 0; i < atoms.size(); ++i) {
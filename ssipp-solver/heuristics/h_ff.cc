@@ -0,0 +1,67 @@
+#include <algorithm>
+
+#include "h_ff.h"
+
+
+HFFAllOutcomesDet::HFFAllOutcomesDet(problem_t const& problem,
+                                     size_t cost_idx)
+  : determinizationBasedAtomHeuristic(problem, cost_idx, false),
+    supporter_(problem_t::number_atoms(), nullptr),
+    marked_atom_(problem_t::number_atoms(), false)
+{
+  name_ = std::string("h-ff-all-out-det");
+}
+
+
+double HFFAllOutcomesDet::costSetOfAtoms(atomList_t const& atoms) const {
+  double cost = aggregationFunctor_(atoms, atom_rp_cost);
+  return std::min(cost, dead_end_value_);
+}
+
+
+double HFFAllOutcomesDet::value(state_t const& s) {
+  if (relaxation_->goalT().holds(s, relaxation_->nprec())) {
+    return 0.0;
+  }
+  computeCostOfAtoms(s, supporter_.data());
+  atomList_t const& goal = relaxation_->goalT().atom_list(0);
+  double h_add = costSetOfAtoms(goal);
+  if (h_add >= dead_end_value_) {
+    // At least one goal atom is unreachable
+    return dead_end_value_;
+  }
+
+  /*
+   * Extracting the relaxed plan by backchaining the supporters of the goal
+   * atoms
+   */
+  std::fill(marked_atom_.begin(), marked_atom_.end(), false);
+  relaxed_plan_.clear();
+  open_atoms_.clear();
+  for (size_t i = 0; i < goal.size(); ++i)
+    open_atoms_.push_back(goal.atom(i));
+
+  while (!open_atoms_.empty()) {
+    ushort_t a = open_atoms_.back();
+    open_atoms_.pop_back();
+    if (marked_atom_[a])
+      continue;
+    marked_atom_[a] = true;
+    deterministicAction_t const* op = supporter_[a];
+    if (!op)
+      continue;  // a holds in s
+    relaxed_plan_.push_back(op);
+    atomList_t const& prec = op->precondition().atom_list(0);
+    for (size_t i = 0; i < prec.size(); ++i)
+      open_atoms_.push_back(prec.atom(i));
+  }
+
+  // The same operator can support more than one atom
+  std::sort(relaxed_plan_.begin(), relaxed_plan_.end());
+  relaxed_plan_.erase(std::unique(relaxed_plan_.begin(), relaxed_plan_.end()),
+                      relaxed_plan_.end());
+  double cost = 0;
+  for (deterministicAction_t const* op : relaxed_plan_)
+    cost += op->cost(cost_idx_).double_value();
+  return std::min(cost, dead_end_value_);
+}
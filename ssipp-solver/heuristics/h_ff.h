@@ -0,0 +1,44 @@
+#ifndef HEURISTICS_H_FF
+#define HEURISTICS_H_FF
+
+#include <vector>
+
+#include "determinization_based_atom_abc.h"
+#include "h_add.h"
+
+#include "../ext/mgpt/states.h"
+#include "../ext/mgpt/problems.h"
+
+
+/*
+ * HFFAllOutcomesDet
+ *
+ * FF heuristic on the all-outcomes determinization: the h_add costs of the
+ * atoms are computed together with their best supporters and the relaxed plan
+ * is obtained by backchaining from the goal atoms. The value is the cost of the
+ * relaxed plan, i.e., the sum of the costs of its (unique) operators.
+ */
+class HFFAllOutcomesDet : public determinizationBasedAtomHeuristic {
+ public:
+  HFFAllOutcomesDet(problem_t const& problem, size_t cost_idx = ACTION_COST);
+  ~HFFAllOutcomesDet() { }
+
+  double computeValue(state_t const& s) override { return value(s); }
+
+ private:
+  double costSetOfAtoms(atomList_t const& atoms) const override;
+
+  double value(state_t const& s) override;
+
+  SumCostSetOfAtoms aggregationFunctor_;
+
+  // supporter_[i] is the operator that minimizes the h_add cost of atom(i) or
+  // NULL if atom(i) holds in the state being evaluated
+  std::vector<deterministicAction_t const*> supporter_;
+  // Reused across calls to avoid allocations
+  std::vector<bool> marked_atom_;
+  std::vector<deterministicAction_t const*> relaxed_plan_;
+  std::vector<ushort_t> open_atoms_;
+};
+
+#endif // HEURISTICS_H_FF
@@ -0,0 +1,117 @@
+#ifndef HEURISTICS_HEURISTIC_CACHE_H
+#define HEURISTICS_HEURISTIC_CACHE_H
+
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <iostream>
+#include <memory>
+
+#include "../ext/mgpt/states.h"
+
+
+/*******************************************************************************
+ *
+ * HeuristicCache
+ *
+ * Bounded memoisation of heuristic values used by heuristic_t::value. It is a
+ * direct-mapped table indexed by state_t::hash64: each slot stores the 64-bit
+ * hash of the state (used as its fingerprint) and its value, and a new entry
+ * simply overwrites the slot. Since heuristic_t outlives the short-sighted
+ * SSPs and the rounds, the values of states evaluated by a previous
+ * subproblem (e.g., the fringe of the previous envelope) are reused.
+ *
+ * The table is lock-free: each slot is protected by a sequence counter
+ * (seqlock), so readers never block and a reader that overlaps a writer sees
+ * a miss instead of a torn entry; a writer that finds the slot being written
+ * by another thread skips the insertion. Two different states are only
+ * confused if their 64-bit hashes are equal.
+ *
+ ******************************************************************************/
+class HeuristicCache {
+ public:
+  // The number of slots is max_entries rounded up to a power of 2
+  explicit HeuristicCache(size_t max_entries) : hits_(0), misses_(0) {
+    size_t n = 1;
+    while (n < max_entries)
+      n <<= 1;
+    mask_ = n - 1;
+    slots_.reset(new Slot[n]);
+  }
+
+  size_t capacity() const { return mask_ + 1; }
+  uint64_t hits() const { return hits_.load(std::memory_order_relaxed); }
+  uint64_t misses() const { return misses_.load(std::memory_order_relaxed); }
+
+  // Returns true and sets value if s is in the cache
+  bool lookup(state_t const& s, double& value) {
+    uint64_t key = fingerprint(s);
+    Slot& slot = slots_[key & mask_];
+    uint32_t seq = slot.seq.load(std::memory_order_acquire);
+    if ((seq & 1) == 0 && slot.key.load(std::memory_order_relaxed) == key) {
+      uint64_t bits = slot.value.load(std::memory_order_relaxed);
+      std::atomic_thread_fence(std::memory_order_acquire);
+      if (slot.seq.load(std::memory_order_relaxed) == seq) {
+        memcpy(&value, &bits, sizeof(double));
+        hits_.fetch_add(1, std::memory_order_relaxed);
+        return true;
+      }
+    }
+    misses_.fetch_add(1, std::memory_order_relaxed);
+    return false;
+  }
+
+  void insert(state_t const& s, double value) {
+    uint64_t key = fingerprint(s);
+    Slot& slot = slots_[key & mask_];
+    uint32_t seq = slot.seq.load(std::memory_order_relaxed);
+    if ((seq & 1) ||
+        !slot.seq.compare_exchange_strong(seq, seq + 1,
+                                          std::memory_order_acquire))
+    {
+      return;  // another thread is writing this slot
+    }
+    // Readers that see the new key or value must also see the odd counter
+    std::atomic_thread_fence(std::memory_order_release);
+    uint64_t bits;
+    memcpy(&bits, &value, sizeof(double));
+    slot.key.store(key, std::memory_order_relaxed);
+    slot.value.store(bits, std::memory_order_relaxed);
+    slot.seq.store(seq + 2, std::memory_order_release);
+  }
+
+  void clear() {
+    for (size_t i = 0; i <= mask_; ++i)
+      slots_[i].key.store(EMPTY, std::memory_order_relaxed);
+  }
+
+  void statistics(std::ostream& os, std::string const& name) const {
+    uint64_t total = hits() + misses();
+    os << "[" << name << " heuristic]: cache hits = " << hits()
+       << ", misses = " << misses() << " (hit rate = "
+       << (total ? hits() / (double) total : 0.0) << ", "
+       << capacity() << " entries)" << std::endl;
+  }
+
+ private:
+  static uint64_t const EMPTY = 0;
+
+  struct Slot {
+    Slot() : seq(0), key(EMPTY), value(0) { }
+    std::atomic<uint32_t> seq;
+    std::atomic<uint64_t> key;
+    std::atomic<uint64_t> value;
+  };
+
+  static uint64_t fingerprint(state_t const& s) {
+    uint64_t h = s.hash64();
+    return (h == EMPTY ? 1 : h);
+  }
+
+  std::unique_ptr<Slot[]> slots_;
+  size_t mask_;
+  std::atomic<uint64_t> hits_;
+  std::atomic<uint64_t> misses_;
+};
+
+#endif  // HEURISTICS_HEURISTIC_CACHE_H
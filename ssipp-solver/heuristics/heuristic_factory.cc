@@ -6,6 +6,7 @@
 #include "heuristic_factory.h"
 #include "constant_value.h"
 #include "h_add.h"
+#include "h_ff.h"
 #include "h_max.h"
 #include "lm_cut.h"
 
@@ -51,6 +52,9 @@ std::shared_ptr<heuristic_t> createHeuristic(SSPIface const& ssp,
       else if (!strcasecmp(ptr, "h-add")) {
         heur = std::make_shared<HAddAllOutcomesDet>(problem, ACTION_COST);
       }
+      else if (!strcasecmp(ptr, "h-ff")) {
+        heur = std::make_shared<HFFAllOutcomesDet>(problem, ACTION_COST);
+      }
       else if (!strcasecmp(ptr, "h-max")) {
         heur = std::make_shared<HMaxAllOutcomesDet>(problem, ACTION_COST);
       }
@@ -58,6 +62,9 @@ std::shared_ptr<heuristic_t> createHeuristic(SSPIface const& ssp,
         std::cerr << "ERROR! undefined heuristic `" << ptr << "'" << std::endl;
         exit(-1);
       }
+      // Factored heuristics are expensive enough to be worth memoising (the
+      // zero heuristics above are not)
+      heur->enableCache(gpt::heuristic_cache_size);
     }  // case in which the heuristic is a FactoredHeuristic
     ptr = strtok_r(NULL, "| ", &lptr);
   }
@@ -1,9 +1,13 @@
 #ifndef HEURISTICS_IFACE_H
 #define HEURISTICS_IFACE_H
 
+#include <cstdio>
 #include <iostream>
+#include <memory>
 #include <stack>
 
+#include "heuristic_cache.h"
+
 #include "../ext/mgpt/states.h"
 #include "../utils/die.h"
 #include "../ext/mgpt/problems.h"
@@ -31,18 +35,20 @@ class heuristic_t {
   { }
 
   virtual ~heuristic_t() {
-    std::cout << "[" << name_ << " heuristic]: total calls = "
-              << total_calls_ << std::endl
-              << "[" << name_ << " heuristic]: 95CI cputime (in secs) = ";
-    printf("%0.7f -+ %0.7f\n", mean_cputime_,
-            (1.96 * sqrt(m2_cputime_ / (total_calls_ * (total_calls_-1)))));
+    statistics(std::cout);
   }
 
   /*
    * Non-virtual wrapper to computeValue. This wrapper allow us to compute
-   * on-the-fly stats about the heuristic and help debugging it.
+   * on-the-fly stats about the heuristic and help debugging it. If the cache
+   * is enabled (see enableCache), then computeValue is only called for the
+   * states not in it.
    */
   double value(state_t const& s) {
+    double cached_val;
+    if (cache_ && cache_->lookup(s, cached_val)) {
+      return cached_val;
+    }
     START_TIMING("heuristic_value");
     uint64_t before = get_cputime_usec();
     double val = computeValue(s);
@@ -54,11 +60,42 @@ class heuristic_t {
     STOP_TIMING("heuristic_value");
     _D(DEBUG_HEUR, std::cout << "H(" << s.toStringFull(gpt::problem, true)
                             << ") = " << val << std::endl)
+    if (cache_) {
+      cache_->insert(s, val);
+    }
     return val;
   }
 
   std::string name() const { return name_; }
 
+  /*
+   * Memoises up to (approximately) max_entries values computed by value.
+   * Only valid if computeValue is a function of the state alone. Use 0 to
+   * disable the cache.
+   */
+  void enableCache(size_t max_entries) {
+    if (max_entries > 0)
+      cache_.reset(new HeuristicCache(max_entries));
+    else
+      cache_.reset();
+  }
+  HeuristicCache const* cache() const { return cache_.get(); }
+
+  // Prints the number of calls to computeValue, its cputime and, if the
+  // cache is enabled, its hits and misses
+  void statistics(std::ostream& os) const {
+    os << "[" << name_ << " heuristic]: total calls = "
+       << total_calls_ << std::endl;
+    char ci[64];
+    snprintf(ci, sizeof(ci), "%0.7f -+ %0.7f", mean_cputime_,
+             (1.96 * sqrt(m2_cputime_ / (total_calls_ * (total_calls_-1)))));
+    os << "[" << name_ << " heuristic]: 95CI cputime (in secs) = " << ci
+       << std::endl;
+    if (cache_) {
+      cache_->statistics(os, name_);
+    }
+  }
+
  protected:
   /*
    * Heuristic main method
@@ -77,6 +114,7 @@ class heuristic_t {
   size_t total_calls_;
   double mean_cputime_;
   double m2_cputime_;
+  std::unique_ptr<HeuristicCache> cache_;
 };
 
 
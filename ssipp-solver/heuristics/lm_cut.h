@@ -2,7 +2,7 @@
 #define HEURISTIC_LMCUT_H
 
 #include <iostream>
-#include <bitset>
+#include <queue>
 #include <vector>
 #include <algorithm>  // std::min
 
@@ -12,23 +12,70 @@
 #include "../ext/mgpt/states.h"
 #include "../ext/mgpt/problems.h"
 
-using CutList = std::vector<std::set<const action_t*>>;
-
-#define BOOST_DYNAMIC_BITSET_DONT_USE_FRIENDS
-#include <boost/dynamic_bitset.hpp>
-#include <boost/functional/hash.hpp>
-using DynBitSet = boost::dynamic_bitset<>;
-namespace std {
-  template<> struct hash<DynBitSet> {
-    size_t operator()(DynBitSet const& bs) const {
-      size_t rv = 0;
-      boost::hash_combine(rv, bs.m_num_bits);
-      boost::hash_combine(rv, bs.m_bits);
-      return rv;
-    }
+
+/*
+ * List of cuts (disjunctive action landmarks) stored in a single flat vector:
+ * cut i is actions_[offsets_[i], offsets_[i+1]). Each cut is a sorted range of
+ * distinct actions of the original problem and can be iterated as a container,
+ * i.e.:
+ *    for (auto const& cut : cut_list)
+ *      for (action_t const* a : cut)
+ *        ...
+ */
+class CutList {
+ public:
+  class Cut {
+   public:
+    Cut(action_t const* const* b, action_t const* const* e)
+      : begin_(b), end_(e) { }
+    action_t const* const* begin() const { return begin_; }
+    action_t const* const* end() const { return end_; }
+    size_t size() const { return end_ - begin_; }
+    bool empty() const { return begin_ == end_; }
+   private:
+    action_t const* const* begin_;
+    action_t const* const* end_;
+  };
+
+  class const_iterator {
+   public:
+    const_iterator(CutList const* l, size_t i) : list_(l), i_(i) { }
+    Cut operator*() const { return (*list_)[i_]; }
+    const_iterator& operator++() { ++i_; return *this; }
+    bool operator==(const_iterator const& rhs) const { return i_ == rhs.i_; }
+    bool operator!=(const_iterator const& rhs) const { return i_ != rhs.i_; }
+   private:
+    CutList const* list_;
+    size_t i_;
   };
+
+  CutList() : offsets_(1, 0) { }
+
+  size_t size() const { return offsets_.size() - 1; }
+  bool empty() const { return size() == 0; }
+  Cut operator[](size_t i) const {
+    return Cut(actions_.data() + offsets_[i], actions_.data() + offsets_[i+1]);
+  }
+  const_iterator begin() const { return const_iterator(this, 0); }
+  const_iterator end() const { return const_iterator(this, size()); }
+
+  // Adds a new cut with the actions in [first, last); duplicates are removed
+  template<typename Ite>
+  void addCut(Ite first, Ite last) {
+    size_t b = actions_.size();
+    actions_.insert(actions_.end(), first, last);
+    std::sort(actions_.begin() + b, actions_.end());
+    actions_.erase(std::unique(actions_.begin() + b, actions_.end()),
+                   actions_.end());
+    offsets_.push_back(actions_.size());
+  }
+
+ private:
+  std::vector<action_t const*> actions_;
+  std::vector<size_t> offsets_;
 };
 
+
 struct CutResult {
   double value;
   CutList cuts;
@@ -38,8 +85,15 @@ struct CutResult {
  *
  * LM-Cut Heuristic
  *
- * Adapted from Patrik's HSP (http://users.cecs.anu.edu.au/~patrik/un-hsps.html)
- * specifically CostTable::compute_lmcut
+ * Originally adapted from Patrik's HSP
+ * (http://users.cecs.anu.edu.au/~patrik/un-hsps.html) specifically
+ * CostTable::compute_lmcut. The current implementation follows Fast Downward's
+ * LandmarkCutLandmarks: the strong relaxation is represented by flat arrays of
+ * unary-indexed relaxed operators, h_max is computed with a generalized
+ * Dijkstra over a priority queue (a bucket queue if all costs are integers)
+ * and, after each cut, h_max is updated incrementally starting from the
+ * effects of the operators in the cut instead of being recomputed from
+ * scratch.
  *
  ******************************************************************************/
 class LMCutHeuristic : public determinizationBasedAtomHeuristic {
@@ -56,7 +110,7 @@ class LMCutHeuristic : public determinizationBasedAtomHeuristic {
     if (relaxation_->goalT().holds(s, relaxation_->nprec())) {
       return CutResult {value: 0.0, cuts: CutList {}};
     }
-    return computeLMCut(s, relaxation_->goalT().atom_list(0), true);
+    return computeLMCut(s, true);
   }
 
  protected:
@@ -69,11 +123,7 @@ class LMCutHeuristic : public determinizationBasedAtomHeuristic {
       // This is a goal state in the relaxation, so returning 0
       return 0.0;
     }
-    double v = computeLMCut(s, relaxation_->goalT().atom_list(0)).value;
-    // std::cout << "Hlmcut_{" << gpt::problem->domain().functions().name(cost_idx_)
-    //           << "}(" << s.toStringFull(gpt::problem) << ") = " << v
-    //           << std::endl;
-    return v;
+    return computeLMCut(s).value;
   }
 
 
@@ -85,40 +135,68 @@ class LMCutHeuristic : public determinizationBasedAtomHeuristic {
   }
 
  private:
+  enum AtomStatus : unsigned char {
+    UNREACHED = 0,
+    REACHED,
+    GOAL_ZONE,
+    BEFORE_GOAL_ZONE
+  };
 
   /*
-   * Computes the LMCut heuristic from s to make all atoms in target_atoms true
+   * Computes the LMCut heuristic from s to the goal of the relaxation
    */
-  CutResult computeLMCut(state_t const& s, atomList_t const& target_atoms, bool save_cut = false);
-
-  void extendedGoals(atomList_t const& target_atoms,
-                           std::vector<double> const& action_cost,
-                           DynBitSet& rv) const
-  {
-    extendedGoalsRec(target_atoms, action_cost, rv);
-  }
-
-  void extendedGoalsRec(atomList_t const& target_atoms,
-                        std::vector<double> const& action_cost,
-                        DynBitSet& ext_goal_set) const;
-
-  DynBitSet findCut(DynBitSet const& ext_goal_set,
-                            std::vector<double> const& action_cost) const;
-
-  // If allowed_actions is nullptr, then all actions are considered
-  void computeCostOfAtomsForConstrainedActionSet(
-                              state_t const& s,
-                              std::vector<double> const& action_cost,
-                              DynBitSet const* allowed_actions = nullptr);
+  CutResult computeLMCut(state_t const& s, bool save_cut = false);
+
+  void enqueueIfNecessary(int atom, double cost);
+  // h_max from scratch
+  void firstExploration(state_t const& s);
+  // h_max updated after the costs of the operators in cut_ were decreased
+  void firstExplorationIncremental();
+  // Marks as GOAL_ZONE the atoms that reach the artificial goal with 0 cost
+  void markGoalPlateau();
+  // Finds the operators from the atoms before the goal zone to atoms in the
+  // goal zone and stores them in cut_
+  void secondExploration();
+  void updateHMaxSupporter(size_t op);
 
   /*
    * Members
    */
-  // Vectors for caching the preconditions and add effects of actions as bitset.
-  // This is useful because speed up intersection operations.
-  int n_actions, n_atoms;
-  std::vector<DynBitSet> prec_op_vbits_;
-  std::vector<DynBitSet> adds_op_vbits_;
+  int n_ops_, n_atoms_;
+  // Artificial atoms: the goal, that is added by the artificial operator
+  // whose precondition is the original goal, and an atom that holds in every
+  // state and is the precondition of operators without precondition
+  int artificial_goal_, artificial_prec_;
+
+  // CSR representation of the relaxed operators, rop for short
+  // (operator_ptr_ plus the artificial goal operator as the last one). The
+  // CSR representation of determinizationBasedAtomHeuristic is not built,
+  // since computeCostOfAtoms is never called by LM-cut
+  std::vector<size_t> rop_prec_begin_;
+  std::vector<int> rop_prec_;
+  std::vector<size_t> rop_eff_begin_;
+  std::vector<int> rop_eff_;
+  std::vector<double> rop_base_cost_;
+  // CSR representation of the operators that have the atom as precondition
+  // and the operators that add the atom
+  std::vector<size_t> prec_of_begin_;
+  std::vector<int> prec_of_;
+  std::vector<size_t> eff_of_begin_;
+  std::vector<int> eff_of_;
+
+  // Per call data, allocated once
+  std::vector<double> rop_cost_;
+  std::vector<int> rop_unsat_;
+  std::vector<int> rop_supporter_;
+  std::vector<double> rop_supporter_cost_;
+  std::vector<double> atom_cost_;
+  std::vector<AtomStatus> atom_status_;
+  std::vector<int> init_atoms_;
+  std::vector<int> cut_;
+  std::vector<int> stack_;
+  std::vector<action_t const*> cut_actions_;
+  AtomCostQueue hmax_queue_;
+
   MaxCostSetOfAtoms maxCost;
 };
 
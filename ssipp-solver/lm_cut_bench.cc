@@ -0,0 +1,111 @@
+/* Microbenchmark for the LM-cut heuristic: samples states by random walks from
+the initial state of the given problem and times LMCutHeuristic::valueAndCuts
+(the call used by ASNets to build its features) on them. The checksum line
+(sum of values and number of cuts) can be used to check that two versions of
+the heuristic agree. See bench_lm_cut.py to compare two git revisions. */
+
+#include <iostream>
+#include <fstream>
+#include <vector>
+
+#include "ext/mgpt/actions.h"
+#include "ext/mgpt/domains.h"
+#include "ext/mgpt/global.h"
+#include "ext/mgpt/problems.h"
+#include "ext/mgpt/states.h"
+
+#include "heuristics/lm_cut.h"
+
+#include "ssps/ppddl_adaptors.h"
+#include "ssps/prob_dist_state.h"
+
+#include "utils/exceptions.h"
+#include "utils/utils.h"
+
+
+int main(int argc, char** argv) {
+  char USAGE[] = "USAGE: lm_cut_bench pddl_file [pddl_file ...] problem "
+                 "n_states walk_length repetitions\n";
+  if (argc < 6) {
+    std::cout << USAGE;
+    return -1;
+  }
+  for (int i = 1; i <= argc - 5; i++) {
+    if (!readPDDLFile(argv[i])) {
+      std::cout << "couldn't read parse the file '" << argv[i] << "'"
+                << std::endl;
+      return -1;
+    }
+  }
+  char *problem_name = argv[argc-4];
+  size_t n_states = atoi(argv[argc-3]);
+  size_t walk_length = atoi(argv[argc-2]);
+  size_t repetitions = atoi(argv[argc-1]);
+
+  problem_t *problem = (problem_t*)problem_t::find(problem_name);
+  if (!problem) {
+    std::cout << "Couldn't load problem '" << problem_name << "'" << std::endl;
+    return -1;
+  }
+  gpt::problem = problem;
+  srand48(gpt::seed);
+
+  try {
+    problem->instantiate_actions();
+    problem->flatten();
+    state_t::initialize(*problem);
+  } catch (std::exception& e) {
+    std::cout << e.what() << std::endl;
+    return -1;
+  }
+
+  SSPfromPPDDL ssp(*problem);
+  LMCutHeuristic lm_cut(*problem);
+  problem->no_more_atoms();
+
+  /*
+   * Sampling states by random walks from s0. Walks are restarted from s0
+   * when they reach a goal or a state without applicable actions.
+   */
+  std::vector<state_t> states;
+  ProbDistStateVector successors;
+  state_t s = ssp.s0();
+  size_t steps = 0;
+  while (states.size() < n_states) {
+    states.push_back(s);
+    std::vector<action_t const*> actions;
+    for (auto const& a : ssp.applicableActions(s))
+      actions.push_back(&a);
+    if (actions.empty() || ++steps >= walk_length) {
+      s = ssp.s0();
+      steps = 0;
+      continue;
+    }
+    action_t const* a = actions[lrand48() % actions.size()];
+    ssp.expand(*a, s, successors);
+    s = successors.sample();
+  }
+
+  double value_sum = 0;
+  size_t n_cuts = 0;
+  uint64_t before = get_cputime_usec();
+  for (size_t r = 0; r < repetitions; ++r) {
+    for (state_t const& st : states) {
+      CutResult res = lm_cut.valueAndCuts(st);
+      value_sum += res.value;
+      n_cuts += res.cuts.size();
+    }
+  }
+  uint64_t elapsed = get_cputime_usec() - before;
+
+  size_t calls = states.size() * repetitions;
+  std::cout << "[lm_cut_bench] problem: " << problem->name() << std::endl
+            << "[lm_cut_bench] calls: " << calls << std::endl
+            << "[lm_cut_bench] total cputime (in secs): "
+            << elapsed / 1000000.0 << std::endl
+            << "[lm_cut_bench] cputime per call (in usecs): "
+            << (calls ? elapsed / (double) calls : 0.0) << std::endl
+            << "[lm_cut_bench] checksum: value_sum = " << value_sum
+            << " n_cuts = " << n_cuts << std::endl;
+  return 0;
+}
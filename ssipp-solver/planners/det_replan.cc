@@ -0,0 +1,37 @@
+#include "det_replan.h"
+
+#include "../ext/mgpt/global.h"
+#include "../ext/mgpt/states.h"
+
+
+PlannerDetReplan::PlannerDetReplan(SSPIface const& ssp,
+    std::string const& det_planner)
+  : Planner(), ssp_(ssp),
+    det_planner_(ExternalDetPlannerInterface::createInterface(*gpt::problem,
+        0, ALL_OUTCOMES, det_planner)),
+    replans_(0), dead_ends_(0)
+{ }
+
+
+action_t const* PlannerDetReplan::decideAction(state_t const& s) {
+  if (!policy_.isDefinedFor(s)) {
+    replans_++;
+    if (det_planner_->partialPolicyFrom(s, policy_) != SUCCESS) {
+      dead_ends_++;
+      return randomAction(ssp_, s);
+    }
+  }
+  return policy_.action(s);
+}
+
+
+void PlannerDetReplan::statistics(std::ostream &os, int level) const {
+  if (level > 0) {
+    os << "[replan]: replans = " << replans_ << std::endl;
+    os << "[replan]: plan cache hits = " << det_planner_->planCacheHits()
+       << std::endl;
+    os << "[replan]: plan cache repairs = "
+       << det_planner_->planCacheRepairs() << std::endl;
+    os << "[replan]: dead ends = " << dead_ends_ << std::endl;
+  }
+}
@@ -0,0 +1,60 @@
+#ifndef PLANNER_DET_REPLAN_H
+#define PLANNER_DET_REPLAN_H
+
+#include <iostream>
+#include <memory>
+#include <string>
+
+#include "planner_iface.h"
+
+#include "../ext/det_planners/externalDetPlannerInterface.h"
+#include "../ssps/policy.h"
+#include "../ssps/ssp_iface.h"
+#include "../ssps/ssp_utils.h"
+
+
+/*******************************************************************************
+ *
+ * planner DetReplan
+ *
+ * Replanning on the all-outcomes determinization (as in FF-Replan, Yoon et
+ * al., 2007): the actions of the plan found by the deterministic planner are
+ * followed until a state not on the plan is reached, then the deterministic
+ * planner is called again from that state. The deterministic planner is
+ * selected by name (see ExternalDetPlannerInterface::createInterface), e.g.,
+ * "gbfs-ff" for the in-process GBFS or "ff" for the external FF.
+ *
+ * If no plan exists from a state (i.e., it is a dead end in the
+ * determinization), then a random applicable action is returned.
+ *
+ ******************************************************************************/
+class PlannerDetReplan : public Planner {
+ public:
+  PlannerDetReplan(SSPIface const& ssp, std::string const& det_planner);
+  ~PlannerDetReplan() { }
+
+  /*
+   * Planner Interface
+   */
+  action_t const* decideAction(state_t const& s) override;
+  action_t const* decideAction(state_t const& s) const override {
+    if (policy_.isDefinedFor(s))
+      return policy_.action(s);
+    return randomAction(ssp_, s);
+  }
+  void trainForUsecs(uint64_t) override { }
+  void initRound() override { }
+  void endRound() override { }
+  void resetRoundStatistics() override { }
+  void statistics(std::ostream& os, int level) const override;
+
+ private:
+  SSPIface const& ssp_;
+  std::unique_ptr<ExternalDetPlannerInterface> det_planner_;
+  // Actions prescribed by the plans found so far
+  HashMapDetPolicy policy_;
+  size_t replans_;
+  size_t dead_ends_;
+};
+
+#endif // PLANNER_DET_REPLAN_H
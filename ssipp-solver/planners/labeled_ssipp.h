@@ -151,6 +151,7 @@ class PlannerLabeledSSiPP : public OptimalPlanner {
    * Heuristic Planner Interface
    */
   double value(state_t const& s) const { return v_.value(s); }
+  hash_t* valueFunction() { return &v_; }
 
 
   /*
@@ -92,6 +92,7 @@ class PlannerLRTDP : public OptimalPlanner {
    * Heuristic Planner Interface
    */
   double value(state_t const& s) const { return v_.value(s); }
+  hash_t* valueFunction() { return &v_; }
 
   /*
    * Optimal Planner Interface
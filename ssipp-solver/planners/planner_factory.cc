@@ -1,3 +1,4 @@
+#include <algorithm>
 #include <assert.h>
 #include <math.h>
 #include <set>
@@ -5,11 +6,14 @@
 
 #include "planner_factory.h"
 
+#include "det_replan.h"
 #include "greedy.h"
 #include "labeled_ssipp.h"
 #include "lrtdp.h"
+#include "prioritized_sweeping.h"
 #include "random.h"
 #include "ssipp.h"
+#include "tvi.h"
 #include "vi.h"
 
 #include "../ext/mgpt/global.h"
@@ -25,6 +29,16 @@ Planner* createPlanner(SSPIface const& ssp, std::string const& name,
   else if (!strcasecmp(name.c_str(), "vi")) {
     return new PlannerVI(ssp, heuristic, gpt::epsilon);
   }
+  else if (!strncasecmp(name.c_str(), "tvi", 3)) {
+    // tvi or tvi:<threads>
+    size_t n_threads = 1;
+    if (name.size() > 4 && name[3] == ':')
+      n_threads = std::max(1, atoi(name.c_str() + 4));
+    return new PlannerTVI(ssp, heuristic, gpt::epsilon, n_threads);
+  }
+  else if (!strcasecmp(name.c_str(), "ps")) {
+    return new PlannerPrioritizedSweeping(ssp, heuristic, gpt::epsilon);
+  }
   else if (!strcasecmp(name.c_str(), "glrtdp"))  {
     // Like LRTDP, but doesn't plan during decideAction(). Instead, it executes
     // greedily (hence "g" in "glrtdp"), assuming that all planning has been
@@ -36,6 +50,13 @@ Planner* createPlanner(SSPIface const& ssp, std::string const& name,
     return new PlannerLRTDP(ssp, heuristic, gpt::epsilon,
                             MAX_TRACE_SIZE, false);
   }
+  else if (!strncasecmp(name.c_str(), "replan", 6)) {
+    // replan or replan:<det-planner>
+    std::string det_planner = "gbfs-ff";
+    if (name.size() > 7 && name[6] == ':')
+      det_planner = name.substr(7);
+    return new PlannerDetReplan(ssp, det_planner);
+  }
   else if (!strncasecmp(name.c_str(), "labeledssipp:", 12)) {
     return new PlannerLabeledSSiPP(ssp, heuristic, gpt::epsilon,
                                    name.substr(12));
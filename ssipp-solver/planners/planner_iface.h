@@ -61,6 +61,11 @@ class HeuristicPlanner : public Planner {
   // Returns the planners estimate of V*(s). This should be straightforward
   // since this is a Heuristic Planner and it should carry such estimate.
   virtual double value(state_t const& s) const = 0;
+
+  // Returns the hash used by the planner to store its estimate of V*, or
+  // nullptr if the planner does not keep one. Used to save and warm start
+  // value functions (see ssps/value_table_io.h).
+  virtual hash_t* valueFunction() { return nullptr; }
 };
 
 
@@ -0,0 +1,123 @@
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+#include "planner_iface.h"
+#include "prioritized_sweeping.h"
+
+#include "../utils/die.h"
+#include "../ext/mgpt/global.h"
+#include "../ext/mgpt/hash.h"
+#include "../ext/mgpt/states.h"
+
+/*******************************************************************************
+ *
+ * planner Prioritized Sweeping
+ *
+ ******************************************************************************/
+
+size_t PlannerPrioritizedSweeping::solve(state_t const& s) {
+  if (ssp_.isGoal(s))
+    return 0;
+  if (!info_[s].expanded)
+    push(s, std::numeric_limits<double>::infinity());
+
+  size_t n_backups = 0;
+  size_t loop_counter = 0;
+  while (!Q_.empty()) {
+    double const priority = Q_.top().first;
+    state_t const cur_s = Q_.top().second;
+    StateInfo& info = info_[cur_s];
+    if (!info.queued || info.priority != priority) {
+      Q_.pop();  // stale entry
+      continue;
+    }
+    if (priority <= epsilon_) {
+      // Every other state in Q_ has priority at most epsilon as well
+      break;
+    }
+    // Checking the deadline before popping, so an interrupted solve doesn't
+    // lose cur_s
+    gpt::incCounterAndCheckDeadlineEvery(loop_counter, 1000);
+    Q_.pop();
+    info.queued = false;
+    info.priority = 0;
+    if (!info.expanded)
+      expand(cur_s);
+
+    double const old_v = v_.value(cur_s);
+    action_t const* a = nullptr;
+    double new_v = 0;
+    std::tie(a, new_v) = Bellman::update(cur_s, v_, ssp_);
+    n_backups++;
+    backups_++;
+
+#ifdef PS_SHOW_UPDATES
+    std::cout << "[ps::update] priority = " << priority << " ";
+    cur_s.debug_print(gpt::problem, &v_);
+    std::cout << " from " << old_v << " to " << new_v << std::endl;
+#endif
+
+    double const delta = fabs(new_v - old_v);
+    if (delta > 0) {
+      auto it = predecessors_.find(cur_s);
+      if (it != predecessors_.end()) {
+        for (auto const& pred : it->second) {
+          push(pred.first, info_[pred.first].priority + delta * pred.second);
+        }
+      }
+    }
+
+    // Focusing the search on the greedy envelope: the greedy successors never
+    // expanded before have to be backed up at least once
+    if (a) {
+      ssp_.expand(*a, cur_s, pr_);
+      for (auto const& ip : pr_) {
+        state_t const& next_s = ip.event();
+        if (!ssp_.isGoal(next_s) && !info_[next_s].expanded)
+          push(next_s, std::numeric_limits<double>::infinity());
+      }
+    }
+  }
+  return n_backups;
+}
+
+
+void PlannerPrioritizedSweeping::push(state_t const& s, double priority) {
+  StateInfo& info = info_[s];
+  if (info.queued && info.priority >= priority)
+    return;
+  info.priority = priority;
+  info.queued = true;
+  Q_.push(PriorityAndState(priority, s));
+}
+
+
+void PlannerPrioritizedSweeping::expand(state_t const& s) {
+  max_prob_.clear();
+  for (action_t const& a : ssp_.applicableActions(s)) {
+    ssp_.expand(a, s, pr_);
+    for (auto const& ip : pr_) {
+      double& p = max_prob_[ip.event()];
+      p = std::max(p, (double) ip.prob());
+    }
+  }
+  for (auto const& it : max_prob_) {
+    if (!ssp_.isGoal(it.first))
+      predecessors_[it.first].emplace_back(s, it.second);
+  }
+  info_[s].expanded = true;
+}
+
+
+void PlannerPrioritizedSweeping::statistics(std::ostream &os, int level) const
+{
+  if (level > 0) {
+    os << "[ps]: backups = " << backups_ << std::endl;
+    os << "[ps]: states with priority = " << info_.size() << std::endl;
+    os << "[ps]: queue size (with stale entries) = " << Q_.size() << std::endl;
+    os << "[ps]: hash size = " << v_.size() << std::endl;
+  }
+  if (level >= 300)
+    v_.print(os, ssp_);
+}
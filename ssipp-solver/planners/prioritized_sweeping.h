@@ -0,0 +1,141 @@
+#ifndef PLANNER_PRIORITIZED_SWEEPING_H
+#define PLANNER_PRIORITIZED_SWEEPING_H
+
+#include <iostream>
+#include <queue>
+#include <utility>
+#include <vector>
+
+#include "planner_iface.h"
+
+#include "../ext/mgpt/actions.h"
+#include "../ssps/bellman.h"
+#include "../ext/mgpt/hash.h"
+#include "../ssps/prob_dist_state.h"
+#include "../ssps/ssp_utils.h"
+#include "../utils/utils.h"
+
+class heuristic_t;
+
+
+/*******************************************************************************
+ *
+ * planner Prioritized Sweeping
+ *
+ * Focused version of prioritized sweeping (Moore & Atkeson, 1993; Wingate &
+ * Seppi, 2005) for SSPs. Backups are scheduled by a max-priority queue over
+ * the states in the value function, where the priority of a state is an upper
+ * bound on its Bellman residual:
+ *  - a state is expanded (i.e., it gets a priority) when it is first reached
+ *    from s0 by a greedy action, so the search is focused on the current
+ *    greedy envelope;
+ *  - after the backup of s changes V(s) by delta, the priority of each
+ *    predecessor p of s is increased by delta * max_a P(s|p,a), which bounds
+ *    how much the residual of p can grow because of s.
+ * The states that were never expanded have infinite priority. solve stops when
+ * the top priority is at most epsilon, i.e., all the expanded states (which
+ * include the greedy envelope of s0) are epsilon-consistent. Since the queue
+ * is kept between calls, trainForUsecs can be called several times to spend a
+ * time budget in slices.
+ *
+ ******************************************************************************/
+class PlannerPrioritizedSweeping : public OptimalPlanner {
+ public:
+  PlannerPrioritizedSweeping(SSPIface const& ssp, heuristic_t& heur,
+                             double epsilon)
+    : OptimalPlanner(), ssp_(ssp),
+      internal_v_(new hash_t(gpt::initial_hash_size, heur)),
+      v_(*internal_v_), epsilon_(epsilon), backups_(0)
+  { }
+
+  ~PlannerPrioritizedSweeping() { }
+
+  /*
+   * Planner Interface
+   */
+  action_t const* decideAction(state_t const& s) override {
+    solve(s);
+    return Bellman::greedyAction(s, v_, ssp_);
+  }
+
+  action_t const* decideAction(state_t const& s) const override {
+    return Bellman::constGreedyAction(s, v_, ssp_);
+  }
+
+  void trainForUsecs(uint64_t max_time_usec) override {
+    if (!runForUsec(max_time_usec, [this]() { solve(ssp_.s0()); })) {
+      std::cout << "[PrioritizedSweeping::trainForUsecs]: training finished "
+                << "before convergence." << std::endl;
+    }
+  }
+
+  void initRound() override { }
+  void endRound() override { }
+  void resetRoundStatistics() override { };
+  void statistics(std::ostream& os, int level) const override;
+
+  /*
+   * Heuristic Planner Interface
+   */
+  double value(state_t const& s) const override { return v_.value(s); }
+  hash_t* valueFunction() override { return &v_; }
+
+  /*
+   * Optimal Planner Interface
+   */
+  double optimalSolution() override {
+    solve(ssp_.s0());
+    return v_.value(ssp_.s0());
+  }
+
+  // Adds s to the queue (if it was never expanded) and applies backups in
+  // order of priority until the top priority is at most epsilon. Returns the
+  // number of backups applied.
+  size_t solve(state_t const& s);
+
+
+ private:
+  // Information about the states in the queue
+  struct StateInfo {
+    StateInfo() : priority(0), expanded(false), queued(false) { }
+    double priority;
+    bool expanded;
+    // True if the state is in Q_ with its current priority
+    bool queued;
+  };
+
+  // (p, max_a P(s|p,a)) for each expanded predecessor p of a state s
+  using Predecessors = std::vector<std::pair<state_t, double>>;
+
+  using PriorityAndState = std::pair<double, state_t>;
+  struct MaxPriorityFirst {
+    bool operator()(PriorityAndState const& p1, PriorityAndState const& p2) {
+      return p1.first < p2.first;
+    }
+  };
+
+  // Sets the priority of s (if it is larger than the current one) and adds s
+  // to Q_
+  void push(state_t const& s, double priority);
+
+  // Adds s as predecessor of all its successors
+  void expand(state_t const& s);
+
+  SSPIface const& ssp_;
+  std::unique_ptr<hash_t> internal_v_;
+  hash_t& v_;
+  double epsilon_;
+
+  // Stale entries (priority different from info_[s].priority) are ignored
+  std::priority_queue<PriorityAndState, std::vector<PriorityAndState>,
+                      MaxPriorityFirst> Q_;
+  HashMapState<StateInfo> info_;
+  HashMapState<Predecessors> predecessors_;
+  // Used by expand to store max_a P(s'|s,a) for each successor s'
+  HashMapState<double> max_prob_;
+  ProbDistState pr_;
+
+  size_t backups_;
+};
+
+#endif  // PLANNER_PRIORITIZED_SWEEPING_H
@@ -207,10 +207,10 @@ void PlannerSSiPP::usage(std::ostream& os) const {
  * DECIDEACTION
  */
 action_t const* PlannerSSiPP::decideAction(state_t const& s) {
-  static size_t decideActionCounter = 0;
+  static thread_local size_t decideActionCounter = 0;
   gpt::incCounterAndCheckDeadlineEvery(decideActionCounter, 10);
   gpt::checkDeadline();
-  static size_t num_actions_same_s4p = 0;
+  static thread_local size_t num_actions_same_s4p = 0;
 
 //  std::cout << "=> SSiPP: s = " << s.toString() << " V = " << v_.value(s)
 //            << std::endl;
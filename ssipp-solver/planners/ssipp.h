@@ -179,6 +179,7 @@ class PlannerSSiPP : public HeuristicPlanner {
    * Heuristic Planner Interface
    */
   double value(state_t const& s) const override { return v_.value(s); }
+  hash_t* valueFunction() override { return &v_; }
 
 
   /*
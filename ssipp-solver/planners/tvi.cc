@@ -0,0 +1,236 @@
+#include <algorithm>
+#include <utility>
+#include <vector>
+
+#include "planner_iface.h"
+#include "tvi.h"
+
+#include "../utils/die.h"
+#include "../utils/parallel.h"
+#include "../ext/mgpt/global.h"
+#include "../ext/mgpt/hash.h"
+#include "../ssps/ssp_utils.h"
+#include "../ext/mgpt/states.h"
+
+
+/*******************************************************************************
+ *
+ * planner TVI
+ *
+ ******************************************************************************/
+
+void PlannerTVI::solve() {
+  if (solved_)
+    return;
+
+  std::vector<double> first_residual;
+  std::vector<std::vector<size_t>> sccs_by_depth;
+  bool converged = false;
+  while (!converged) {
+    iterations_++;
+    buildGraph();
+    computeSCCs();
+
+    size_t const n_sccs = scc_begin_.size() - 1;
+    sccs_by_depth.clear();
+    for (size_t c = 0; c < n_sccs; ++c) {
+      if (scc_depth_[c] >= sccs_by_depth.size())
+        sccs_by_depth.resize(scc_depth_[c] + 1);
+      sccs_by_depth[scc_depth_[c]].push_back(c);
+    }
+
+    // The SCCs with the same depth only depend on SCCs with smaller depth,
+    // i.e., they are independent and can be solved concurrently. Each
+    // backup only writes the value of its own state, and all the values it
+    // reads are already in v_ (they were inserted by buildGraph)
+    first_residual.assign(n_sccs, 0);
+    for (std::vector<size_t> const& sccs : sccs_by_depth) {
+      parallelFor(sccs.size(), n_threads_, [&](size_t, size_t i) {
+        first_residual[sccs[i]] = solveSCC(sccs[i]);
+      });
+      sccs_solved_ += sccs.size();
+    }
+
+    converged = true;
+    for (double residual : first_residual) {
+      if (residual > epsilon_) {
+        converged = false;
+        break;
+      }
+    }
+#ifdef TVI_SHOW_ITERATIONS
+    std::cout << "[tvi] Iteration " << iterations_ << ": envelope size = "
+              << states_.size() << ", SCCs = " << n_sccs << ", V(s0) = "
+              << v_.value(ssp_.s0()) << std::endl;
+#endif
+  }
+  solved_ = true;
+}
+
+
+void PlannerTVI::buildGraph() {
+  states_.clear();
+  index_.clear();
+  succ_begin_.clear();
+  succ_.clear();
+
+  state_t const& s0 = ssp_.s0();
+  if (ssp_.isGoal(s0))
+    return;
+
+  size_t counter = 0;
+  index_[s0] = 0;
+  states_.push_back(s0);
+  for (size_t i = 0; i < states_.size(); ++i) {
+    gpt::incCounterAndCheckDeadlineEvery(counter, 1000);
+    // states_ might be reallocated below
+    state_t const s = states_[i];
+    // This adds s to v_ if it is not there yet (with gpt::hash_all)
+    v_.value(s);
+    // and this adds the successors of all its applicable actions (see
+    // Bellman::qValue)
+    action_t const* a = Bellman::greedyAction(s, v_, ssp_);
+    if (!a)
+      continue;  // dead end
+    ssp_.expand(*a, s, pr_);
+    for (auto const& ip : pr_) {
+      if (ssp_.isGoal(ip.event()))
+        continue;
+      if (index_.emplace(ip.event(), states_.size()).second)
+        states_.push_back(ip.event());
+    }
+  }
+
+  for (size_t i = 0; i < states_.size(); ++i) {
+    gpt::incCounterAndCheckDeadlineEvery(counter, 1000);
+    succ_begin_.push_back(succ_.size());
+    for (action_t const& a : ssp_.applicableActions(states_[i])) {
+      ssp_.expand(a, states_[i], pr_);
+      for (auto const& ip : pr_) {
+        auto it = index_.find(ip.event());
+        if (it != index_.end())
+          succ_.push_back(it->second);
+      }
+    }
+  }
+  succ_begin_.push_back(succ_.size());
+}
+
+
+void PlannerTVI::computeSCCs() {
+  size_t const n = states_.size();
+  size_t const UNDEF = n;
+  std::vector<size_t> num(n, UNDEF);
+  std::vector<size_t> low(n, 0);
+  std::vector<size_t> scc_of(n, 0);
+  std::vector<char> on_stack(n, 0);
+  std::vector<size_t> stack;
+  // Recursion stack of Tarjan's algorithm: (state, next edge to visit)
+  std::vector<std::pair<size_t, size_t>> calls;
+
+  scc_begin_.assign(1, 0);
+  scc_states_.clear();
+  scc_acyclic_.clear();
+  size_t next_num = 0;
+  for (size_t root = 0; root < n; ++root) {
+    if (num[root] != UNDEF)
+      continue;
+    num[root] = low[root] = next_num++;
+    stack.push_back(root);
+    on_stack[root] = 1;
+    calls.emplace_back(root, succ_begin_[root]);
+    while (!calls.empty()) {
+      size_t const u = calls.back().first;
+      size_t const e = calls.back().second;
+      if (e < succ_begin_[u + 1]) {
+        calls.back().second++;
+        size_t const w = succ_[e];
+        if (num[w] == UNDEF) {
+          num[w] = low[w] = next_num++;
+          stack.push_back(w);
+          on_stack[w] = 1;
+          calls.emplace_back(w, succ_begin_[w]);
+        }
+        else if (on_stack[w]) {
+          low[u] = std::min(low[u], num[w]);
+        }
+        continue;
+      }
+
+      calls.pop_back();
+      if (!calls.empty()) {
+        size_t const parent = calls.back().first;
+        low[parent] = std::min(low[parent], low[u]);
+      }
+      if (low[u] == num[u]) {
+        // u is the root of an SCC. The states are stored in the order they
+        // are popped, i.e., the most recently discovered (deepest) first.
+        size_t const c = scc_begin_.size() - 1;
+        size_t w;
+        do {
+          w = stack.back();
+          stack.pop_back();
+          on_stack[w] = 0;
+          scc_of[w] = c;
+          scc_states_.push_back(w);
+        } while (w != u);
+        scc_begin_.push_back(scc_states_.size());
+
+        bool acyclic = (scc_begin_[c + 1] - scc_begin_[c] == 1);
+        for (size_t i = succ_begin_[u]; acyclic && i < succ_begin_[u + 1]; ++i)
+          acyclic = (succ_[i] != u);
+        scc_acyclic_.push_back(acyclic);
+      }
+    }
+  }
+
+  // SCCs are found in reverse topological order, so the successors of an SCC
+  // always have a smaller index
+  size_t const n_sccs = scc_begin_.size() - 1;
+  scc_depth_.assign(n_sccs, 0);
+  for (size_t c = 0; c < n_sccs; ++c) {
+    largest_scc_ = std::max(largest_scc_, scc_begin_[c + 1] - scc_begin_[c]);
+    for (size_t i = scc_begin_[c]; i < scc_begin_[c + 1]; ++i) {
+      size_t const u = scc_states_[i];
+      for (size_t e = succ_begin_[u]; e < succ_begin_[u + 1]; ++e) {
+        size_t const d = scc_of[succ_[e]];
+        if (d != c)
+          scc_depth_[c] = std::max(scc_depth_[c], scc_depth_[d] + 1);
+      }
+    }
+  }
+}
+
+
+double PlannerTVI::solveSCC(size_t c) {
+  double first_residual = -1;
+  double max_residual = 0;
+  size_t backup_counter = 0;
+  do {
+    max_residual = 0;
+    for (size_t i = scc_begin_[c]; i < scc_begin_[c + 1]; ++i) {
+      gpt::incCounterAndCheckDeadlineEvery(backup_counter, 1000);
+      // Computing the Bellman residual and ALSO APPLYING a Bellman UPDATE
+      double residual = Bellman::residual(states_[scc_states_[i]], v_, ssp_,
+                                          true);
+      max_residual = std::max(max_residual, residual);
+    }
+    if (first_residual < 0)
+      first_residual = max_residual;
+  } while (!scc_acyclic_[c] && max_residual > epsilon_);
+  return first_residual;
+}
+
+
+void PlannerTVI::statistics(std::ostream &os, int level) const {
+  if (level > 0) {
+    os << "[tvi]: iterations = " << iterations_ << std::endl;
+    os << "[tvi]: SCCs solved = " << sccs_solved_ << std::endl;
+    os << "[tvi]: largest SCC = " << largest_scc_ << std::endl;
+    os << "[tvi]: last envelope size = " << states_.size() << std::endl;
+    os << "[tvi]: threads = " << n_threads_ << std::endl;
+    os << "[tvi]: hash size = " << v_.size() << std::endl;
+  }
+  if (level >= 300)
+    v_.print(os, ssp_);
+}
@@ -0,0 +1,147 @@
+#ifndef PLANNER_TVI_H
+#define PLANNER_TVI_H
+
+#include <algorithm>
+#include <iostream>
+#include <vector>
+
+#include "planner_iface.h"
+
+#include "../ext/mgpt/actions.h"
+#include "../ssps/bellman.h"
+#include "../ext/mgpt/hash.h"
+#include "../ssps/prob_dist_state.h"
+#include "../ssps/ssp_utils.h"
+#include "../utils/utils.h"
+
+class heuristic_t;
+
+/*******************************************************************************
+ *
+ * planner TVI (Topological Value Iteration)
+ *
+ * Dai, Mausam, Weld, Goldsmith. Topological Value Iteration Algorithms. JAIR
+ * 2011.
+ *
+ * Instead of sweeping all the reachable states until convergence (PlannerVI),
+ * each iteration of TVI:
+ *  1. finds the greedy envelope, i.e., the states reachable from s0 using the
+ *     greedy actions w.r.t. the current value function;
+ *  2. builds the graph over the envelope in which s -> s' iff s' is a
+ *     successor of s for some applicable action (states outside the envelope
+ *     are treated as constants during the iteration);
+ *  3. decomposes this graph in strongly connected components (SCCs) and solves
+ *     them in reverse topological order: each SCC is swept until its max
+ *     residual is at most epsilon, so a state is only updated after everything
+ *     it depends on has converged.
+ * The iterations stop when every SCC of the envelope was epsilon-consistent
+ * in its first sweep. Since the value function is improved after every SCC,
+ * TVI is anytime and trainForUsecs can stop it at any point.
+ *
+ * SCCs without a path between them (same depth in the DAG of SCCs) are
+ * independent and are solved by n_threads threads. This requires all the
+ * values read by the backups to be in the hash before the parallel phase, so
+ * only one thread is used if gpt::hash_all is false.
+ *
+ ******************************************************************************/
+class PlannerTVI : public OptimalPlanner
+{
+ public:
+  PlannerTVI(SSPIface const& ssp, heuristic_t& heur, double epsilon,
+             size_t n_threads = 1)
+    : OptimalPlanner(), ssp_(ssp),
+      internal_v_(new hash_t(gpt::initial_hash_size, heur)),
+      v_(*internal_v_), epsilon_(epsilon),
+      n_threads_(gpt::hash_all ? std::max(n_threads, (size_t) 1) : 1),
+      solved_(false), iterations_(0), sccs_solved_(0), largest_scc_(0)
+  { }
+
+  ~PlannerTVI() { }
+
+  /*
+   * Planner Interface
+   */
+  action_t const* decideAction(state_t const& s) override {
+    solve();
+    return Bellman::constGreedyAction(s, v_, ssp_);
+  }
+
+  action_t const* decideAction(state_t const& s) const override {
+    return Bellman::constGreedyAction(s, v_, ssp_);
+  }
+
+  void trainForUsecs(uint64_t max_time_usec) override {
+    if (!runForUsec(max_time_usec, [this] { solve(); })) {
+      std::cout << "[TVI::trainForUsecs]: training finished before "
+                << "convergence." << std::endl;
+    }
+  }
+
+  void initRound() override { }
+  void endRound() override { }
+  void resetRoundStatistics() override { };
+  void statistics(std::ostream& os, int level) const override;
+
+  /*
+   * Heuristic Planner Interface
+   */
+  double value(state_t const& s) const override { return v_.value(s); }
+  hash_t* valueFunction() override { return &v_; }
+
+  /*
+   * Optimal Planner Interface
+   */
+  double optimalSolution() override {
+    solve();
+    return v_.value(ssp_.s0());
+  }
+
+  // Runs TVI iterations from s0 until the greedy envelope is
+  // epsilon-consistent
+  void solve();
+
+
+ private:
+  // Finds the greedy envelope of s0 (states_ and index_) and the edges of its
+  // graph (succ_begin_ and succ_)
+  void buildGraph();
+
+  // Tarjan's algorithm over the graph of buildGraph. The SCCs are stored in
+  // scc_begin_ and scc_states_ in reverse topological order, and scc_depth_
+  // is the length of the longest path from each SCC to a sink of the DAG.
+  void computeSCCs();
+
+  // Sweeps the SCC c until its max residual is at most epsilon_ and returns
+  // the max residual of the first sweep
+  double solveSCC(size_t c);
+
+  SSPIface const& ssp_;
+  std::unique_ptr<hash_t> internal_v_;
+  hash_t& v_;
+  double epsilon_;
+  size_t n_threads_;
+  bool solved_;
+
+  // Greedy envelope and its graph in CSR format: the successors of
+  // states_[i] are succ_[succ_begin_[i]..succ_begin_[i+1])
+  std::vector<state_t> states_;
+  HashMapState<size_t> index_;
+  std::vector<size_t> succ_begin_;
+  std::vector<size_t> succ_;
+  ProbDistState pr_;
+
+  // The states of the SCC c are scc_states_[scc_begin_[c]..scc_begin_[c+1])
+  std::vector<size_t> scc_begin_;
+  std::vector<size_t> scc_states_;
+  std::vector<size_t> scc_depth_;
+  // True if the SCC c is a single state without a self-loop, so one backup
+  // is enough to solve it
+  std::vector<char> scc_acyclic_;
+
+  // Statistics
+  size_t iterations_;
+  size_t sccs_solved_;
+  size_t largest_scc_;
+};
+
+#endif  // PLANNER_TVI_H
@@ -64,6 +64,7 @@ class PlannerVI : public OptimalPlanner
    * Heuristic Planner Interface
    */
   double value(state_t const& s) const override { return v_.value(s); }
+  hash_t* valueFunction() override { return &v_; }
 
   /*
    * Optimal Planner Interface
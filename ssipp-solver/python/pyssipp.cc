@@ -3,9 +3,13 @@
 #include <unordered_set>
 #include <memory>
 #include <stack>
+#include <cstring>
+#include <sstream>
+#include <vector>
 
 // pybind
 #include <pybind11/pybind11.h>
+#include <pybind11/numpy.h>
 #include <pybind11/stl.h>
 
 // ssipp
@@ -16,11 +20,14 @@
 #include "heuristics/heuristic_factory.h"
 #include "heuristics/heuristic_iface.h"
 #include "heuristics/action_heuristic.h"
+#include "heuristics/action_features.h"
 #include "heuristics/lm_cut.h"
 #include "ssps/ppddl_adaptors.h"
+#include "ssps/value_table_io.h"
 #include "planners/planner_iface.h"
 #include "planners/planner_factory.h"
 #include "planners/lrtdp.h"
+#include "planners/prioritized_sweeping.h"
 
 namespace py = pybind11;
 using std::stack;
@@ -123,7 +130,7 @@ double hp_q_value(HeuristicPlanner &hp, const state_t &s, const action_t &a) {
     return gpt::dead_end_value.double_value();
   }
 
-  double qv_acc = a.cost(s).double_value();
+  double qv_acc = a.hot_cost(s).double_value();
   double p_acc = 0;
   ProbDistState pr;
   a.expand(s, pr);
@@ -207,6 +214,42 @@ py::tuple extract_policy(Planner &p,
   return rv;
 }
 
+// value function of a planner, or an exception if it has none (see
+// HeuristicPlanner::valueFunction)
+static hash_t &planner_value_function(HeuristicPlanner &p) {
+  hash_t *v = p.valueFunction();
+  if (!v) {
+    throw std::runtime_error("This planner does not keep a value function");
+  }
+  return *v;
+}
+
+// dump V and the greedy policy of p in the binary format of value_table_io.h;
+// unlike extract_policy, this covers every state in the hash and does not
+// create any Python object per state
+size_t save_value_table(HeuristicPlanner &p, const SSPIface &ssp,
+                        const problem_t &problem, const std::string &path) {
+  return saveValueTable(path, planner_value_function(p), ssp, problem);
+}
+
+// warm start p with a table written by save_value_table
+size_t load_value_table(HeuristicPlanner &p, const problem_t &problem,
+                        const std::string &path) {
+  return MappedValueTable(path, problem).loadInto(planner_value_function(p));
+}
+
+// (value, greedy action or None) of s, or None if s is not in the table
+py::object value_table_lookup(const MappedValueTable &table,
+                              const state_t &s) {
+  size_t i = table.find(s);
+  if (i == MappedValueTable::NOT_FOUND) {
+    return py::none();
+  }
+  const action_t *a = table.action(i);
+  return py::make_tuple(table.value(i),
+                        a ? py::cast(a) : py::object(py::none()));
+}
+
 // returns a list of successor states and transition probabilities for a given
 // state under a given action
 py::list successors(const SSPIface &ssp, const state_t &s, const action_t &a) {
@@ -220,10 +263,146 @@ py::list successors(const SSPIface &ssp, const state_t &s, const action_t &a) {
   return successors;
 }
 
-// wraps action.cost() to return double instead of rational
+// hands the buffer of v over to a new NumPy array of the given shape without
+// copying it; the array frees the buffer when it is collected
+template <typename T>
+py::array_t<T> vector_to_array(std::vector<T> &&v,
+                               std::vector<size_t> const &shape) {
+  std::vector<T> *owned = new std::vector<T>(std::move(v));
+  py::capsule free_when_done(owned, [](void *p) {
+    delete reinterpret_cast<std::vector<T> *>(p);
+  });
+  std::vector<size_t> strides(shape.size(), sizeof(T));
+  for (size_t i = shape.size() - 1; i > 0; --i) {
+    strides[i - 1] = strides[i] * shape[i];
+  }
+  return py::array_t<T>(shape, strides, owned->data(), free_when_done);
+}
+
+// packed representation of a state: state_t::size() words where bit (i % 32)
+// of word (i / 32) is set iff atom i holds (see problem_t::atom_inv_hash_get)
+py::array_t<uint32_t> state_to_packed(const state_t &s) {
+  std::vector<uint32_t> words(s.data(), s.data() + state_t::size());
+  return vector_to_array(std::move(words), {state_t::size()});
+}
+
+state_t state_from_packed(py::array_t<uint32_t, py::array::c_style |
+                                                py::array::forcecast> words) {
+  if (words.ndim() != 1 || (size_t)words.shape(0) != state_t::size()) {
+    throw py::value_error("packed state must have shape (state_words,)");
+  }
+  state_t s;
+  memcpy(s.mutable_data(), words.data(), state_t::size() * sizeof(unsigned));
+  return s;
+}
+
+// name of each atom index, i.e., of each bit of a packed state ("" for
+// negated atoms and unused bits)
+py::list atom_names(const problem_t &problem) {
+  py::list names;
+  for (size_t i = 0; i < state_t::size() * 32; ++i) {
+    const Atom *atom = nullptr;
+    if (i % 2 == 0 && i < problem_t::number_atoms()) {
+      atom = problem_t::atom_inv_hash_get(i);
+    }
+    if (atom) {
+      std::stringstream ost;
+      problem.print(ost, *atom);
+      names.append(py::str(ost.str()));
+    } else {
+      names.append(py::str(""));
+    }
+  }
+  return names;
+}
+
+// appends the outcomes of a in s to probs and words
+static void append_packed_successors(const SSPIface &ssp, const state_t &s,
+                                     const action_t &a, ProbDistState &pr,
+                                     std::vector<double> &probs,
+                                     std::vector<uint32_t> &words) {
+  ssp.expand(a, s, pr);
+  for (const auto &succ : pr) {
+    probs.push_back(succ.prob());
+    const unsigned *data = succ.event().data();
+    words.insert(words.end(), data, data + state_t::size());
+  }
+}
+
+// like successors, but returns (probs, states) where probs has shape (n,) and
+// states has shape (n, state_words) with the packed successor states (see
+// state_to_packed); no state_t or Python object is created per outcome
+py::tuple successors_packed(const SSPIface &ssp, const state_t &s,
+                            const action_t &a) {
+  std::vector<double> probs;
+  std::vector<uint32_t> words;
+  {
+    py::gil_scoped_release release;
+    ProbDistState pr;
+    append_packed_successors(ssp, s, a, pr, probs, words);
+  }
+  size_t n = probs.size();
+  return py::make_tuple(vector_to_array(std::move(probs), {n}),
+                        vector_to_array(std::move(words),
+                                        {n, state_t::size()}));
+}
+
+// successors_packed for many (state, action) pairs at once. Returns (offsets,
+// probs, states): the outcomes of pair i are rows offsets[i] to offsets[i+1]
+// (exclusive) of probs and states
+py::tuple successors_batch(const SSPIface &ssp,
+                           const std::vector<state_t> &states,
+                           const std::vector<const action_t *> &actions) {
+  if (states.size() != actions.size()) {
+    throw py::value_error("states and actions must have the same length");
+  }
+  for (const action_t *a : actions) {
+    if (!a) {
+      throw py::value_error("actions cannot be None");
+    }
+  }
+  std::vector<int64_t> offsets;
+  std::vector<double> probs;
+  std::vector<uint32_t> words;
+  {
+    py::gil_scoped_release release;
+    ProbDistState pr;
+    offsets.reserve(states.size() + 1);
+    offsets.push_back(0);
+    for (size_t i = 0; i < states.size(); ++i) {
+      append_packed_successors(ssp, states[i], *actions[i], pr, probs, words);
+      offsets.push_back(probs.size());
+    }
+  }
+  size_t n_pairs = states.size();
+  size_t n = probs.size();
+  return py::make_tuple(vector_to_array(std::move(offsets), {n_pairs + 1}),
+                        vector_to_array(std::move(probs), {n}),
+                        vector_to_array(std::move(words),
+                                        {n, state_t::size()}));
+}
+
+// wraps action.hot_cost() to return double instead of rational
 double action_t_cost(const action_t &action, const state_t &s) {
-  Rational r = action.cost(s);
-  return r.double_value();
+  return action.hot_cost(s).double_value();
+}
+
+// Computes the ASNets features of a batch of states. Returns a float32 array
+// of shape (len(states), |A|, extra_dim) and a float64 array with the
+// heuristic value of each state. The GIL is released while the features are
+// computed, so the worker threads of the extractor can run in parallel.
+py::tuple extract_features(ActionFeatureExtractor &self,
+                           const std::vector<state_t> &states) {
+  py::array_t<float> features({states.size(), self.numActions(),
+                               self.extraDim()});
+  py::array_t<double> values(states.size());
+  float *features_ptr = features.mutable_data();
+  double *values_ptr = values.mutable_data();
+  {
+    py::gil_scoped_release release;
+    self.extract(states, features_ptr, values_ptr);
+  }
+  return py::make_tuple(features, values);
 }
 
 // (for some reason I get ownership-related errors, as described below, when I
@@ -349,10 +528,37 @@ PYBIND11_MODULE(ssipp, m) {
         "Extract (state, action) pairs from planner's policy; return dict "
         "mapping s->a, plus flag saying whether search stopped early by "
         "exceeding state limit.");
+  m.def("save_value_table", &save_value_table,
+        py::arg("p"), py::arg("ssp"), py::arg("problem"), py::arg("path"),
+        "Write V and the greedy policy of every state in the planner's hash "
+        "to a binary value table at path; return the number of states. "
+        "Faster than extract_policy for large tables.");
+  m.def("load_value_table", &load_value_table,
+        py::arg("p"), py::arg("problem"), py::arg("path"),
+        "Copy the values in a binary value table into the planner's hash "
+        "(warm start); return the number of states.");
   m.def("successors", &successors,
         py::arg("ssp"), py::arg("s"), py::arg("a"),
         "Find list of successor pairs (transition prob., state) for given "
         "action in given state.");
+  m.def("successors_packed", &successors_packed,
+        py::arg("ssp"), py::arg("s"), py::arg("a"),
+        "Like successors, but return (probs, states) as NumPy arrays of "
+        "shape (n,) and (n, state_words) with packed states (see "
+        "state_to_packed).");
+  m.def("successors_batch", &successors_batch,
+        py::arg("ssp"), py::arg("states"), py::arg("actions"),
+        "successors_packed for the pairs (states[i], actions[i]); return "
+        "(offsets, probs, states) where the outcomes of pair i are the rows "
+        "offsets[i]:offsets[i+1] of probs and states.");
+  m.def("state_to_packed", &state_to_packed, py::arg("s"),
+        "Bitset of the atoms of a state as a uint32 array of shape "
+        "(state_words,); bit i is atom i (see atom_names).");
+  m.def("state_from_packed", &state_from_packed, py::arg("words"),
+        "Inverse of state_to_packed.");
+  m.def("atom_names", &atom_names, py::arg("problem"),
+        "Name of the atom of each bit of a packed state (\"\" for negated "
+        "atoms and unused bits).");
 
   py::class_<problem_t, ref<problem_t>>(m, "problem_t")
     .def("no_more_atoms", &problem_t::no_more_atoms,
@@ -400,6 +606,30 @@ PYBIND11_MODULE(ssipp, m) {
                   "lm-cut evaluation of state")
     SCREW_PICKLE();
 
+  py::class_<ActionFeatureExtractor> feature_extractor(
+    m, "ActionFeatureExtractor");
+  py::enum_<ActionFeatureExtractor::FeatureType>(feature_extractor,
+                                                 "FeatureType")
+    .value("CUT_FEATURES", ActionFeatureExtractor::CUT_FEATURES)
+    .value("HEURISTIC_FEATURES", ActionFeatureExtractor::HEURISTIC_FEATURES)
+    .export_values();
+  feature_extractor
+    .def(py::init<const problem_t &, const std::vector<std::string> &,
+                  ActionFeatureExtractor::FeatureType, const std::string &,
+                  size_t>(),
+         py::arg("problem"), py::arg("action_names"), py::arg("feature_type"),
+         py::arg("heuristic_name")="", py::arg("n_threads")=1,
+         // keep problem (2) alive so long as *this (1) is
+         py::keep_alive<1, 2>())
+    .def("extract", &extract_features, py::arg("states"),
+         "Compute (features, values) for a list of states; features has "
+         "shape (len(states), len(action_names), extra_dim)")
+    .def_property_readonly("extra_dim", &ActionFeatureExtractor::extraDim,
+                           "Number of features per action")
+    .def_property_readonly("n_threads", &ActionFeatureExtractor::numThreads,
+                           "Number of worker threads")
+    SCREW_PICKLE();
+
   py::class_<action_t, ref<action_t>>(m, "action_t")
     .def("name", &action_t::name, "String representation of action")
     .def("cost", action_t_cost, "Cost of applying this action in a given state.")
@@ -427,6 +657,17 @@ PYBIND11_MODULE(ssipp, m) {
         py::keep_alive<1, 2>())
     SCREW_PICKLE();
 
+  py::class_<MappedValueTable>(m, "MappedValueTable")
+    .def(py::init<const std::string &, const problem_t &>(),
+         py::arg("path"), py::arg("problem"),
+         // actions returned by lookup belong to problem (3)
+         py::keep_alive<1, 3>())
+    .def("__len__", &MappedValueTable::size)
+    .def("lookup", &value_table_lookup, py::arg("state"),
+         "Return (value, greedy action or None) for a state, or None if the "
+         "state is not in the table")
+    SCREW_PICKLE();
+
   py::class_<SuccessorEvaluator>(m, "SuccessorEvaluator")
     .def(py::init<std::shared_ptr<heuristic_t>>())
     .def("state_value", &SuccessorEvaluator::state_value,
@@ -515,6 +756,16 @@ PYBIND11_MODULE(ssipp, m) {
     SCREW_PICKLE();
   py::class_<PlannerLRTDP, OptimalPlanner>(m, "PlannerLRTDP")
     SCREW_PICKLE();
+  py::class_<PlannerPrioritizedSweeping, OptimalPlanner>(
+      m, "PlannerPrioritizedSweeping")
+    .def("solve", &PlannerPrioritizedSweeping::solve, py::arg("state"),
+         "Apply backups in order of priority until every state in the queue "
+         "has priority at most epsilon. Returns the number of backups.")
+    .def("trainForUsecs", &PlannerPrioritizedSweeping::trainForUsecs,
+         py::arg("usecs"),
+         "Run prioritized sweeping from s0 for at most the given CPU time "
+         "(in microseconds). It can be called again to resume.")
+    SCREW_PICKLE();
   m.def("createPlanner", &createPlanner,
         py::arg("problem"), py::arg("planner_name"), py::arg("heuristic"),
         // need to keep SSP and heuristic alive for as long as planner is
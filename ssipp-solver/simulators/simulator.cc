@@ -1,3 +1,4 @@
+#include <atomic>
 #include <string.h>
 
 #include "../utils/die.h"
@@ -8,6 +9,8 @@
 #include "../ext/mgpt/problems.h"
 
 #include "../planners/planner_iface.h"
+#include "../utils/parallel.h"
+#include "../utils/rand48.h"
 
 /*
  * RoundSummary
@@ -72,7 +75,7 @@ RoundSummary const Simulator::simulateRoundFrom(state_t const* s,
 
   RoundSummary r(0, 0, EndOfRoundStatus::PLANNER_GAVE_UP);
 
-  uint64_t start_time = get_cpu_and_sys_time_usec();
+  uint64_t start_time = cpuTimeUsec();
   initRound(planner);
 
   try {
@@ -92,7 +95,7 @@ RoundSummary const Simulator::simulateRoundFrom(state_t const* s,
         break;
       }
       else if (max_cpu_sys_time_usec > 0 &&
-          (get_cpu_and_sys_time_usec() - start_time) > max_cpu_sys_time_usec)
+          (cpuTimeUsec() - start_time) > max_cpu_sys_time_usec)
       {
         r.exitStatus = EndOfRoundStatus::TIMEOUT;
         break;
@@ -155,7 +158,7 @@ RoundSummary const Simulator::simulateRoundFrom(state_t const* s,
   catch (PlannerGaveUpException& e) {
     r.exitStatus = EndOfRoundStatus::PLANNER_GAVE_UP;
   }
-  r.totalCpuPlusSystemTime = get_cpu_and_sys_time_usec() - start_time;
+  r.totalCpuPlusSystemTime = cpuTimeUsec() - start_time;
   endRound(planner);
   return r;
 }
@@ -251,7 +254,7 @@ RoundSummary const LocalSimulator::simulateRound(Planner const* planner,
 
   RoundSummary r(0, 0, EndOfRoundStatus::PLANNER_GAVE_UP);
 
-  uint64_t start_time = get_cpu_and_sys_time_usec();
+  uint64_t start_time = cpuTimeUsec();
 
 
   try {
@@ -271,7 +274,7 @@ RoundSummary const LocalSimulator::simulateRound(Planner const* planner,
         break;
       }
       else if (max_cpu_sys_time_usec > 0 &&
-          (get_cpu_and_sys_time_usec() - start_time) > max_cpu_sys_time_usec)
+          (cpuTimeUsec() - start_time) > max_cpu_sys_time_usec)
       {
         r.exitStatus = EndOfRoundStatus::TIMEOUT;
         break;
@@ -335,7 +338,112 @@ RoundSummary const LocalSimulator::simulateRound(Planner const* planner,
   catch (PlannerGaveUpException& e) {
     r.exitStatus = EndOfRoundStatus::PLANNER_GAVE_UP;
   }
-  r.totalCpuPlusSystemTime = get_cpu_and_sys_time_usec() - start_time;
+  r.totalCpuPlusSystemTime = cpuTimeUsec() - start_time;
   return r;
 }
 
+
+
+/*******************************************************************************
+ *
+ * ParallelLocalSimulator
+ *
+ ******************************************************************************/
+
+namespace {
+// LocalSimulator that measures the time of the rounds using the CPU time of
+// its thread
+class WorkerSimulator : public LocalSimulator {
+ public:
+  WorkerSimulator(SSPIface const& ssp) : LocalSimulator(ssp) { }
+ protected:
+  uint64_t cpuTimeUsec() const override {
+    return get_thread_cpu_and_sys_time_usec();
+  }
+};
+
+// splitmix64: seeds of different rounds are unrelated even if they differ by
+// one bit
+uint64_t roundSeed(uint64_t seed, uint32_t round) {
+  uint64_t z = seed + 0x9e3779b97f4a7c15ULL * (round + 1);
+  z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+  z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+  return z ^ (z >> 31);
+}
+}  // namespace
+
+
+template<typename RunRound>
+std::vector<RoundSummary> const ParallelLocalSimulator::run(uint32_t n,
+    RunRound run_round)
+{
+  std::vector<RoundSummary> result(n);
+  if (!gpt::suppress_round_info) {
+    gpt::parsing_cpu_time = get_cpu_and_sys_time_usec();
+    std::cout << "<cpu+sys-time-since-start>"
+      << gpt::parsing_cpu_time
+      << "</cpu+sys-time-since-start>"
+      << std::endl;
+  }
+
+  // Set when a worker throws (e.g., DeadlineReachedException), so the other
+  // workers stop at the end of their current round
+  std::atomic<bool> abort(false);
+  size_t const n_workers = std::min(n_threads_, (size_t) n);
+  // Turned off when the workers are over, even if one of them throws
+  struct ConcurrentStates {
+    explicit ConcurrentStates(bool on) { state_t::set_concurrent_access(on); }
+    ~ConcurrentStates() { state_t::set_concurrent_access(false); }
+  } concurrent_states(n_workers > 1);
+  parallelFor(n_workers, n_workers, [&](size_t, size_t t) {
+    WorkerSimulator simulator(ssp_);
+    try {
+      for (uint32_t i = t; i < n && !abort; i += n_workers) {
+        ThreadRand48Seed round_seed(roundSeed(seed_, i));
+        result[i] = run_round(t, simulator, i);
+      }
+    } catch (...) {
+      abort = true;
+      throw;
+    }
+  });
+
+  if (!gpt::suppress_round_info) {
+    for (uint32_t i = 0; i < n; ++i) {
+      std::cout << "[Round Summary]: round # = " << i << std::endl
+                << result[i] << std::endl;
+    }
+  }
+  return result;
+}
+
+
+std::vector<RoundSummary> const ParallelLocalSimulator::simulateNRounds(
+    uint32_t n, PlannerFactory const& new_planner, uint32_t max_turn,
+    uint64_t max_cpu_sys_time_per_round_usec)
+{
+  size_t const n_workers = std::min(n_threads_, (size_t) n);
+  std::vector<std::shared_ptr<Planner>> planners;
+  for (size_t t = 0; t < n_workers; ++t) {
+    planners.push_back(new_planner(t));
+    DIE(planners.back() != nullptr, "Null planner", 1);
+  }
+  return run(n, [&](size_t t, WorkerSimulator& simulator, uint32_t) {
+    // simulateRoundFrom since LocalSimulator::simulateRound is the const
+    // version
+    return simulator.simulateRoundFrom(NULL, planners[t].get(), max_turn,
+                                       max_cpu_sys_time_per_round_usec);
+  });
+}
+
+
+std::vector<RoundSummary> const ParallelLocalSimulator::simulateNRounds(
+    uint32_t n, Planner const* planner, uint32_t max_turn,
+    uint64_t max_cpu_sys_time_per_round_usec)
+{
+  DIE(planner != NULL, "Null planner", 1);
+  return run(n, [&](size_t, WorkerSimulator& simulator, uint32_t) {
+    return simulator.simulateRound(planner, max_turn,
+                                   max_cpu_sys_time_per_round_usec);
+  });
+}
@@ -1,11 +1,15 @@
 #ifndef SIMULATOR_H
 #define SIMULATOR_H
 
+#include <functional>
 #include <iostream>
+#include <memory>
+#include <vector>
 
 #include "../ssps/policy.h"
 #include "../ext/mgpt/states.h"
 #include "../ssps/ssp_iface.h"
+#include "../utils/utils.h"
 
 
 
@@ -52,7 +56,7 @@ class RoundSummary {
   { }
   ~RoundSummary() { }
 
-  Rational accumulatedCost;
+  HotRational accumulatedCost;
   uint32_t totalActionsApplied;
   uint64_t totalCpuPlusSystemTime;
   EndOfRoundStatus exitStatus;
@@ -117,6 +121,9 @@ class Simulator {
   bool save_policy_;
   DetPolicy pi_;
 
+  // Clock used for the time of the rounds
+  virtual uint64_t cpuTimeUsec() const { return get_cpu_and_sys_time_usec(); }
+
   /* Methods that make an interface with the simulator: OVERWRITE THEM */
   virtual action_t const* requestPlannerAction(Planner* planner,
                                                state_t const s);
@@ -166,4 +173,59 @@ class LocalSimulator : public Simulator {
   virtual state_t const getInitialState();
 };
 
+
+
+/*
+ * Runs the rounds of LocalSimulator in n_threads threads. Each worker thread t
+ * runs the rounds t, t + n_threads, t + 2*n_threads, ... in this order and the
+ * random numbers of round i (outcomes and any tie breaking done through
+ * rand48.h) come from its own state seeded with (seed, i). The summaries are
+ * returned (and printed, unless gpt::suppress_round_info) in the order of the
+ * rounds, so the result only depends on seed and n_threads; if the planner
+ * doesn't learn between rounds, it only depends on seed. The time of each
+ * round is the CPU time of its worker thread.
+ */
+class ParallelLocalSimulator {
+ public:
+  // Returns the planner of the worker thread t. It is called sequentially
+  // before any round starts, so it can train the planner (trainForUsecs) and
+  // create heuristics that modify the problem. The planners are released once
+  // all the rounds are over (use a no-op deleter to keep a planner).
+  using PlannerFactory = std::function<std::shared_ptr<Planner>(size_t t)>;
+
+  ParallelLocalSimulator(SSPIface const& ssp, size_t n_threads, uint64_t seed)
+    : ssp_(ssp), n_threads_(n_threads > 0 ? n_threads : 1), seed_(seed)
+  { }
+
+  size_t numThreads() const { return n_threads_; }
+
+  // Each worker thread uses its own planner, i.e., planners are free to learn
+  // during the rounds (e.g., SSiPP and LRTDP).
+  std::vector<RoundSummary> const simulateNRounds(
+      uint32_t n,
+      PlannerFactory const& new_planner,
+      uint32_t max_turn,
+      uint64_t max_cpu_sys_time_per_round_usec = 0);
+
+  // All the worker threads share planner through its const decideAction (see
+  // LocalSimulator), e.g., to evaluate a value table already computed. The
+  // const decideAction of planner must be thread safe, which is the case for
+  // the planners of SSiPP when the states visited are in their value table
+  // (otherwise the heuristic is called).
+  std::vector<RoundSummary> const simulateNRounds(
+      uint32_t n,
+      Planner const* planner,
+      uint32_t max_turn,
+      uint64_t max_cpu_sys_time_per_round_usec = 0);
+
+ private:
+  // Calls run_round(t, simulator, i) for the rounds i of worker t
+  template<typename RunRound>
+  std::vector<RoundSummary> const run(uint32_t n, RunRound run_round);
+
+  SSPIface const& ssp_;
+  size_t n_threads_;
+  uint64_t seed_;
+};
+
 #endif // SIMULATOR_H
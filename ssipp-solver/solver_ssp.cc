@@ -1,3 +1,4 @@
+#include <algorithm>
 #include <iostream>
 #include <memory>
 
@@ -15,6 +16,7 @@
 
 #include "ssps/ppddl_adaptors.h"
 #include "ssps/policy.h"
+#include "ssps/value_table_io.h"
 
 #include "utils/exceptions.h"
 #include "utils/utils.h"
@@ -303,6 +305,26 @@ bool readArguments(int& argc, char**& argv, std::vector<char*>& remaining_args)
         gpt::randomize_actionsT_order = false;
         argv += 1;
         argc -= 1;
+      } else if (!strcasecmp(*argv, "--heuristic_cache")) {
+        gpt::heuristic_cache_size = atoi(argv[1]);
+        argv += 2;
+        argc -= 2;
+      } else if (!strcasecmp(*argv, "--s4p_threads")) {
+        gpt::s4p_threads = std::max(1, atoi(argv[1]));
+        argv += 2;
+        argc -= 2;
+      } else if (!strcasecmp(*argv, "--sim_threads")) {
+        gpt::simulator_threads = std::max(1, atoi(argv[1]));
+        argv += 2;
+        argc -= 2;
+      } else if (!strcasecmp(*argv, "--load_values")) {
+        gpt::load_values_file = argv[1];
+        argv += 2;
+        argc -= 2;
+      } else if (!strcasecmp(*argv, "--save_values")) {
+        gpt::save_values_file = argv[1];
+        argv += 2;
+        argc -= 2;
       } else if (!strcasecmp(*argv, "--train_for")) {
         gpt::train_for_usecs = 1000000 * (uint64_t) atoi(argv[1]);
         argv += 2;
@@ -356,10 +378,20 @@ void printUsageGlobal(std::ostream& os) {
      << "  --max_rss_kb <K>        (Maximum resident memory allowed in KB. Default = unlimited)" << std::endl
      << "  --max_cpu_time_sec <T>  (Maximum CPU time allowed in seconds. Default = unlimited)" << std::endl
      << "  --suppress_round_info" << std::endl
-     << "  <planner>         := random | vi | lrtdp | ssipp | labeledssipp"
+     << "  --heuristic_cache <N>   (Entries of the heuristic value cache, 0 disables it. Default = "
+     << gpt::heuristic_cache_size << ")" << std::endl
+     << "  --s4p_threads <N>       (Threads used to generate depth and trajectory S4Ps. Default = "
+     << gpt::s4p_threads << ")" << std::endl
+     << "  --sim_threads <N>       (Threads used to run the rounds with the local simulator, each one with its own planner. Default = "
+     << gpt::simulator_threads << ")" << std::endl
+     << "  --load_values <file>    (Value table used to warm start the planner, see --save_values)" << std::endl
+     << "  --save_values <file>    (Saves the value function and greedy policy of the planner in a binary value table)" << std::endl
+     << "  <planner>         := random | vi | tvi[:<threads>] | ps | lrtdp | ssipp | labeledssipp"
      << std::endl
+     << "                     | replan[:<det-planner>]" << std::endl
+     << "  <det-planner>     := gbfs-ff | gbfs-add | ff | lama   (default = gbfs-ff)" << std::endl
      << "  <heuristic-stack> := <heuristic-stack> '|' <heuristic> | <heuristic>" << std::endl
-     << "  <heuristic>       := simpleZero | smartZero | h-max | h-add | lm-cut " << std::endl
+     << "  <heuristic>       := simpleZero | smartZero | h-max | h-add | h-ff | lm-cut " << std::endl
      << std::endl
      << "A stop criterion must be provided, that is, one of the following flags must be passed: " << std::endl
      << "  -R <number of round>" << std::endl
@@ -577,6 +609,19 @@ int main(int argc, char** argv) {
     if (!execution_simulator)
       return -1;
 
+    if (!gpt::load_values_file.empty()) {
+      HeuristicPlanner* heur_planner = dynamic_cast<HeuristicPlanner*>(planner);
+      hash_t* v = (heur_planner ? heur_planner->valueFunction() : nullptr);
+      if (!v) {
+        std::cout << "[ERROR] Planner '" << gpt::algorithm << "' cannot be "
+                  << "warm started. Quitting" << std::endl;
+        exit(-1);
+      }
+      size_t n = MappedValueTable(gpt::load_values_file, *problem).loadInto(*v);
+      std::cout << "Loaded " << n << " values from '"
+                << gpt::load_values_file << "'" << std::endl;
+    }
+
     if (gpt::train_for_usecs > 0) {
       planner->trainForUsecs(gpt::train_for_usecs);
     }
@@ -606,9 +651,57 @@ int main(int argc, char** argv) {
         // evaluated equally.
         srand48(gpt::seed + 1);
         seed48(seed + 1);
-        auto rounds = execution_simulator->simulateNRounds(
-            gpt::total_execution_rounds, planner, gpt::max_turn);
-        Rational avg_cost(0);
+        std::vector<RoundSummary> rounds;
+        if (gpt::simulator_threads > 1
+            && !strcasecmp(gpt::execution_simulator.c_str(), "local"))
+        {
+          // The worker 0 uses the planner (and heuristic) created above and
+          // the other workers get their own copies. The copies start from the
+          // values of the trained (or warm started) planner, so only planners
+          // without a value function are trained again.
+          HeuristicPlanner* heur_planner =
+                                      dynamic_cast<HeuristicPlanner*>(planner);
+          hash_t const* trained_v =
+                        (heur_planner ? heur_planner->valueFunction() : nullptr);
+          std::vector<std::shared_ptr<heuristic_t>> worker_heurs;
+          ParallelLocalSimulator parallel_simulator(ssp,
+              gpt::simulator_threads, gpt::seed + 1);
+          rounds = parallel_simulator.simulateNRounds(
+              gpt::total_execution_rounds,
+              [&](size_t t) -> std::shared_ptr<Planner> {
+                if (t == 0)  // planner is deleted at the end of main
+                  return std::shared_ptr<Planner>(planner, [](Planner*) { });
+                worker_heurs.push_back(createHeuristic(ssp, gpt::heuristic));
+                std::shared_ptr<Planner> p(createPlanner(ssp, gpt::algorithm,
+                                                         *worker_heurs.back()));
+                HeuristicPlanner* worker_heur_planner =
+                                        dynamic_cast<HeuristicPlanner*>(p.get());
+                hash_t* v = (worker_heur_planner ?
+                               worker_heur_planner->valueFunction() : nullptr);
+                if (trained_v && v) {
+                  for (hash_t::const_iterator hi = trained_v->begin();
+                       hi != trained_v->end(); ++hi)
+                  {
+                    if (*hi == NULL) break;  // BUG in hash_t::const_iterator
+                    hashEntry_t* entry = v->find(*(*hi)->state());
+                    if (entry)
+                      entry->update((*hi)->value());
+                    else
+                      v->insert(*(*hi)->state(), (*hi)->value());
+                  }
+                }
+                else if (gpt::train_for_usecs > 0) {
+                  p->trainForUsecs(gpt::train_for_usecs);
+                }
+                return p;
+              },
+              gpt::max_turn);
+        }
+        else {
+          rounds = execution_simulator->simulateNRounds(
+              gpt::total_execution_rounds, planner, gpt::max_turn);
+        }
+        HotRational avg_cost(0);
         for (auto const& r : rounds) {
           avg_cost += r.accumulatedCost;
         }
@@ -704,6 +797,19 @@ int main(int argc, char** argv) {
       std::cout << "V(s0) = " << val_cur << std::endl;
     }
 
+    if (!gpt::save_values_file.empty()) {
+      hash_t* v = (heur_planner ? heur_planner->valueFunction() : nullptr);
+      if (v) {
+        size_t n = saveValueTable(gpt::save_values_file, *v, ssp, *problem);
+        std::cout << "Saved " << n << " values to '"
+                  << gpt::save_values_file << "'" << std::endl;
+      }
+      else {
+        std::cout << "[WARNING] Planner '" << gpt::algorithm << "' has no "
+                  << "value function to save" << std::endl;
+      }
+    }
+
     if (gpt::show_applied_policy || gpt::show_computed_policy) {
       DetPolicy pi;
       if (gpt::show_applied_policy)
@@ -81,8 +81,10 @@ namespace Bellman {
     // using VI/LRTDP/etc over the all outcomes determinization, resulting in
     // another call to qValue.
 #define MAX_DEPTH_Q_VALUE 4
-    static ProbDistState pr_array[MAX_DEPTH_Q_VALUE];
-    static size_t pr_idx = 0;
+    // thread_local so different threads can apply backups concurrently (e.g.,
+    // PlannerTVI)
+    static thread_local ProbDistState pr_array[MAX_DEPTH_Q_VALUE];
+    static thread_local size_t pr_idx = 0;
 #if not defined NDEBUG
     FANCY_DIE_IF(pr_idx >= MAX_DEPTH_Q_VALUE, 171,
         "Max depth of qValue was reached. Increased its value. Current value "
@@ -258,14 +260,14 @@ namespace Bellman {
     double q_value = ssp.cost(s, a).double_value();
 
 #if not defined NDEBUG
-    static bool pr_in_use = false;
+    static thread_local bool pr_in_use = false;
     FANCY_DIE_IF(pr_in_use, 171, "Turns out const qValue can actually be "
         "recursively called too. Need to implement this case for the "
         "ProbDistIface approach");
     pr_in_use = true;
 #endif
 
-    static ProbDistState pr;
+    static thread_local ProbDistState pr;
     ssp.expand(a, s, pr);
     for (auto const& ip : pr) {
       state_t const& s_prime = ip.event();
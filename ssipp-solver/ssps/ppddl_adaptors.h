@@ -20,35 +20,23 @@ class SSPfromPPDDL : public SSPIface {
   bool isGoal(state_t const& s) const override { return p_.goal().holds(s); }
 
   bool hasApplicableActions(state_t const& s) const override {
-    auto range = applicableActions(s);
-    return range.begin() != range.end();
+    return !isGoal(s) && p_.has_applicable_actions(s);
   }
 
   bool isApplicable(state_t const& s, action_t const& a) const override {
     return !isGoal(s) && a.enabled(s);
   }
 
-  class MgptActionTIteratorWrapper {
-   public:
-    MgptActionTIteratorWrapper(actionList_t::const_iterator it) : it_(it) { }
-    MgptActionTIteratorWrapper& operator++() { ++it_; return *this; }
-    bool operator!=(MgptActionTIteratorWrapper const& rhs) const {
-      return it_ != rhs.it_;
-    }
-    action_t const& operator*() const { assert(*it_); return **it_; }
-   private:
-    actionList_t::const_iterator it_;
-  };
-
   ActionConstRange applicableActions(state_t const& s) const override {
-    // Returning an instance of **ApplicableActionIterator**, therefore, the
-    // iterator will take care of checking if the actions are applicable or
-    // not.
+    // A(s) is computed upfront by the successor generator of the problem
+    // (see problem_t::applicable_actions), therefore there is no need to use
+    // ApplicableActionIterator to check each action.
+    if (isGoal(s))
+      return ActionConstRange();
+    std::shared_ptr<actionList_t> applicable = unusedActionList();
+    p_.applicable_actions(s, *applicable);
     ActionConstIteIfaceUniqPtr begin(
-        new ApplicableActionIterator<MgptActionTIteratorWrapper>(
-          MgptActionTIteratorWrapper(p_.actionsT_.begin()),
-          MgptActionTIteratorWrapper(p_.actionsT_.end()),
-                                         *this, s));
+        new ActionPtrVectorConstIte(std::move(applicable)));
     return ActionConstRange(std::move(begin), nullptr);
   }
 
@@ -72,11 +60,13 @@ class SSPfromPPDDL : public SSPIface {
     p_.expand(a, s, pr);
   }
 
-  Rational cost(state_t const& s, action_t const& a) const override {
-    return a.cost(s);
+  // Uses the values precomputed by problem_t::flatten (see
+  // action_t::precompute_hot_values)
+  HotRational cost(state_t const& s, action_t const& a) const override {
+    return a.hot_cost(s);
   }
 
-  Rational terminalCost(state_t const& s) const override {
+  HotRational terminalCost(state_t const& s) const override {
     return p_.terminalCost(s);
   }
 
@@ -85,6 +75,27 @@ class SSPfromPPDDL : public SSPIface {
   }
 
  private:
+  /*
+   * Returns a list that no iterator returned by applicableActions refers to
+   * anymore. The lists (and their capacity) are reused, so computing A(s)
+   * does not allocate memory once there is a list for every range that is
+   * alive at the same time (usually one per thread). At most
+   * MAX_POOLED_ACTION_LISTS lists are kept per thread; if more ranges are
+   * alive at the same time, then the extra lists are freed with their range.
+   */
+  static std::shared_ptr<actionList_t> unusedActionList() {
+    static thread_local std::vector<std::shared_ptr<actionList_t>> lists;
+    for (std::shared_ptr<actionList_t> const& list : lists) {
+      if (list.use_count() == 1)
+        return list;
+    }
+    if (lists.size() >= MAX_POOLED_ACTION_LISTS)
+      return std::make_shared<actionList_t>();
+    lists.push_back(std::make_shared<actionList_t>());
+    return lists.back();
+  }
+  static size_t const MAX_POOLED_ACTION_LISTS = 8;
+
   problem_t const& p_;
 };
 
@@ -11,6 +11,7 @@
 #include "short_sighted_ssps.h"
 #include "prob_dist_state.h"
 #include "bellman.h"
+#include "../utils/parallel.h"
 
 
 /*
@@ -19,9 +20,13 @@
 // static
 std::unique_ptr<ShortSightedSSP> ShortSightedSSP::newMaxDepth(SSPIface const& ssp,
     state_t const& s, hash_t& fringe_heuristic, size_t max_depth,
-    size_t max_space_size, uint64_t max_cpu_time_usec)
+    size_t max_space_size, uint64_t max_cpu_time_usec, size_t n_threads)
 {
-  static ProbDistState pr;
+  if (n_threads > 1 && max_space_size == 0 && max_cpu_time_usec == 0) {
+    return newMaxDepthParallel(ssp, s, fringe_heuristic, max_depth, n_threads);
+  }
+
+  static thread_local ProbDistState pr;
 
   // S4P: Short-Sighted SSP
   std::unique_ptr<ShortSightedSSP> s4p(new ShortSightedSSP(ssp, s,
@@ -171,8 +176,14 @@ std::unique_ptr<ShortSightedSSP> ShortSightedSSP::newMaxDepth(SSPIface const& ss
 //static
 std::unique_ptr<ShortSightedSSP> ShortSightedSSP::newTrajectoryBased(
     SSPIface const& ssp, state_t const& s, hash_t& fringe_heuristic,
-    Rational min_p, size_t max_space_size, uint64_t max_cpu_time_usec)
+    Rational min_p, size_t max_space_size, uint64_t max_cpu_time_usec,
+    size_t n_threads)
 {
+  if (n_threads > 1 && max_space_size == 0 && max_cpu_time_usec == 0) {
+    return newTrajectoryBasedParallel(ssp, s, fringe_heuristic, min_p,
+                                      n_threads);
+  }
+
   /****************************************************************************
    *
    * Data structure used only by this method so far. Move it out if any other
@@ -202,7 +213,7 @@ std::unique_ptr<ShortSightedSSP> ShortSightedSSP::newTrajectoryBased(
   };
   /***************************************************************************/
 
-  static ProbDistState pr;
+  static thread_local ProbDistState pr;
 
   // S4P: Short-Sighted SSP
   std::unique_ptr<ShortSightedSSP> s4p(new ShortSightedSSP(ssp, s,
@@ -471,6 +482,235 @@ std::unique_ptr<ShortSightedSSP> ShortSightedSSP::newTrajectoryBased(
 
 
 
+/*
+ * PARALLEL MAX-DEPTH
+ */
+//static
+std::unique_ptr<ShortSightedSSP> ShortSightedSSP::newMaxDepthParallel(
+    SSPIface const& ssp, state_t const& s, hash_t& fringe_heuristic,
+    size_t max_depth, size_t n_threads)
+{
+  // (index of the parent in the level, index of the successor of the parent)
+  using Position = std::pair<size_t, size_t>;
+
+  std::unique_ptr<ShortSightedSSP> s4p(new ShortSightedSSP(ssp, s,
+                                              fringe_heuristic, "Depth S4P"));
+  std::vector<ProbDistState> pr(n_threads);
+  ConcurrentHashMapState<Position> new_states;
+  std::vector<std::pair<state_t, Position>> next_level;
+
+  size_t fringe = 0;
+  size_t loop_counter = 0;
+  /*
+   * Invariant: every state in level is in s4p, is not marked as fringe and
+   * has depth d. All the states with depth <= d are in s4p.
+   */
+  std::vector<state_t> level(1, s);
+  s4p->insertState(s);
+  for (size_t d = 0; !level.empty(); ++d) {
+    gpt::checkDeadline();
+    if (d == max_depth) {
+      for (state_t const& cur_s : level) {
+        s4p->setAsFringe(cur_s);
+        fringe++;
+      }
+      break;
+    }
+
+    std::vector<char> is_goal(level.size(), 0);
+    parallelFor(level.size(), n_threads, [&](size_t t, size_t i) {
+      if (t == 0)
+        gpt::incCounterAndCheckDeadlineEvery(loop_counter, 10000);
+      state_t const& cur_s = level[i];
+      if (ssp.isGoal(cur_s)) {
+        is_goal[i] = 1;
+        return;
+      }
+      size_t k = 0;
+      for (action_t const& a : ssp.applicableActions(cur_s)) {
+        ssp.expand(a, cur_s, pr[t]);
+        for (auto const& ip : pr[t]) {
+          Position const pos(i, k++);
+          // s4p is not modified while the level is expanded
+          if (s4p->isDefinedFor(ip.event()))
+            continue;
+          new_states.update(ip.event(), [&pos](Position& p, bool inserted) {
+            if (inserted || pos < p) p = pos;
+          });
+        }
+      }
+    });
+
+    for (size_t i = 0; i < level.size(); ++i) {
+      if (is_goal[i]) {
+        s4p->setAsFringe(level[i]);
+        fringe++;
+      }
+    }
+    next_level.clear();
+    new_states.drain(next_level);
+    std::sort(next_level.begin(), next_level.end(),
+        [](std::pair<state_t, Position> const& a,
+           std::pair<state_t, Position> const& b)
+        {
+          return a.second < b.second;
+        });
+    level.clear();
+    for (auto const& it : next_level) {
+      s4p->insertState(it.first);
+      level.push_back(it.first);
+    }
+  }
+
+  DEBUG_MSG("shortSightedSpaceSize",
+      "[MaxDepthParallel]: space size %d / goal set size %d",
+      s4p->totalStates(), fringe);
+  return s4p;
+}
+
+
+
+/*
+ * PARALLEL TRAJECTORY-BASED
+ *
+ * Label-correcting version of newTrajectoryBased: instead of expanding the
+ * open state with highest trace probability first, all open states are
+ * expanded in parallel at each round and a state is reopened whenever a
+ * trajectory with more probability (and at least min_p) to it is found. The
+ * trace probability of the states converges to P_max(s,.) and the fixed point
+ * is the same S4P generated by newTrajectoryBased; some states might be
+ * expanded more than once though.
+ */
+//static
+std::unique_ptr<ShortSightedSSP> ShortSightedSSP::newTrajectoryBasedParallel(
+    SSPIface const& ssp, state_t const& s, hash_t& fringe_heuristic,
+    Rational min_p, size_t n_threads)
+{
+  using Position = std::pair<size_t, size_t>;
+  // Best trace probability found for a successor in the current round and the
+  // first position in which it was generated
+  struct Successor {
+    Successor() : p(0) { }
+    Rational p;
+    Position pos;
+  };
+  // Same as StateInfo in newTrajectoryBased
+  struct StateInfo {
+    StateInfo() : open(false), p(0) { }
+    StateInfo(bool o, Rational r) : open(o), p(r) { }
+    bool open;
+    Rational p;
+  };
+
+  std::unique_ptr<ShortSightedSSP> s4p(new ShortSightedSSP(ssp, s,
+                                    fringe_heuristic, "Trajectory-based S4P"));
+  std::vector<ProbDistState> pr(n_threads);
+  ConcurrentHashMapState<Successor> successors;
+  std::vector<std::pair<state_t, Successor>> merged;
+  HashMapState<StateInfo> explored_space;
+
+  size_t fringe = 0;
+  size_t loop_counter = 0;
+  /*
+   * Invariant: every state in level is in s4p and explored_space, is open,
+   * is not marked as fringe and its trace probability is at least min_p.
+   */
+  std::vector<state_t> level(1, s);
+  s4p->insertState(s);
+  explored_space[s] = StateInfo(true, Rational(1));
+  while (!level.empty()) {
+    gpt::checkDeadline();
+
+    std::vector<char> is_goal(level.size(), 0);
+    parallelFor(level.size(), n_threads, [&](size_t t, size_t i) {
+      if (t == 0)
+        gpt::incCounterAndCheckDeadlineEvery(loop_counter, 10000);
+      state_t const& cur_s = level[i];
+      if (ssp.isGoal(cur_s)) {
+        is_goal[i] = 1;
+        return;
+      }
+      // explored_space is not modified while the level is expanded
+      Rational const cur_trace_p = explored_space.find(cur_s)->second.p;
+      size_t k = 0;
+      for (action_t const& a : ssp.applicableActions(cur_s)) {
+        ssp.expand(a, cur_s, pr[t]);
+        for (auto const& ip : pr[t]) {
+          Position const pos(i, k++);
+          Rational const p(cur_trace_p * Rational(ip.prob()));
+          auto it = explored_space.find(ip.event());
+          if (it != explored_space.end()
+              && (p < min_p || p <= it->second.p))
+          {
+            continue;  // nothing new about this successor
+          }
+          successors.update(ip.event(), [&](Successor& succ, bool inserted) {
+            if (inserted || pos < succ.pos) succ.pos = pos;
+            if (inserted || succ.p < p) succ.p = p;
+          });
+        }
+      }
+    });
+
+    // The states of level are closed before the successors are merged, so a
+    // state of level that is reached again with more probability is reopened
+    for (size_t i = 0; i < level.size(); ++i) {
+      explored_space[level[i]].open = false;
+      if (is_goal[i]) {
+        s4p->setAsFringe(level[i]);
+        fringe++;
+      }
+    }
+
+    merged.clear();
+    successors.drain(merged);
+    std::sort(merged.begin(), merged.end(),
+        [](std::pair<state_t, Successor> const& a,
+           std::pair<state_t, Successor> const& b)
+        {
+          return a.second.pos < b.second.pos;
+        });
+    level.clear();
+    for (auto const& it : merged) {
+      state_t const& next_s = it.first;
+      Rational const& p = it.second.p;
+      if (s4p->insertState(next_s)) {
+        explored_space[next_s] = StateInfo(false, p);
+        if (ssp.isGoal(next_s) || p < min_p) {
+          fringe++;
+          s4p->setAsFringe(next_s);
+        }
+        else {
+          explored_space[next_s].open = true;
+          level.push_back(next_s);
+        }
+      }
+      else if (!ssp.isGoal(next_s)) {
+        // The filter in the expansion guarantees p >= min_p and p is larger
+        // than the previous trace probability of next_s
+        StateInfo& info = explored_space[next_s];
+        DIE(p >= min_p && p > info.p, "Unexpected trace probability", -1);
+        info.p = p;
+        if (!info.open) {
+          info.open = true;
+          if (s4p->isGoal(next_s)) {
+            fringe--;
+            s4p->setAsInternal(next_s);
+          }
+          level.push_back(next_s);
+        }
+      }
+    }
+  }
+
+  DEBUG_MSG("shortSightedSpaceSize",
+      "[TrajectoryBasedParallel]: space size %d / goal set size %d",
+      s4p->totalStates(), fringe);
+  return s4p;
+}
+
+
+
 /*
 * GREEDY NAMED CONSTRUCTOR
 */
@@ -481,7 +721,7 @@ std::unique_ptr<ShortSightedSSP> ShortSightedSSP::newGreedy(
 {
   assert(max_space_size > 0);
 
-  static ProbDistState pr;
+  static thread_local ProbDistState pr;
 
   // S4P: Short-Sighted SSP
   std::unique_ptr<ShortSightedSSP> s4p(new ShortSightedSSP(ssp, s,
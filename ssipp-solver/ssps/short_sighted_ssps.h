@@ -110,16 +110,16 @@ class ShortSightedSSP : public SSPIface {
   }
 
   // Cost of actions are NOT changed
-  Rational cost(state_t const& s, action_t const& a) const {
+  HotRational cost(state_t const& s, action_t const& a) const {
     return ssp_.cost(s,a);
   }
 
-  Rational terminalCost(state_t const& s) const {
+  HotRational terminalCost(state_t const& s) const {
     DIE(isGoal(s), "Expecting Goal state", 171);
     if (ssp_.isGoal(s)) {
       return ssp_.terminalCost(s);
     }
-    return Rational(v_.value(s));
+    return HotRational(v_.value(s));
   }
 
   StateConstRange reachableStates() const {
@@ -141,10 +141,15 @@ class ShortSightedSSP : public SSPIface {
    * Defined in AIJ'14: http://felipe.trevizan.org/papers/trevizan14:depth.pdf
    * 
    * Generate the space of all states reachable using up to max_depth actions.
+   *
+   * If n_threads > 1 and there is no size and time limit, then each depth is
+   * expanded in parallel (see newMaxDepthParallel). The generated SSP is the
+   * same regardless of n_threads.
    */
   static std::unique_ptr<ShortSightedSSP> newMaxDepth(SSPIface const& ssp,
       state_t const& s, hash_t& fringe_heuristic, size_t max_depth,
-      size_t max_space_size = 0, uint64_t max_cpu_time_usec = 0);
+      size_t max_space_size = 0, uint64_t max_cpu_time_usec = 0,
+      size_t n_threads = gpt::s4p_threads);
 
 
   /* 
@@ -170,10 +175,15 @@ class ShortSightedSSP : public SSPIface {
    * for expansion will be added to the short-sighted SSP as artificial goals.
    * The total amount of extra states added depends on the branching factor of
    * the original SSP.
+   *
+   * If n_threads > 1 and there is no size and time limit, then the states are
+   * expanded in parallel rounds (see newTrajectoryBasedParallel). The
+   * generated SSP is the same regardless of n_threads.
    */
   static std::unique_ptr<ShortSightedSSP> newTrajectoryBased(SSPIface const& ssp,
       state_t const& s, hash_t& fringe_heuristic, Rational min_p,
-      size_t max_space_size = 0, uint64_t max_cpu_time_usec = 0);
+      size_t max_space_size = 0, uint64_t max_cpu_time_usec = 0,
+      size_t n_threads = gpt::s4p_threads);
 
 
   /*
@@ -225,6 +235,25 @@ class ShortSightedSSP : public SSPIface {
 
   size_t totalStates() const { return ss_hash_.size(); }
 
+  /*
+   * Parallel versions of newMaxDepth and newTrajectoryBased without size and
+   * time limits. Both are level synchronous: the states of the current level
+   * are expanded by n_threads threads while ss_hash_ is only read, and the new
+   * states are collected in a ConcurrentHashMapState together with the
+   * position (index of the parent in the level, index of the successor) in
+   * which they were first generated. The new states are then added to
+   * ss_hash_ by a single thread sorted by this position, i.e., in the order
+   * they would be found by expanding the level sequentially, so the result
+   * does not depend on the scheduling of the threads.
+   */
+  static std::unique_ptr<ShortSightedSSP> newMaxDepthParallel(
+      SSPIface const& ssp, state_t const& s, hash_t& fringe_heuristic,
+      size_t max_depth, size_t n_threads);
+
+  static std::unique_ptr<ShortSightedSSP> newTrajectoryBasedParallel(
+      SSPIface const& ssp, state_t const& s, hash_t& fringe_heuristic,
+      Rational min_p, size_t n_threads);
+
   // Debug function that checks if the current short-sighted SSP meets all the
   // sufficient conditions given in the NIPS'12 paper (definition 5).
   bool satisfiesSufficientConditions() const;
@@ -112,14 +112,14 @@ class SSPAdaptor : public SSPIface {
     ssp_.expand(a, s, pr);
   }
 
-  Rational cost(state_t const& s, action_t const& a) const override {
-    Rational c = cost_(s,a);
-    return (c > Rational(0) ? c : ssp_.cost(s,a));
+  HotRational cost(state_t const& s, action_t const& a) const override {
+    HotRational c = cost_(s,a);
+    return (c > HotRational(0) ? c : ssp_.cost(s,a));
   }
 
-  Rational terminalCost(state_t const& s) const override {
-    Rational c = terminal_cost_(s);
-    return (c >= Rational(0) ? c : ssp_.terminalCost(s));
+  HotRational terminalCost(state_t const& s) const override {
+    HotRational c = terminal_cost_(s);
+    return (c >= HotRational(0) ? c : ssp_.terminalCost(s));
   }
 
   StateConstRange reachableStates() const override {
@@ -201,13 +201,13 @@ class SameApplicableActions {
 };
 class SameActionCost {
  public:
-  Rational operator()(state_t const&, action_t const&) const {
-    return Rational(-1);
+  HotRational operator()(state_t const&, action_t const&) const {
+    return HotRational(-1);
   }
 };
 class SameTerminalCost {
  public:
-  Rational operator()(state_t const&) const { return Rational(-1); }
+  HotRational operator()(state_t const&) const { return HotRational(-1); }
 };
 class OnDemandReachableStates {
  public:
@@ -321,14 +321,14 @@ class TerminalCostFromHash {
 class TerminalCostFromV {
  public:
   TerminalCostFromV(hash_t const& v) : v_(v) { }
-  Rational operator()(state_t const& s) const {
+  HotRational operator()(state_t const& s) const {
     hashEntry_t* it = v_.find(s);
     if (it) {
       assert(it->value() >= 0);
-      return Rational(it->value());
+      return HotRational(it->value());
     }
     // s is not defined in v_, so forwarding the request to the original SSP
-    return Rational(-1);
+    return HotRational(-1);
   }
  private:
   hash_t const& v_;
@@ -3,6 +3,7 @@
 
 #include <iostream>
 #include <memory>
+#include <vector>
 
 #include "../ext/mgpt/rational.h"
 #include "prob_dist_state.h"
@@ -83,11 +84,13 @@ class SSPIface {
   virtual void expand(action_t const& action, state_t const& state,
                       ProbDistStateIface& pr) const = 0;
 
-  // Returns the cost of the action, i.e., the cost being optimized.
-  virtual Rational cost(state_t const& s, action_t const& a) const = 0;
+  // Returns the cost of the action, i.e., the cost being optimized. Costs are
+  // returned as HotRational since this is called for every Q-value computation
+  // (see rational.h).
+  virtual HotRational cost(state_t const& s, action_t const& a) const = 0;
 
   // Returns C_t(s). C_t(s) must be greater or EQUAL to 0.
-  virtual Rational terminalCost(state_t const& s) const = 0;
+  virtual HotRational terminalCost(state_t const& s) const = 0;
 
   /*
    * Generate a hash set with all the reachable states from s0.
@@ -205,6 +208,49 @@ StateConstRange wrappedReachableStates(SSPIface const& ssp, state_t const& s) {
 }
 
 
+/*
+ * Iterator over a pre-computed vector of actions, e.g., the set A(s) computed
+ * by a successor generator. The vector is shared between the clones of the
+ * iterator and deallocated when all of them are deallocated.
+ */
+class ActionPtrVectorConstIte : public ActionConstIteIface {
+ public:
+  ActionPtrVectorConstIte(
+      std::shared_ptr<std::vector<action_t const*> const> actions)
+    : actions_(std::move(actions)), idx_(0)
+  { }
+
+  ActionPtrVectorConstIte& operator++() { ++idx_; return *this; }
+
+  bool operator!=(ActionConstIteIfaceUniqPtr const& rhs) const {
+    // Hack for efficiency: nullptr represents the end of the range
+    if (!rhs)  return idx_ < actions_->size();
+
+    ActionPtrVectorConstIte const* conv_rhs =
+                      dynamic_cast<ActionPtrVectorConstIte const*>(rhs.get());
+    if (conv_rhs) {
+      assert(actions_ == conv_rhs->actions_);
+      return idx_ != conv_rhs->idx_;
+    }
+    else {
+      return true;
+    }
+  }
+
+  action_t const& operator*() const { return *(*actions_)[idx_]; }
+
+  ActionConstIteIfaceUniqPtr clone() const {
+    ActionPtrVectorConstIte* it = new ActionPtrVectorConstIte(actions_);
+    it->idx_ = idx_;
+    return ActionConstIteIfaceUniqPtr(it);
+  }
+
+ private:
+  std::shared_ptr<std::vector<action_t const*> const> actions_;
+  size_t idx_;
+};
+
+
 /*
  * Template that implements the iterator over applicable actions of s.
  *
@@ -6,6 +6,9 @@
 #include <unordered_set>
 #include <unordered_map>
 #include <cassert>
+#include <memory>
+#include <mutex>
+#include <vector>
 
 #include "../ext/mgpt/atom_states.h"  // to be able to define the hashes
 
@@ -27,6 +30,50 @@ using HashStateToActiontPtrs = HashMapState<HashsetActiontPtr>;
 
 using ListOfStates = std::list<state_t>;
 
+
+/*
+ * Hash map from state to T that can be updated concurrently. The map is split
+ * in n_shards HashMapState (selected by state_t::hash64), each one protected
+ * by its own mutex. There is no concurrent lookup: the content is obtained by
+ * drain once all the writers are done.
+ */
+template<typename T>
+class ConcurrentHashMapState {
+ public:
+  explicit ConcurrentHashMapState(size_t n_shards = 64)
+    : n_shards_(n_shards), shards_(new Shard[n_shards])
+  { }
+
+  // Calls f(value, inserted) while holding the lock of the shard of s, where
+  // value is the T associated with s and inserted is true if s was not in the
+  // map (in this case value was default constructed).
+  template<typename F>
+  void update(state_t const& s, F&& f) {
+    Shard& shard = shards_[s.hash64() % n_shards_];
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    auto ins = shard.map.emplace(s, T());
+    f(ins.first->second, ins.second);
+  }
+
+  // Appends all the (state, T) pairs to out in an unspecified order and
+  // empties the map. Must not be called concurrently with update.
+  void drain(std::vector<std::pair<state_t, T>>& out) {
+    for (size_t i = 0; i < n_shards_; ++i) {
+      for (auto& it : shards_[i].map)
+        out.emplace_back(it.first, std::move(it.second));
+      shards_[i].map.clear();
+    }
+  }
+
+ private:
+  struct Shard {
+    std::mutex mutex;
+    HashMapState<T> map;
+  };
+  size_t const n_shards_;
+  std::unique_ptr<Shard[]> shards_;
+};
+
 using HashActiontPtrToRational = std::unordered_map<action_t const*, Rational>;
 // Hash Map from (s,a) to Rational: hashm[s][a] = Rational(x);
 using HashStateActionToRational = HashMapState<HashActiontPtrToRational>;
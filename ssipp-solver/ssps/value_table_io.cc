@@ -0,0 +1,245 @@
+#include <algorithm>
+#include <cstring>
+#include <fcntl.h>
+#include <fstream>
+#include <stdexcept>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <unordered_map>
+
+#include "value_table_io.h"
+#include "bellman.h"
+
+
+namespace {
+char const VALUE_TABLE_MAGIC[8] = {'S', 'S', 'I', 'P', 'P', 'V', 'T', '\0'};
+uint32_t const VALUE_TABLE_VERSION = 1;
+
+uint64_t alignTo(uint64_t offset, uint64_t alignment) {
+  return (offset + alignment - 1) / alignment * alignment;
+}
+
+// Returns true if count elements of size bytes starting at offset are inside
+// a file of length bytes and offset is a multiple of alignment
+bool sectionFits(uint64_t offset, uint64_t count, uint64_t size,
+                 uint64_t alignment, uint64_t length)
+{
+  return offset % alignment == 0 && offset <= length
+           && count <= (length - offset) / size;
+}
+
+// Lexicographic order over the words of packed states
+bool wordsLess(unsigned const* a, unsigned const* b, size_t n) {
+  return std::lexicographical_compare(a, a + n, b, b + n);
+}
+}  // namespace
+
+
+/*******************************************************************************
+ *
+ * saveValueTable
+ *
+ ******************************************************************************/
+
+size_t saveValueTable(std::string const& path, hash_t const& v,
+                      SSPIface const& ssp, problem_t const& problem)
+{
+  size_t const words = state_t::size();
+
+  std::vector<hashEntry_t const*> entries;
+  for (hash_t::const_iterator hi = v.begin(); hi != v.end(); ++hi) {
+    if (*hi == NULL) break;  // BUG in the hash_t::const_iterator
+    entries.push_back(*hi);
+  }
+  std::sort(entries.begin(), entries.end(),
+      [words](hashEntry_t const* a, hashEntry_t const* b) {
+        return wordsLess(a->state()->data(), b->state()->data(), words);
+      });
+
+  std::unordered_map<action_t const*, int32_t> action_idx;
+  std::string names;
+  for (action_t const* a : problem.actionsT()) {
+    int32_t idx = action_idx.size();
+    action_idx[a] = idx;
+    names += a->name();
+    names.push_back('\0');
+  }
+
+  ValueTableHeader header;
+  memset(&header, 0, sizeof(header));
+  memcpy(header.magic, VALUE_TABLE_MAGIC, sizeof(header.magic));
+  header.version = VALUE_TABLE_VERSION;
+  header.state_words = words;
+  header.n_entries = entries.size();
+  header.n_actions = problem.actionsT().size();
+  header.actions_offset = sizeof(ValueTableHeader);
+  header.states_offset = alignTo(header.actions_offset + names.size(),
+                                 sizeof(unsigned));
+  header.policy_offset = header.states_offset
+                           + entries.size() * words * sizeof(unsigned);
+  header.values_offset = alignTo(header.policy_offset
+                                   + entries.size() * sizeof(int32_t),
+                                 sizeof(double));
+  header.file_size = header.values_offset + entries.size() * sizeof(double);
+
+  std::vector<int32_t> policy(entries.size(), -1);
+  std::vector<double> values(entries.size());
+  for (size_t i = 0; i < entries.size(); ++i) {
+    state_t const& s = *entries[i]->state();
+    values[i] = entries[i]->value();
+    action_t const* a = Bellman::constGreedyAction(s, v, ssp);
+    auto it = (a ? action_idx.find(a) : action_idx.end());
+    if (it != action_idx.end())
+      policy[i] = it->second;
+  }
+
+  std::ofstream out(path, std::ios::binary | std::ios::trunc);
+  if (!out)
+    throw std::runtime_error("Cannot open '" + path + "' for writing");
+  static char const PADDING[8] = {0};
+  out.write((char const*) &header, sizeof(header));
+  out.write(names.data(), names.size());
+  out.write(PADDING, header.states_offset - header.actions_offset
+                       - names.size());
+  for (hashEntry_t const* e : entries) {
+    out.write((char const*) e->state()->data(), words * sizeof(unsigned));
+  }
+  out.write((char const*) policy.data(), policy.size() * sizeof(int32_t));
+  out.write(PADDING, header.values_offset - header.policy_offset
+                       - policy.size() * sizeof(int32_t));
+  out.write((char const*) values.data(), values.size() * sizeof(double));
+  out.close();
+  if (!out)
+    throw std::runtime_error("Error writing the value table '" + path + "'");
+  return entries.size();
+}
+
+
+
+/*******************************************************************************
+ *
+ * MappedValueTable
+ *
+ ******************************************************************************/
+
+MappedValueTable::MappedValueTable(std::string const& path,
+    problem_t const& problem)
+  : data_(nullptr), length_(0)
+{
+  int fd = open(path.c_str(), O_RDONLY);
+  if (fd < 0)
+    throw std::runtime_error("Cannot open the value table '" + path + "'");
+  struct stat st;
+  if (fstat(fd, &st) != 0 || (size_t) st.st_size < sizeof(ValueTableHeader)) {
+    close(fd);
+    throw std::runtime_error("'" + path + "' is not a value table");
+  }
+  length_ = st.st_size;
+  data_ = mmap(nullptr, length_, PROT_READ, MAP_SHARED, fd, 0);
+  close(fd);
+  if (data_ == MAP_FAILED) {
+    data_ = nullptr;
+    throw std::runtime_error("Cannot mmap the value table '" + path + "'");
+  }
+
+  char const* base = (char const*) data_;
+  header_ = (ValueTableHeader const*) base;
+  std::string error;
+  if (memcmp(header_->magic, VALUE_TABLE_MAGIC, sizeof(header_->magic)) != 0
+      || header_->version != VALUE_TABLE_VERSION)
+  {
+    error = "'" + path + "' is not a value table (or has a different version)";
+  }
+  else if (header_->file_size != length_) {
+    error = "'" + path + "' is truncated";
+  }
+  else if (header_->state_words != state_t::size()) {
+    error = "'" + path + "' was written for a different problem";
+  }
+  else if (!sectionFits(header_->actions_offset, 0, 1, 1, length_)
+      || !sectionFits(header_->states_offset, header_->n_entries,
+                      header_->state_words * sizeof(unsigned),
+                      sizeof(unsigned), length_)
+      || !sectionFits(header_->policy_offset, header_->n_entries,
+                      sizeof(int32_t), sizeof(int32_t), length_)
+      || !sectionFits(header_->values_offset, header_->n_entries,
+                      sizeof(double), sizeof(double), length_))
+  {
+    error = "'" + path + "' is corrupted (invalid section offsets)";
+  }
+  else {
+    states_ = (unsigned const*) (base + header_->states_offset);
+    policy_ = (int32_t const*) (base + header_->policy_offset);
+    values_ = (double const*) (base + header_->values_offset);
+    char const* name = base + header_->actions_offset;
+    char const* end = base + length_;
+    for (size_t i = 0; i < header_->n_actions; ++i) {
+      char const* name_end = (char const*) memchr(name, '\0', end - name);
+      if (!name_end) {
+        error = "'" + path + "' is corrupted (invalid action names)";
+        break;
+      }
+      actions_.push_back(problem.find_action(name));
+      name = name_end + 1;
+    }
+    for (size_t i = 0; error.empty() && i < size(); ++i) {
+      if (policy_[i] < -1 || policy_[i] >= (int64_t) header_->n_actions)
+        error = "'" + path + "' is corrupted (invalid policy)";
+    }
+  }
+  if (!error.empty()) {
+    munmap(data_, length_);
+    throw std::runtime_error(error);
+  }
+}
+
+
+MappedValueTable::~MappedValueTable() {
+  if (data_)
+    munmap(data_, length_);
+}
+
+
+state_t MappedValueTable::state(size_t i) const {
+  state_t s;
+  memcpy(s.mutable_data(), stateWords(i),
+         header_->state_words * sizeof(unsigned));
+  return s;
+}
+
+
+size_t MappedValueTable::find(state_t const& s) const {
+  size_t const words = header_->state_words;
+  size_t lo = 0;
+  size_t hi = size();
+  while (lo < hi) {
+    size_t mid = lo + (hi - lo) / 2;
+    if (wordsLess(stateWords(mid), s.data(), words))
+      lo = mid + 1;
+    else
+      hi = mid;
+  }
+  if (lo < size() && memcmp(stateWords(lo), s.data(),
+                            words * sizeof(unsigned)) == 0)
+  {
+    return lo;
+  }
+  return NOT_FOUND;
+}
+
+
+size_t MappedValueTable::loadInto(hash_t& v) const {
+  // Entries are read in order, so the kernel can read ahead
+  madvise(data_, length_, MADV_SEQUENTIAL);
+  for (size_t i = 0; i < size(); ++i) {
+    state_t const s = state(i);
+    hashEntry_t* entry = v.find(s);
+    if (entry)
+      entry->update(values_[i]);
+    else
+      v.insert(s, values_[i]);
+  }
+  madvise(data_, length_, MADV_NORMAL);
+  return size();
+}
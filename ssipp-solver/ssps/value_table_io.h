@@ -0,0 +1,111 @@
+#ifndef VALUE_TABLE_IO_H
+#define VALUE_TABLE_IO_H
+
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+#include "../ext/mgpt/actions.h"
+#include "../ext/mgpt/hash.h"
+#include "../ext/mgpt/problems.h"
+#include "../ext/mgpt/states.h"
+#include "ssp_iface.h"
+
+/*******************************************************************************
+ *
+ * Binary value table
+ *
+ * Compact dump of a value function (hash_t) and of its greedy policy, so an
+ * expensive solve (e.g., LRTDP) can be reused to warm start another solve or
+ * shared by several processes (e.g., ASNets workers) through mmap. The file
+ * has the following sections, all in the native byte order:
+ *
+ *   ValueTableHeader
+ *   action names:  n_actions '\0'-terminated strings (problem_t::actionsT
+ *                  order of the solver that wrote the file)
+ *   states:        n_entries packed states, i.e., the state_t::size() words
+ *                  of each state, sorted in lexicographic order of the words
+ *   policy:        n_entries int32_t, index of the greedy action in the
+ *                  action names (-1 for goals and dead ends)
+ *   values:        n_entries doubles (8-byte aligned)
+ *
+ * Actions are stored by name since the order of problem_t::actionsT depends
+ * on the seed (see gpt::randomize_actionsT_order). Files can only be read by
+ * a solver with the same state_t::size(), i.e., the same problem.
+ *
+ ******************************************************************************/
+
+struct ValueTableHeader {
+  char magic[8];
+  uint32_t version;
+  uint32_t state_words;
+  uint64_t n_entries;
+  uint64_t n_actions;
+  // Offsets (in bytes) from the beginning of the file
+  uint64_t actions_offset;
+  uint64_t states_offset;
+  uint64_t policy_offset;
+  uint64_t values_offset;
+  uint64_t file_size;
+};
+
+
+/*
+ * Writes all the entries of v and the greedy action of each entry w.r.t. v
+ * (see Bellman::constGreedyAction) to path. Returns the number of entries
+ * written and throws std::runtime_error if the file cannot be written.
+ */
+size_t saveValueTable(std::string const& path, hash_t const& v,
+                      SSPIface const& ssp, problem_t const& problem);
+
+
+/*
+ * Read-only view of a file written by saveValueTable. The file is mapped
+ * (mmap with MAP_SHARED), so the pages are only read when accessed and are
+ * shared by all the processes mapping the same file. Throws
+ * std::runtime_error if the file cannot be mapped or is not compatible with
+ * the current problem.
+ */
+class MappedValueTable {
+ public:
+  static size_t const NOT_FOUND = (size_t) -1;
+
+  MappedValueTable(std::string const& path, problem_t const& problem);
+  ~MappedValueTable();
+
+  MappedValueTable(MappedValueTable const&) = delete;
+  MappedValueTable& operator=(MappedValueTable const&) = delete;
+
+  size_t size() const { return header_->n_entries; }
+
+  state_t state(size_t i) const;
+  double value(size_t i) const { return values_[i]; }
+  // Greedy action of the i-th entry (nullptr if there is none or if the
+  // action is not part of problem)
+  action_t const* action(size_t i) const {
+    int32_t a = policy_[i];
+    return (a < 0 ? nullptr : actions_[a]);
+  }
+
+  // Index of s in the table (binary search) or NOT_FOUND
+  size_t find(state_t const& s) const;
+
+  // Copies all the values to v, overwriting the ones already there, without
+  // calling the heuristic of v. Returns the number of entries copied.
+  size_t loadInto(hash_t& v) const;
+
+ private:
+  unsigned const* stateWords(size_t i) const {
+    return states_ + i * header_->state_words;
+  }
+
+  void* data_;
+  size_t length_;
+  ValueTableHeader const* header_;
+  unsigned const* states_;
+  int32_t const* policy_;
+  double const* values_;
+  std::vector<action_t const*> actions_;
+};
+
+#endif  // VALUE_TABLE_IO_H
@@ -0,0 +1,56 @@
+#ifndef PARALLEL_H
+#define PARALLEL_H
+
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <thread>
+#include <vector>
+
+/*
+ * Calls f(t, i) for every i in [0, n) using up to n_threads threads, where t in
+ * [0, n_threads) is the index of the thread calling f (so f can use per thread
+ * data without locking). Indices are handed out one at a time, so an expensive
+ * item does not stall the other threads, and the caller thread is used as
+ * thread 0. If n_threads <= 1 or n <= 1, then everything runs in the caller
+ * thread in increasing order of i.
+ *
+ * If f throws, then the remaining items are skipped and the first exception
+ * (in order of t) is rethrown after all the threads joined.
+ */
+template<typename F>
+void parallelFor(size_t n, size_t n_threads, F&& f) {
+  if (n_threads <= 1 || n <= 1) {
+    for (size_t i = 0; i < n; ++i) {
+      f((size_t) 0, i);
+    }
+    return;
+  }
+
+  n_threads = std::min(n_threads, n);
+  std::atomic<size_t> next(0);
+  std::vector<std::exception_ptr> errors(n_threads);
+  auto run = [&](size_t t) {
+    try {
+      for (size_t i = next++; i < n; i = next++) {
+        f(t, i);
+      }
+    } catch (...) {
+      errors[t] = std::current_exception();
+      next = n;
+    }
+  };
+  std::vector<std::thread> threads;
+  for (size_t t = 1; t < n_threads; ++t) {
+    threads.emplace_back(run, t);
+  }
+  run(0);
+  for (std::thread& th : threads) {
+    th.join();
+  }
+  for (std::exception_ptr const& e : errors) {
+    if (e) std::rethrow_exception(e);
+  }
+}
+
+#endif  // PARALLEL_H
@@ -8,6 +8,8 @@
 #include <array>
 #include <cassert>
 
+#include "rand48.h"
+
 
 /******************************************************************************
                                   INTERFACES
@@ -50,7 +52,7 @@ class ProbDistIface {
     if (normalizing_constant < 0) {
       normalizing_constant = normalizingConstant();
     }
-    double r = drand48() * normalizing_constant;
+    double r = rand48Double() * normalizing_constant;
     for (auto const& it : *this) {
       r -= it.prob();
       if (r <= 0) return it.event();
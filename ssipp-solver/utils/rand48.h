@@ -0,0 +1,57 @@
+#ifndef RAND48_H
+#define RAND48_H
+
+#include <stdint.h>
+#include <stdlib.h>
+
+/*
+ * Source of the random numbers used to sample outcomes and break ties (e.g.,
+ * probabilisticEffectList_t::affect, ProbDist::sample and rand0to1_d in
+ * utils.h). By default the global drand48 state is used, i.e., the one seeded
+ * by srand48 in the solvers. A thread can install its own erand48 state using
+ * ThreadRand48Seed, so that concurrent threads (e.g., the workers of
+ * ParallelLocalSimulator) draw reproducible sequences that do not depend on
+ * how the threads are scheduled.
+ */
+inline unsigned short*& threadRand48State() {
+  static thread_local unsigned short* state = nullptr;
+  return state;
+}
+
+// Uniform in [0, 1)
+inline double rand48Double() {
+  unsigned short* state = threadRand48State();
+  return (state ? erand48(state) : drand48());
+}
+
+// Uniform in [0, 2^31)
+inline long rand48Long() {
+  unsigned short* state = threadRand48State();
+  return (state ? nrand48(state) : lrand48());
+}
+
+/*
+ * While an object of this class is alive, the random numbers of the thread
+ * that created it come from an erand48 state initialized with seed. The
+ * previous state is restored by the destructor.
+ */
+class ThreadRand48Seed {
+ public:
+  explicit ThreadRand48Seed(uint64_t seed) : previous_(threadRand48State()) {
+    // Same initialization as seed48 on the low 48 bits of seed
+    state_[0] = (unsigned short) (seed & 0xffff);
+    state_[1] = (unsigned short) ((seed >> 16) & 0xffff);
+    state_[2] = (unsigned short) ((seed >> 32) & 0xffff);
+    threadRand48State() = state_;
+  }
+  ~ThreadRand48Seed() { threadRand48State() = previous_; }
+
+  ThreadRand48Seed(ThreadRand48Seed const&) = delete;
+  ThreadRand48Seed& operator=(ThreadRand48Seed const&) = delete;
+
+ private:
+  unsigned short state_[3];
+  unsigned short* previous_;
+};
+
+#endif  // RAND48_H
@@ -19,6 +19,7 @@
 #include <functional>
 
 #include "die.h"
+#include "rand48.h"
 #include "../ext/mgpt/global.h"
 
 
@@ -179,6 +180,20 @@ inline uint64_t get_cpu_and_sys_time_usec() {
 }
 
 
+// CPU+System time of the calling thread only
+inline uint64_t get_thread_cpu_and_sys_time_usec() {
+#if defined(RUSAGE_THREAD)
+  struct rusage rusage;
+  int rt = getrusage(RUSAGE_THREAD, &rusage);
+  DIE(rt != -1, "getrusage(RUSAGE_THREAD) returned -1", -1);
+  return 1000000 * (rusage.ru_utime.tv_sec + rusage.ru_stime.tv_sec)
+           + rusage.ru_utime.tv_usec + rusage.ru_stime.tv_usec;
+#else
+  return get_cpu_and_sys_time_usec();
+#endif
+}
+
+
 
 inline size_t get_secs_since_epoch() {
   time_t seconds;
@@ -216,12 +231,12 @@ inline uint64_t get_max_resident_mem_in_kb() {
 
 
 
-inline float  rand0to1_f()         { return (float) drand48(); }
-inline double rand0to1_d()         { return drand48(); }
-inline double rand0toN_d(double n) { return drand48() * n; }
-inline size_t rand0toN_l(size_t n) { return lrand48() % n; }
+inline float  rand0to1_f()         { return (float) rand48Double(); }
+inline double rand0to1_d()         { return rand48Double(); }
+inline double rand0toN_d(double n) { return rand48Double() * n; }
+inline size_t rand0toN_l(size_t n) { return rand48Long() % n; }
 inline size_t randInIntervalInclusive_l(size_t min, size_t max) {
-  return (lrand48() % (max-min+1)) + min;
+  return (rand48Long() % (max-min+1)) + min;
 }
 
 std::deque<std::string> splitString(std::string const& s,